@@ -0,0 +1,63 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+/**
+ * Run the fn(thread_index, record_index) function records_count times on every of threads_count threads
+ * and print the average time per record.
+ * @param name - name of the benchmark case
+ * @param threads_count - count of the logging threads
+ * @param records_count - count of the records per thread
+ * @param fn - benchmarked function
+ * @param finish - function that is called after the threads are joined (eg flush)
+ */
+template<typename Fn, typename FinishFn>
+void Run(const std::string &name, int threads_count, int records_count, Fn &&fn, FinishFn &&finish) {
+    using Clock = std::chrono::steady_clock;
+
+    const auto start = Clock::now();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; ++t) {
+        threads.emplace_back([&fn, t, records_count] {
+            for (int i = 0; i < records_count; ++i) {
+                fn(t, i);
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    finish();
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    const double total = static_cast<double>(threads_count) * records_count;
+    std::printf("%-48s threads: %2d  %10.1f ns/record  %12.0f records/s\n",
+                name.c_str(),
+                threads_count,
+                static_cast<double>(elapsed.count()) / total,
+                total * 1e9 / static_cast<double>(elapsed.count()));
+}
+
+template<typename Fn>
+void Run(const std::string &name, int threads_count, int records_count, Fn &&fn) {
+    Run(name, threads_count, records_count, std::forward<Fn>(fn), [] {});
+}
+
+} // end of bench
@@ -0,0 +1,103 @@
+#include <fstream>
+#include <optional>
+#include <string>
+#include <cis1_core_logger/core_record.h>
+#include <scl/logger.h>
+
+#include "bench.h"
+
+using CoreRecord = cis1::core_logger::CoreRecord;
+using Level = scl::Level;
+
+const int records_count = 400000;
+
+/**
+ * Record that owns its fields by the std::string members (the record layout before the pooled storage).
+ */
+struct StringRecord {
+    StringRecord(Level level_,
+                 std::string time_str_,
+                 const std::optional<std::string_view> &session_id_,
+                 const std::optional<std::string_view> &action_,
+                 std::string_view message_,
+                 scl::ProcessId parent_pid_,
+                 scl::ProcessId pid_)
+        : level(level_),
+          time_str(std::move(time_str_)),
+          session_id(session_id_),
+          action(action_),
+          message(message_),
+          parent_pid(parent_pid_),
+          pid(pid_) {
+    }
+
+    Level level;
+    std::string time_str;
+    std::optional<std::string> session_id;
+    std::optional<std::string> action;
+    std::string message;
+    scl::ProcessId parent_pid;
+    scl::ProcessId pid;
+};
+
+/**
+ * Recorder that does nothing, so only the record construction, queueing and destruction are measured.
+ */
+template<typename RecordT>
+struct NullRecorder {
+    void OnRecord(const RecordT &record) {
+        m_sum += record.message.size();
+    }
+
+    std::size_t m_sum = 0;
+};
+
+/**
+ * @return - resident set size of the process in KiB or 0 if it is unknown
+ */
+std::size_t ResidentSize() {
+    std::size_t pages = 0;
+    std::size_t resident = 0;
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> resident;
+#endif
+    return resident * 4;
+}
+
+template<typename RecordT, typename QueueT>
+void BenchRecords(const std::string &name, int threads_count) {
+    using Recorder = NullRecorder<RecordT>;
+    using Recorders = scl::StaticRecorders<Recorder>;
+    using Pipeline = scl::Logger<RecordT, scl::threading::Async<QueueT>, Recorders>;
+
+    auto result = Pipeline::Init(scl::LoggerOptions{Level::Debug}, Recorders(std::make_unique<Recorder>()));
+    auto logger = std::get<typename Pipeline::Ptr>(std::move(result));
+
+    const std::optional<std::string_view> session_id = "session-identifier-0123456789";
+    const std::string message = "benchmark message that is long enough to exceed the small string buffer";
+
+    const auto rss_before = ResidentSize();
+    bench::Run(name, threads_count, records_count / threads_count,
+               [&logger, &session_id, &message](int, int) {
+                   logger->Record(Level::Info, session_id, std::nullopt, message, 1, 2);
+               },
+               [&logger] { logger->Flush(); });
+
+    std::printf("%-48s rss: %zu KiB -> %zu KiB\n", "", rss_before, ResidentSize());
+}
+
+int main() {
+    for (int threads_count : {1, 2, 4, 8}) {
+        BenchRecords<StringRecord, scl::queueing::Bounded<4096>>("std::string record, Async<Bounded<4096>>",
+                                                                 threads_count);
+        BenchRecords<CoreRecord, scl::queueing::Bounded<4096>>("pooled CoreRecord, Async<Bounded<4096>>",
+                                                               threads_count);
+        BenchRecords<StringRecord, scl::queueing::LockFree<4096>>("std::string record, Async<LockFree<4096>>",
+                                                                  threads_count);
+        BenchRecords<CoreRecord, scl::queueing::LockFree<4096>>("pooled CoreRecord, Async<LockFree<4096>>",
+                                                                threads_count);
+    }
+
+    return 0;
+}
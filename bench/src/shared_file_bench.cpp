@@ -0,0 +1,83 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+#include <cis1_core_logger/core_record.h>
+#include <scl/file_recorder.h>
+
+#ifdef SCL_HAS_SHARED_FILE
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using CoreRecord = cis1::core_logger::CoreRecord;
+using Level = scl::Level;
+
+namespace fs = std::filesystem;
+
+const int records_count = 400000;
+
+#ifdef SCL_HAS_SHARED_FILE
+
+/**
+ * Write records_count records to the shared file by processes_count processes
+ * and print the average time per record.
+ */
+void BenchProcesses(const fs::path &dir, int processes_count) {
+    using Clock = std::chrono::steady_clock;
+
+    scl::FileRecorder<CoreRecord>::Options options;
+    options.log_directory = dir;
+    options.file_name_template = "shared_file_bench." + std::to_string(processes_count) + ".%n.txt";
+    options.size_limit = 16 * 1024 * 1024;
+    options.multi_process = true;
+
+    const auto start = Clock::now();
+
+    std::vector<pid_t> children;
+    for (int p = 0; p < processes_count; ++p) {
+        const pid_t child = fork();
+        if (child == 0) {
+            auto result = scl::FileRecorder<CoreRecord>::Init(options);
+            auto recorder = std::get<scl::FileRecorderPtr<CoreRecord>>(std::move(result));
+
+            const CoreRecord record(Level::Info, scl::CurTimeStr(), std::nullopt, std::nullopt,
+                                    "benchmark message", 1, getpid());
+            for (int i = 0; i < records_count / processes_count; ++i) {
+                recorder->OnRecord(record);
+            }
+
+            _exit(0);
+        }
+
+        children.push_back(child);
+    }
+
+    for (const auto child : children) {
+        waitpid(child, nullptr, 0);
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    std::printf("%-48s processes: %2d  %10.1f ns/record  %12.0f records/s\n",
+                "FileRecorder multi_process",
+                processes_count,
+                static_cast<double>(elapsed.count()) / records_count,
+                records_count * 1e9 / static_cast<double>(elapsed.count()));
+}
+
+#endif
+
+int main() {
+#ifdef SCL_HAS_SHARED_FILE
+    const auto dir = fs::temp_directory_path() / "scl_shared_file_bench";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    for (int processes_count : {1, 2, 4, 8}) {
+        BenchProcesses(dir, processes_count);
+    }
+
+    fs::remove_all(dir);
+#endif
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <filesystem>
+#include <cis1_core_logger/core_record.h>
+#include <scl/file_recorder.h>
+#include <scl/logger.h>
+#include <scl/sync.h>
+
+#include "bench.h"
+
+using CoreRecord = cis1::core_logger::CoreRecord;
+using Level = scl::Level;
+
+namespace fs = std::filesystem;
+
+const int records_count = 200000;
+
+/**
+ * Recorder that does nothing, so only the synchronization cost is measured.
+ */
+struct NullRecorder {
+    void OnRecord(const CoreRecord &record) {
+        m_sum += record.message.size();
+    }
+
+    std::size_t m_sum = 0;
+};
+
+CoreRecord MakeRecord(int i) {
+    return CoreRecord(Level::Info, scl::CurTimeStr(), std::nullopt, std::nullopt,
+                      "benchmark message " + std::to_string(i), 1, 2);
+}
+
+template<typename SyncT>
+void BenchFileRecorder(const std::string &name, const fs::path &dir, int threads_count) {
+    typename scl::FileRecorder<CoreRecord, SyncT>::Options options;
+    options.log_directory = dir;
+    options.file_name_template = "sync_bench." + name + ".%n.txt";
+    options.size_limit = 64 * 1024 * 1024;
+
+    auto result = scl::FileRecorder<CoreRecord, SyncT>::Init(options);
+    auto recorder = std::get<scl::FileRecorderPtr<CoreRecord, SyncT>>(std::move(result));
+
+    const auto record = MakeRecord(0);
+    bench::Run("FileRecorder<" + name + ">", threads_count, records_count / threads_count,
+               [&recorder, &record](int, int) { recorder->OnRecord(record); });
+}
+
+template<typename ThreadingT>
+void BenchLogger(const std::string &name, int threads_count) {
+    using Recorders = scl::StaticRecorders<NullRecorder>;
+    using Pipeline = scl::Logger<CoreRecord, ThreadingT, Recorders>;
+
+    auto result = Pipeline::Init(scl::LoggerOptions{Level::Debug}, Recorders(std::make_unique<NullRecorder>()));
+    auto logger = std::get<typename Pipeline::Ptr>(std::move(result));
+
+    const std::optional<std::string> no_value;
+    const std::string message = "benchmark message";
+    bench::Run("Logger<" + name + ">", threads_count, records_count / threads_count,
+               [&logger, &no_value, &message](int, int) {
+                   logger->Record(Level::Info, no_value, no_value, message, 1, 2);
+               },
+               [&logger] { logger->Flush(); });
+}
+
+int main() {
+    const auto dir = fs::temp_directory_path() / "scl_sync_bench";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    BenchFileRecorder<scl::sync::None>("None", dir, 1);
+    for (int threads_count : {1, 4}) {
+        BenchFileRecorder<scl::sync::Mutex>("Mutex", dir, threads_count);
+        BenchFileRecorder<scl::sync::SpinLock>("SpinLock", dir, threads_count);
+    }
+
+    BenchLogger<scl::threading::Sync>("Sync", 1);
+    for (int threads_count : {1, 4}) {
+        BenchLogger<scl::threading::Locked<scl::sync::Mutex>>("Locked<Mutex>", threads_count);
+        BenchLogger<scl::threading::Locked<scl::sync::SpinLock>>("Locked<SpinLock>", threads_count);
+        BenchLogger<scl::threading::Async<scl::queueing::Unbounded>>("Async<Unbounded>", threads_count);
+        BenchLogger<scl::threading::Async<scl::queueing::Bounded<4096>>>("Async<Bounded<4096>>", threads_count);
+        BenchLogger<scl::threading::Async<scl::queueing::LockFree<4096>>>("Async<LockFree<4096>>", threads_count);
+    }
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <cis1_core_logger/core_record.h>
+#include <scl/text_log_reader.h>
+
+using CoreRecord = cis1::core_logger::CoreRecord;
+using Level = scl::Level;
+using TextLogReader = scl::TextLogReader;
+
+const int records_count = 2000000;
+
+/**
+ * Scan the file several times and print the throughput of the best run.
+ */
+template<typename Fn>
+void BenchScan(const std::string &name, const TextLogReader &reader, const TextLogReader::Filter &filter, Fn &&fn) {
+    using Clock = std::chrono::steady_clock;
+
+    double best_seconds = 0;
+    TextLogReader::ScanStats stats;
+    for (int run = 0; run < 5; ++run) {
+        const auto start = Clock::now();
+        stats = reader.Scan(filter, fn);
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        if (run == 0 || elapsed.count() < best_seconds) {
+            best_seconds = elapsed.count();
+        }
+    }
+
+    const auto size = static_cast<double>(reader.Data().size());
+    std::printf("%-48s %8.2f GB/s  %12.0f lines/s  matched: %zu\n",
+                name.c_str(),
+                size / best_seconds / 1e9,
+                static_cast<double>(stats.lines_count) / best_seconds,
+                stats.matched_count);
+}
+
+int main() {
+    const auto path = std::filesystem::temp_directory_path() / "text_reader_bench.log";
+    const auto base_time = *scl::TimeStrToSeconds("2020-01-02-03-00-00");
+    {
+        std::ofstream file(path, std::ios::trunc);
+        for (int i = 0; i < records_count; ++i) {
+            const CoreRecord record(Level::Info, scl::SecondsToTimeStr(base_time + i / 1000),
+                                    std::string("2020-01-02-03-04-05-100_") + std::to_string(i % 64),
+                                    std::string("startjob_stdout"),
+                                    "benchmark message " + std::to_string(i), 1, 1000 + i % 16);
+            file << (i % 2 == 0 ? record.ToString() : record.ToAlignedString()) << '\n';
+        }
+    }
+
+    auto result = TextLogReader::Init(path);
+    if (const auto *error = std::get_if<TextLogReader::InitError>(&result)) {
+        std::fprintf(stderr, "couldn't init the reader: %s\n", TextLogReader::ToStr(*error).c_str());
+        return 1;
+    }
+
+    const auto reader = std::get<scl::TextLogReaderPtr>(std::move(result));
+
+    std::size_t sum = 0;
+    const auto count_fn = [&sum](const scl::TextRecordView &record) { sum += record.FieldsCount(); };
+
+    BenchScan("all records", *reader, {}, count_fn);
+
+    TextLogReader::Filter filter;
+    filter.min_time = base_time + 500;
+    filter.max_time = base_time + 1000;
+    BenchScan("time range", *reader, filter, count_fn);
+
+    filter = {};
+    filter.pid = 1007;
+    BenchScan("pid", *reader, filter, count_fn);
+
+    filter = {};
+    filter.substring = "2020-01-02-03-04-05-100_42";
+    BenchScan("substring", *reader, filter, count_fn);
+
+    std::printf("%-48s fields: %zu\n", "", sum);
+    std::filesystem::remove(path);
+    return 0;
+}
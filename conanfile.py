@@ -51,6 +51,8 @@ class ScLogger(ConanFile):
 
     def package_info(self):
         self.cpp_info.libs = ["sc_logger"]
+        if self.settings.os == "Linux":
+            self.cpp_info.system_libs = ["rt"]
 
     def imports(self):
         self.copy("FindFilesystem.cmake", dst="cmake/modules", src="cmake/modules")
@@ -0,0 +1,185 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <cis1_core_logger/core_context.h>
+#include <cis1_core_logger/core_record.h>
+#include <scl/levels.h>
+#include <scl/logger.h>
+#include <scf/detail/type_matching.h>
+
+namespace cis1::core_logger {
+
+/**
+ * Lightweight logger handle.
+ * The handle shares the recorders and queues of the logger that created it
+ * and carries its own constant record fields (session id, pid and parent pid)
+ * rendered once on the handle creation.
+ * The handle is copyable, its creation doesn't allocate memory,
+ * and it may be used on any thread if the logger threading policy allows that.
+ * Note the handle must not outlive the logger that created it.
+ * @tparam Policies - scl::Logger policies of the logger
+ */
+template<typename ...Policies>
+class BasicChildLogger {
+public:
+    using Pipeline = scl::Logger<CoreRecord, Policies...>;
+
+    /**
+     * Ctor.
+     * @param pipeline - pipeline of the logger
+     * @param context - constant record fields
+     */
+    BasicChildLogger(Pipeline &pipeline, const CoreContext &context)
+        : m_pipeline(&pipeline),
+          m_context(context) {
+    }
+
+    /**
+     * Create a child logger with the specified session id.
+     * The pid and parent pid are inherited.
+     * @param session_id - optional session id of the child logger
+     * @return - child logger
+     */
+    [[nodiscard]]
+    BasicChildLogger Child(std::optional<std::string_view> session_id) const {
+        return Child(session_id, m_context.Pid(), m_context.ParentPid());
+    }
+
+    /**
+     * Create a child logger with the specified session id, pid and parent pid.
+     * @param session_id - optional session id of the child logger
+     * @param pid - process id of the child logger
+     * @param parent_pid - parent process id of the child logger
+     * @return - child logger
+     */
+    [[nodiscard]]
+    BasicChildLogger Child(std::optional<std::string_view> session_id,
+                           scl::ProcessId pid,
+                           scl::ProcessId parent_pid) const {
+        return BasicChildLogger(*m_pipeline, CoreContext(pid, parent_pid, session_id));
+    }
+
+    /**
+     * @return - constant record fields of the logger
+     */
+    [[nodiscard]]
+    inline const CoreContext &Context() const {
+        return m_context;
+    }
+
+    /**
+     * Record a message. Optional session id and action will not be put into a result log record.
+     * @param level - level of the record
+     *                (if the value greater than an options.level, then the message will be skipped)
+     * @param message - record message
+     */
+    void Record(scl::Level level, std::string_view message) const {
+        if (m_pipeline->IsEnabled(level)) {
+            RecordImpl(level, std::nullopt, std::nullopt, message);
+        }
+    }
+
+    /**
+     * Record a message with the specified session id. Optional action will not be put into a result log record.
+     * @param level - level of the record
+     *                (if the value greater than an options.level, then the message will be skipped)
+     * @param message - record message
+     */
+    void SesRecord(scl::Level level, std::string_view message) const {
+        if (m_pipeline->IsEnabled(level)) {
+            RecordImpl(level, m_context.SessionId(), std::nullopt, message);
+        }
+    }
+
+    /**
+     * Record a message with the specified action. Optional session id will not be put into a result log record.
+     * @tparam ActT - type of action
+     * @param level - level of the record
+     *                (if the value greater than an options.level, then the message will be skipped)
+     * @param action - action
+     * @param message - record message
+     */
+    template<typename ActT>
+    inline void ActRecord(scl::Level level,
+                          const ActT &action,
+                          std::string_view message) const {
+        if (m_pipeline->IsEnabled(level)) {
+            RecordImpl(level, std::nullopt, ActionAsString(action), message);
+        }
+    }
+
+    /**
+    * Record a message with the specified session id and action.
+    * @tparam ActT - type of action (must be string or there must be a ToString(ActT) function for the action)
+    * @param level - level of the record
+    *                (if the value greater than an options.level, then the message will be skipped)
+    * @param action - action
+    * @param message - record message
+    */
+    template<typename ActT>
+    inline void SesActRecord(scl::Level level,
+                             const ActT &action,
+                             std::string_view message) const {
+        if (m_pipeline->IsEnabled(level)) {
+            RecordImpl(level, m_context.SessionId(), ActionAsString(action), message);
+        }
+    }
+
+private:
+    /**
+     * Convert an action to the string
+     * @tparam ActT - type of action (must be string or there must be a ToString(ActT) function for the action)
+     * @param action - action
+     * @return - action as string
+     */
+    template<typename ActT>
+    static std::string ActionAsString(const ActT &action) {
+        constexpr bool is_there_to_string = scf::detail::IsThereToStringFor<ActT>::value;
+        constexpr bool is_string = scf::detail::IsString(action);
+        static_assert(is_there_to_string || is_string,
+                      "there must be a ToString() function for the action");
+
+        if constexpr (is_there_to_string) {
+            return ToString(action);
+        } else {
+            return action;
+        }
+    }
+
+    /**
+     * Message record implementation: record a message with the optional session id and action.
+     * @param level - level of the record
+     * @param session_id - session id
+     * @param action - action
+     * @param message - record message
+     */
+    void RecordImpl(scl::Level level,
+                    std::optional<std::string_view> session_id,
+                    std::optional<std::string_view> action,
+                    std::string_view message) const {
+        m_pipeline->Record(level, session_id, action, message, m_context.Prefix());
+    }
+
+    /**
+     * Pipeline that filters, timestamps and delivers records to the recorders.
+     */
+    Pipeline *m_pipeline;
+
+    /**
+     * Constant record fields.
+     */
+    CoreContext m_context;
+};
+
+} // end of cis1::core_logger
@@ -0,0 +1,80 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <cis1_core_logger/core_record.h>
+#include <scl/process_id.h>
+
+namespace cis1::core_logger {
+
+/**
+ * Constant record fields of a logger or a child logger: pid, parent pid and optional session id.
+ * The fields are stored inline (without heap allocation) together with their pre-rendered segment.
+ * Note a session id longer than max_session_id_length characters is not cached by the segment:
+ * it is stored out of line as a whole (the copies of the context share it) and is written as a separate token.
+ */
+class CoreContext {
+public:
+    /**
+     * Ctor.
+     * @param pid - process id
+     * @param parent_pid - parent process id
+     * @param session_id - optional session id
+     */
+    CoreContext(scl::ProcessId pid,
+                scl::ProcessId parent_pid,
+                std::optional<std::string_view> session_id)
+        : m_prefix(parent_pid, pid, session_id) {
+        if (session_id && session_id->size() > max_session_id_length) {
+            m_long_session_id = std::make_shared<const std::string>(*session_id);
+        }
+    }
+
+    [[nodiscard]]
+    inline scl::ProcessId Pid() const {
+        return m_prefix.Pid();
+    }
+
+    [[nodiscard]]
+    inline scl::ProcessId ParentPid() const {
+        return m_prefix.ParentPid();
+    }
+
+    [[nodiscard]]
+    inline std::optional<std::string_view> SessionId() const {
+        if (m_long_session_id) {
+            return std::string_view(*m_long_session_id);
+        }
+
+        return m_prefix.SessionId();
+    }
+
+    /**
+     * @return - pre-rendered segment of the records
+     */
+    [[nodiscard]]
+    inline const CorePrefix &Prefix() const {
+        return m_prefix;
+    }
+
+private:
+    CorePrefix m_prefix;
+
+    /**
+     * Session id that is not cached by the m_prefix or nullptr.
+     */
+    std::shared_ptr<const std::string> m_long_session_id;
+};
+
+} // end of cis1::core_logger
@@ -8,25 +8,68 @@
 
 #pragma once
 
-#include <mutex>
-#include <map>
-#include <set>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <variant>
 
+#include <cis1_core_logger/child_logger.h>
+#include <cis1_core_logger/core_context.h>
 #include <cis1_core_logger/core_record.h>
 #include <scl/levels.h>
+#include <scl/logger.h>
 #include <scl/recorder.h>
 #include <scl/process_id.h>
-#include <scf/detail/type_matching.h>
 
 namespace cis1::core_logger {
 
-class CoreLogger;
+/**
+ * Core logger options.
+ */
+struct CoreLoggerOptions {
+    /**
+     * Logging messages which are less severe than level will be ignored.
+     */
+    scl::Level level = scl::Level::Action;
+
+    /**
+     * Current process id
+     */
+    scl::ProcessId pid = 0;
+
+    /**
+     * Parent process id
+     */
+    scl::ProcessId parent_pid = 0;
+
+    /**
+     * Optional session id (an id longer than max_session_id_length characters is not cached, see CoreContext)
+     */
+    std::optional<std::string> session_id = std::nullopt;
+
+    /**
+     * Memory resource of the record allocations or nullptr to use the default ones
+     * (see scl::LoggerOptions::memory_resource).
+     */
+    std::pmr::memory_resource *memory_resource = nullptr;
+
+    /**
+     * Block size of the record sequence numbers or 0 to not number the records
+     * (see scl::LoggerOptions::sequence_block_size).
+     */
+    std::uint64_t sequence_block_size = 0;
+};
+
+template<typename ...Policies>
+class BasicCoreLogger;
 
 /**
  * Non-moving logger pointer alias.
  */
-using LoggerPtr = std::unique_ptr<CoreLogger>;
+template<typename ...Policies>
+using BasicLoggerPtr = std::unique_ptr<BasicCoreLogger<Policies...>>;
 
 /**
  * Logger implementation.
@@ -34,59 +77,42 @@ using LoggerPtr = std::unique_ptr<CoreLogger>;
  *  - hold options (like align, available level and parent pid);
  *  - get log messages and other corresponding parameters;
  *  - move structured record message (as RecordInfo) to a recorder.
+ * The logger is a typed facade over the scl::Logger<CoreRecord, Policies...> pipeline.
+ * Use the Child() method to create lightweight loggers with their own session id (eg per job).
+ * The message and other string arguments are taken by view (lvalue, rvalue or literal strings):
+ * the record refers to them on the synchronous delivery and copies them once if the record is queued.
+ * @tparam Policies - scl::Logger policies (eg scl::threading::Async<>)
  */
-class CoreLogger {
+template<typename ...Policies>
+class BasicCoreLogger {
 public:
     /**
      * Initialization error info.
      */
-    enum class InitError : int {
-        IncorrectLogLevel = 1,
-        NoRecorders,
-        UnallocatedRecorder,
-    };
+    using InitError = scl::LoggerInitError;
 
     /**
      * Initialization result: ether pointer to an initialized logger or an error info.
      */
-    using InitResult = std::variant<LoggerPtr, InitError>;
+    using InitResult = std::variant<BasicLoggerPtr<Policies...>, InitError>;
 
     /**
-     * Logger options.
+     * Recorder set: scl::RecordersCont<CoreRecord> by default or scl::StaticRecorders<...> policy.
      */
-    struct Options {
-        /**
-         * Logging messages which are less severe than level will be ignored.
-         */
-        scl::Level level = scl::Level::Action;
+    using Recorders = typename scl::Logger<CoreRecord, Policies...>::Recorders;
 
-        /**
-         * Current process id
-         */
-        scl::ProcessId pid = 0;
-
-        /**
-         * Parent process id
-         */
-        scl::ProcessId parent_pid = 0;
+    /**
+     * Logger options.
+     */
+    using Options = CoreLoggerOptions;
 
-        /**
-         * Optional session id
-         */
-        std::optional<std::string> session_id = std::nullopt;
-    };
+    /**
+     * Child logger handle.
+     */
+    using ChildLogger = BasicChildLogger<Policies...>;
 
     static std::string ToStr(InitError err) {
-        switch (err) {
-            case InitError::IncorrectLogLevel :
-                return "IncorrectLogLevel";
-            case InitError::NoRecorders :
-                return "NoRecorders";
-            case InitError::UnallocatedRecorder :
-                return "UnallocatedRecorder";
-            default:
-                return "Unknown";
-        }
+        return scl::ToStr(err);
     }
 
     /**
@@ -95,12 +121,46 @@ public:
      * @param recorders - recorders that will handle log records
      * @return - ether pointer to an initialized logger or an error info
      */
-    static InitResult Init(const Options &options, scl::RecordersCont<CoreRecord> &&recorders);
+    static InitResult Init(const Options &options, Recorders &&recorders) {
+        const scl::LoggerOptions pipeline_options{options.level, options.memory_resource, options.sequence_block_size};
+        auto result = Pipeline::Init(pipeline_options, std::move(recorders));
+        if (const auto *error = std::get_if<InitError>(&result)) {
+            return *error;
+        }
+
+        return BasicLoggerPtr<Policies...>(
+            new BasicCoreLogger(options, std::get<PipelinePtr>(std::move(result))));
+    }
 
     /**
      * Default dtor.
      */
-    ~CoreLogger() = default;
+    ~BasicCoreLogger() = default;
+
+    /**
+     * Create a child logger that shares the recorders of the logger.
+     * The pid and parent pid are inherited.
+     * @param session_id - optional session id of the child logger
+     * @return - child logger, must not outlive the logger
+     */
+    [[nodiscard]]
+    ChildLogger Child(std::optional<std::string_view> session_id) const {
+        return m_root.Child(session_id);
+    }
+
+    /**
+     * Create a child logger that shares the recorders of the logger.
+     * @param session_id - optional session id of the child logger
+     * @param pid - process id of the child logger
+     * @param parent_pid - parent process id of the child logger
+     * @return - child logger, must not outlive the logger
+     */
+    [[nodiscard]]
+    ChildLogger Child(std::optional<std::string_view> session_id,
+                      scl::ProcessId pid,
+                      scl::ProcessId parent_pid) const {
+        return m_root.Child(session_id, pid, parent_pid);
+    }
 
     /**
      * Record a message. Optional session id and action will not be put into a result log record.
@@ -108,7 +168,9 @@ public:
      *                (if the value greater than an options.level, then the message will be skipped)
      * @param message - record message
      */
-    void Record(scl::Level level, const std::string &message);
+    void Record(scl::Level level, std::string_view message) {
+        m_root.Record(level, message);
+    }
 
     /**
      * Record a message with the specified session id. Optional action will not be put into a result log record.
@@ -116,7 +178,9 @@ public:
      *                (if the value greater than an options.level, then the message will be skipped)
      * @param message - record message
      */
-    void SesRecord(scl::Level level, const std::string &message);
+    void SesRecord(scl::Level level, std::string_view message) {
+        m_root.SesRecord(level, message);
+    }
 
     /**
      * Record a message with the specified action. Optional session id will not be put into a result log record.
@@ -129,9 +193,8 @@ public:
     template<typename ActT>
     inline void ActRecord(scl::Level level,
                           const ActT &action,
-                          const std::string &message) {
-        const auto session_id = std::nullopt;
-        RecordImpl(level, session_id, ActionAsString(action), message);
+                          std::string_view message) {
+        m_root.ActRecord(level, action, message);
     }
 
     /**
@@ -139,66 +202,70 @@ public:
     * @tparam ActT - type of action (must be string or there must be a ToString(ActT) function for the action)
     * @param level - level of the record
     *                (if the value greater than an options.level, then the message will be skipped)
-    * @param session_id - session id
     * @param action - action
     * @param message - record message
     */
     template<typename ActT>
     inline void SesActRecord(scl::Level level,
                              const ActT &action,
-                             const std::string &message) {
-        RecordImpl(level, m_options.session_id, ActionAsString(action), message);
+                             std::string_view message) {
+        m_root.SesActRecord(level, action, message);
     }
 
-private:
     /**
-     * Convert an action to the string
-     * @tparam ActT - type of action (must be string or there must be a ToString(ActT) function for the action)
-     * @param action - action
-     * @return - action as string
+     * Wait until all the records are handled by the recorders
+     * (makes sense if the logger is asynchronous).
      */
-    template<typename ActT>
-    static std::string ActionAsString(const ActT &action) {
-        constexpr bool is_there_to_string = scf::detail::IsThereToStringFor<ActT>::value;
-        constexpr bool is_string = scf::detail::IsString(action);
-        static_assert(is_there_to_string || is_string,
-                      "there must be a ToString() function for the action");
-
-        if constexpr (is_there_to_string) {
-            return ToString(action);
-        } else {
-            return action;
-        }
+    void Flush() {
+        m_pipeline->Flush();
     }
 
+private:
+    using Pipeline = scl::Logger<CoreRecord, Policies...>;
+
+    using PipelinePtr = typename Pipeline::Ptr;
+
     /**
      * Private constructor.
      * @param options - logger options.
-     * @param recorder - recorder that will handle log records
+     * @param pipeline - initialized logger pipeline
      */
-    explicit CoreLogger(const Options &options, scl::RecordersCont<CoreRecord> &&recorder);
+    explicit BasicCoreLogger(const Options &options, PipelinePtr &&pipeline)
+        : m_pipeline(std::move(pipeline)),
+          m_root(*m_pipeline, MakeContext(options)) {
+    }
 
     /**
-     * Message record implementation: record a message with the optional session id and action.
-     * @param level - level of the record
-     *                (if the value greater than an options.level, then the message will be skipped)
-     * @param action - action
-     * @param message - record message
+     * Make the logger context from the options.
+     * @param options - logger options
+     * @return - constant record fields of the logger
      */
-    void RecordImpl(scl::Level level,
-                    const std::optional<std::string> &session_id,
-                    const std::optional<std::string> &action,
-                    const std::string &message);
+    static CoreContext MakeContext(const Options &options) {
+        return CoreContext(options.pid, options.parent_pid, options.session_id);
+    }
 
     /**
-     * Logger options.
+     * Pipeline that filters, timestamps and delivers records to the recorders.
      */
-    Options m_options;
+    PipelinePtr m_pipeline;
 
     /**
-     * Recorder that processes log records (eg FileRecorder, ConsoleRecorder and other custom recorders)
+     * Handle that records with the logger options.
      */
-    scl::RecordersCont<CoreRecord> m_recorders;
+    ChildLogger m_root;
 };
 
+/**
+ * Default logger: recorders are called on the logging thread.
+ */
+using CoreLogger = BasicCoreLogger<>;
+
+/**
+ * Non-moving default logger pointer alias.
+ */
+using LoggerPtr = BasicLoggerPtr<>;
+
+// the default logger is instantiated within the library
+extern template class BasicCoreLogger<>;
+
 } // end of cis1::core_logger
@@ -8,10 +8,15 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <optional>
+#include <string_view>
 #include <scl/record.h>
 #include <scl/process_id.h>
 #include <scl/detail/format_defines.h>
+#include <scl/detail/record_format.h>
+#include <scl/detail/record_storage.h>
 
 namespace cis1::core_logger {
 
@@ -27,28 +32,217 @@ const std::size_t session_id_length
 // the longest action name is startjob_stdout
 const std::size_t action_length = 15;
 
+// max length of a session id that can be cached within a CorePrefix,
+// the cis1 session id (see session_id_length) fits in with a margin
+const std::size_t max_session_id_length = 64;
+
+/**
+ * MessagePack keys of the CoreRecord fields (see scl::RecordFormat::MessagePack).
+ * The absent session id, action and sequence number are omitted.
+ */
+enum class CoreRecordKey : std::uint8_t {
+    Time = static_cast<std::uint8_t>(scl::RecordKey::Time),
+    Level = static_cast<std::uint8_t>(scl::RecordKey::Level),
+    Message = static_cast<std::uint8_t>(scl::RecordKey::Message),
+    ParentPid,
+    Pid,
+    SessionId,
+    Action,
+    Sequence = static_cast<std::uint8_t>(scl::RecordKey::Sequence),
+};
+
+/**
+ * Pre-rendered constant segment of the records: parent pid, pid and optional session id
+ * in both the plain and aligned formats.
+ * The segment is rendered once (eg when a logger is initialized)
+ * and then is copied to the serialized records as is.
+ */
+class CorePrefix {
+public:
+    /**
+     * Render the segment.
+     * Note the session id is not cached if it is longer than max_session_id_length characters.
+     * @param parent_pid - parent process id
+     * @param pid - process id
+     * @param session_id - optional session id
+     */
+    explicit CorePrefix(scl::ProcessId parent_pid,
+                        scl::ProcessId pid,
+                        std::optional<std::string_view> session_id = std::nullopt);
+
+    [[nodiscard]]
+    inline scl::ProcessId ParentPid() const {
+        return m_parent_pid;
+    }
+
+    [[nodiscard]]
+    inline scl::ProcessId Pid() const {
+        return m_pid;
+    }
+
+    /**
+     * @return - cached session id or std::nullopt
+     */
+    [[nodiscard]]
+    std::optional<std::string_view> SessionId() const;
+
+    /**
+     * @return - true if the segment contains the session id
+     */
+    [[nodiscard]]
+    inline bool HasSessionId() const {
+        return m_plain_size != m_plain_pids_size;
+    }
+
+    /**
+     * @param with_session_id - true if the session id should be included (the HasSessionId() must be true)
+     * @return - plain segment: "ppid | pid | [session_id | ]"
+     */
+    [[nodiscard]]
+    inline std::string_view Plain(bool with_session_id) const {
+        return {m_plain.data(), with_session_id ? m_plain_size : m_plain_pids_size};
+    }
+
+    /**
+     * @param with_session_id - true if the session id should be included (the HasSessionId() must be true)
+     * @return - aligned segment
+     */
+    [[nodiscard]]
+    inline std::string_view Aligned(bool with_session_id) const {
+        return {m_aligned.data(), with_session_id ? m_aligned_size : m_aligned_pids_size};
+    }
+
+private:
+    static constexpr std::size_t pids_length_k
+        = 2 * scl::detail::PlainTokenSize(scl::detail::log_formatting::pid_length_k);
+
+    static constexpr std::size_t plain_capacity_k
+        = pids_length_k + scl::detail::PlainTokenSize(max_session_id_length);
+
+    static constexpr std::size_t aligned_capacity_k
+        = pids_length_k + scl::detail::AlignedTokenSize(session_id_length);
+
+    scl::ProcessId m_parent_pid = 0;
+    scl::ProcessId m_pid = 0;
+    std::array<char, plain_capacity_k> m_plain{};
+    std::array<char, aligned_capacity_k> m_aligned{};
+    std::uint8_t m_plain_pids_size = 0;
+    std::uint8_t m_plain_size = 0;
+    std::uint8_t m_aligned_pids_size = 0;
+    std::uint8_t m_aligned_size = 0;
+};
+
 /**
  * Log record info. The structure is set by logger and is handled by a recorder.
+ * The string fields are views: they refer either to the caller data (see scl::ViewTag)
+ * or to a single block owned by the record.
+ * A copy of the record always owns its data.
  */
 class CoreRecord : public scl::IRecord {
 public:
+    /**
+     * Construct a record that owns a copy of the fields.
+     */
+    explicit CoreRecord(scl::Level level_,
+                        std::string_view time_str_,
+                        std::optional<std::string_view> session_id_,
+                        std::optional<std::string_view> action_,
+                        std::string_view message_,
+                        scl::ProcessId parent_pid_,
+                        scl::ProcessId pid_);
+
+    /**
+     * Construct a record with the pre-rendered constant segment that owns a copy of the fields.
+     * Note the session_id_ must be either std::nullopt or the session id of the prefix_.
+     */
     explicit CoreRecord(scl::Level level_,
-                        const std::string &time_str_,
-                        const std::optional<std::string> &session_id_,
-                        const std::optional<std::string> &action_,
-                        const std::string &message_,
+                        std::string_view time_str_,
+                        std::optional<std::string_view> session_id_,
+                        std::optional<std::string_view> action_,
+                        std::string_view message_,
+                        const CorePrefix &prefix_);
+
+    /**
+     * Construct a record that refers to the fields without copying.
+     */
+    explicit CoreRecord(scl::ViewTag,
+                        scl::Level level_,
+                        std::string_view time_str_,
+                        std::optional<std::string_view> session_id_,
+                        std::optional<std::string_view> action_,
+                        std::string_view message_,
                         scl::ProcessId parent_pid_,
                         scl::ProcessId pid_);
 
+    /**
+     * Construct a record with the pre-rendered constant segment that refers to the fields without copying.
+     * Note the session_id_ must be either std::nullopt or the session id of the prefix_.
+     */
+    explicit CoreRecord(scl::ViewTag,
+                        scl::Level level_,
+                        std::string_view time_str_,
+                        std::optional<std::string_view> session_id_,
+                        std::optional<std::string_view> action_,
+                        std::string_view message_,
+                        const CorePrefix &prefix_);
+
+    /**
+     * Copy ctor. The copy owns its data even if the other record refers to the caller data.
+     */
+    CoreRecord(const CoreRecord &other);
+
+    CoreRecord(CoreRecord &&other) noexcept = default;
+
+    CoreRecord &operator=(const CoreRecord &other);
+
+    CoreRecord &operator=(CoreRecord &&other) noexcept = default;
+
+    /**
+     * Copy the referred fields to a block owned by the record.
+     * Does nothing if the record owns its data already.
+     */
+    void Detach();
+
+    /**
+     * @return - true if the record owns its data
+     */
+    [[nodiscard]]
+    inline bool IsDetached() const {
+        return static_cast<bool>(m_storage);
+    }
+
     scl::Level level = scl::Level::Action;
-    std::string time_str;
-    std::optional<std::string> session_id;
-    std::optional<std::string> action;
-    std::string message;
+    std::string_view time_str;
+    std::optional<std::string_view> session_id;
+    std::optional<std::string_view> action;
+    std::string_view message;
     scl::ProcessId parent_pid = 0;
     scl::ProcessId pid = 0;
 
+    /**
+     * Pre-rendered parent pid, pid and session id.
+     * Note the text formats use the prefix only while it matches the fields above,
+     * a record with the changed fields is rendered without the prefix.
+     */
+    CorePrefix prefix;
+
 protected:
+    void WriteString(std::string &dst) const final;
+
+    void WriteAlignedString(std::string &dst) const final;
+
+    /**
+     * @overload
+     * Note the absent session id, action and sequence number are omitted
+     */
+    void WriteJsonString(std::string &dst) const final;
+
+    /**
+     * @overload
+     * Note the absent session id, action and sequence number are omitted (see CoreRecordKey)
+     */
+    void WriteMsgPack(std::string &dst, scl::detail::MsgPackStrWriter &writer) const final;
+
     [[nodiscard]]
     AlignedTokenCont AsAlignedTokens() const final;
 
@@ -57,6 +251,19 @@ protected:
 
     [[nodiscard]]
     std::string Message() const final;
+
+private:
+    /**
+     * Get the prefix that matches the parent_pid, pid and session_id fields.
+     * @param rendered - storage of the prefix that is rendered again if the cached one is stale
+     * @return - either the cached prefix or the rendered one
+     */
+    const CorePrefix &ActualPrefix(std::optional<CorePrefix> &rendered) const;
+
+    /**
+     * Owned block of the string fields or nullptr if the record refers to the caller data.
+     */
+    scl::detail::PoolBlock m_storage;
 };
 
 } // end of cis1::core_logger
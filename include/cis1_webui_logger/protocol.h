@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <string>
+#include <string_view>
+
 namespace cis1::webui_logger {
 
 // the longest protocol name is "HTTP_POST"
@@ -19,7 +22,7 @@ enum class Protocol : unsigned short {
     WS,
 };
 
-inline std::string ProtocolToString(Protocol p) {
+inline std::string_view ProtocolToStringView(Protocol p) {
     switch (p) {
         case Protocol::HTTP_GET:    return "HTTP GET";
         case Protocol::HTTP_POST:   return "HTTP POST";
@@ -28,4 +31,8 @@ inline std::string ProtocolToString(Protocol p) {
     }
 }
 
+inline std::string ProtocolToString(Protocol p) {
+    return std::string(ProtocolToStringView(p));
+}
+
 } // end of cis1::webui_logger
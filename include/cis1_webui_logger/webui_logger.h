@@ -8,26 +8,51 @@
 
 #pragma once
 
-#include <mutex>
-#include <map>
-#include <set>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <variant>
 
 #include <cis1_webui_logger/protocol.h>
 #include <cis1_webui_logger/webui_record.h>
 #include <scl/levels.h>
+#include <scl/logger.h>
 #include <scl/recorder.h>
-#include <scl/process_id.h>
-#include <scf/detail/type_matching.h>
 
 namespace cis1::webui_logger {
 
-class WebuiLogger;
+/**
+ * Webui logger options.
+ */
+struct WebuiLoggerOptions {
+    /**
+     * Logging messages which are less severe than level will be ignored.
+     */
+    scl::Level level = scl::Level::Action;
+
+    /**
+     * Memory resource of the record allocations or nullptr to use the default ones
+     * (see scl::LoggerOptions::memory_resource).
+     */
+    std::pmr::memory_resource *memory_resource = nullptr;
+
+    /**
+     * Block size of the record sequence numbers or 0 to not number the records
+     * (see scl::LoggerOptions::sequence_block_size).
+     */
+    std::uint64_t sequence_block_size = 0;
+};
+
+template<typename ...Policies>
+class BasicWebuiLogger;
 
 /**
  * Non-moving logger pointer alias.
  */
-using LoggerPtr = std::unique_ptr<WebuiLogger>;
+template<typename ...Policies>
+using BasicLoggerPtr = std::unique_ptr<BasicWebuiLogger<Policies...>>;
 
 /**
  * Logger implementation.
@@ -35,44 +60,35 @@ using LoggerPtr = std::unique_ptr<WebuiLogger>;
  *  - hold options (like align, available level and parent pid);
  *  - get log messages and other corresponding parameters;
  *  - move structured record message (as RecordInfo) to a recorder.
+ * The logger is a typed facade over the scl::Logger<WebuiRecord, Policies...> pipeline.
+ * The string arguments are taken by view and are copied only if the record is queued.
+ * @tparam Policies - scl::Logger policies (eg scl::threading::Async<>)
  */
-class WebuiLogger {
+template<typename ...Policies>
+class BasicWebuiLogger {
 public:
     /**
      * Initialization error info.
      */
-    enum class InitError : int {
-        IncorrectLogLevel = 1,
-        NoRecorders,
-        UnallocatedRecorder,
-    };
+    using InitError = scl::LoggerInitError;
 
     /**
      * Initialization result: ether pointer to an initialized logger or an error info.
      */
-    using InitResult = std::variant<LoggerPtr, InitError>;
+    using InitResult = std::variant<BasicLoggerPtr<Policies...>, InitError>;
+
+    /**
+     * Recorder set: scl::RecordersCont<WebuiRecord> by default or scl::StaticRecorders<...> policy.
+     */
+    using Recorders = typename scl::Logger<WebuiRecord, Policies...>::Recorders;
 
     /**
      * Logger options.
      */
-    struct Options {
-        /**
-         * Logging messages which are less severe than level will be ignored.
-         */
-        scl::Level level = scl::Level::Action;
-    };
+    using Options = WebuiLoggerOptions;
 
     static std::string ToStr(InitError err) {
-        switch (err) {
-            case InitError::IncorrectLogLevel :
-                return "IncorrectLogLevel";
-            case InitError::NoRecorders :
-                return "NoRecorders";
-            case InitError::UnallocatedRecorder :
-                return "UnallocatedRecorder";
-            default:
-                return "Unknown";
-        }
+        return scl::ToStr(err);
     }
 
     /**
@@ -81,12 +97,21 @@ public:
      * @param recorders - recorders that will handle log records
      * @return - ether pointer to an initialized logger or an error info
      */
-    static InitResult Init(const Options &options, scl::RecordersCont<WebuiRecord> &&recorders);
+    static InitResult Init(const Options &options, Recorders &&recorders) {
+        const scl::LoggerOptions pipeline_options{options.level, options.memory_resource, options.sequence_block_size};
+        auto result = Pipeline::Init(pipeline_options, std::move(recorders));
+        if (const auto *error = std::get_if<InitError>(&result)) {
+            return *error;
+        }
+
+        return BasicLoggerPtr<Policies...>(
+            new BasicWebuiLogger(std::get<PipelinePtr>(std::move(result))));
+    }
 
     /**
      * Default dtor.
      */
-    ~WebuiLogger() = default;
+    ~BasicWebuiLogger() = default;
 
     /**
      * Record a message.
@@ -94,7 +119,9 @@ public:
      *                (if the value greater than an options.level, then the message will be skipped)
      * @param message - record message
      */
-    void Record(scl::Level level, const std::string &message);
+    void Record(scl::Level level, std::string_view message) {
+        m_pipeline->Record(level, message, std::nullopt, std::nullopt, std::nullopt, std::nullopt);
+    }
 
     /**
      * Record a message with user's info.
@@ -107,44 +134,52 @@ public:
      * @param message - record message
      */
     void ExRecord(scl::Level level,
-                    Protocol protocol,
-                    const std::string &handler,
-                    const std::string &remote_addr,
-                    const std::optional<std::string> &email,
-                    const std::string &message);
-
-private:
+                  Protocol protocol,
+                  std::string_view handler,
+                  std::string_view remote_addr,
+                  std::optional<std::string_view> email,
+                  std::string_view message) {
+        m_pipeline->Record(level, message, protocol, handler, remote_addr, email);
+    }
 
     /**
-     * Private constructor.
-     * @param options - logger options.
-     * @param recorder - recorder that will handle log records
+     * Wait until all the records are handled by the recorders
+     * (makes sense if the logger is asynchronous).
      */
-    explicit WebuiLogger(const Options &options, scl::RecordersCont<WebuiRecord> &&recorder);
+    void Flush() {
+        m_pipeline->Flush();
+    }
 
-    /**
-     * Message record implementation: record a message with the optional session id and action.
-     * @param level - level of the record
-     *                (if the value greater than an options.level, then the message will be skipped)
-     * @param action - action
-     * @param message - record message
-     */
-    void RecordImpl(scl::Level level,
-                    const std::optional<Protocol> &protocol,
-                    const std::optional<std::string> &handler,
-                    const std::optional<std::string> &remote_addr,
-                    const std::optional<std::string> &email,
-                    const std::string &message);
+private:
+    using Pipeline = scl::Logger<WebuiRecord, Policies...>;
+
+    using PipelinePtr = typename Pipeline::Ptr;
 
     /**
-     * Logger options.
+     * Private constructor.
+     * @param pipeline - initialized logger pipeline
      */
-    Options m_options;
+    explicit BasicWebuiLogger(PipelinePtr &&pipeline)
+        : m_pipeline(std::move(pipeline)) {
+    }
 
     /**
-     * Recorder that processes log records (eg FileRecorder, ConsoleRecorder and other custom recorders)
+     * Pipeline that filters, timestamps and delivers records to the recorders.
      */
-    scl::RecordersCont<WebuiRecord> m_recorders;
+    PipelinePtr m_pipeline;
 };
 
+/**
+ * Default logger: recorders are called on the logging thread.
+ */
+using WebuiLogger = BasicWebuiLogger<>;
+
+/**
+ * Non-moving default logger pointer alias.
+ */
+using LoggerPtr = BasicLoggerPtr<>;
+
+// the default logger is instantiated within the library
+extern template class BasicWebuiLogger<>;
+
 } // end of cis1::webui_logger
@@ -8,11 +8,15 @@
 
 #pragma once
 
+#include <cstdint>
 #include <optional>
+#include <string_view>
 #include <cis1_webui_logger/protocol.h>
 #include <scl/record.h>
 #include <scl/process_id.h>
 #include <scl/detail/format_defines.h>
+#include <scl/detail/record_format.h>
+#include <scl/detail/record_storage.h>
 
 namespace cis1::webui_logger {
 
@@ -22,28 +26,106 @@ const std::size_t handler_length = 28;
 // the longest IPv4 address name is 255.255.255.255:65535
 const std::size_t remote_addr_v4_length = 21;
 
+/**
+ * MessagePack keys of the WebuiRecord fields (see scl::RecordFormat::MessagePack).
+ * The protocol is written as its integer value, the absent fields are omitted.
+ */
+enum class WebuiRecordKey : std::uint8_t {
+    Time = static_cast<std::uint8_t>(scl::RecordKey::Time),
+    Level = static_cast<std::uint8_t>(scl::RecordKey::Level),
+    Message = static_cast<std::uint8_t>(scl::RecordKey::Message),
+    Protocol,
+    Handler,
+    RemoteAddr,
+    Email,
+    Sequence = static_cast<std::uint8_t>(scl::RecordKey::Sequence),
+};
+
 /**
  * Log record info. The structure is set by logger and is handled by a recorder.
+ * The string fields are views: they refer either to the caller data (see scl::ViewTag)
+ * or to a single block owned by the record.
+ * A copy of the record always owns its data.
  */
 class WebuiRecord : public scl::IRecord {
 public:
+    /**
+     * Construct a record that owns a copy of the fields.
+     */
     explicit WebuiRecord(scl::Level level_,
-                         const std::string &time_str_,
-                         const std::string &message_,
+                         std::string_view time_str_,
+                         std::string_view message_,
+                         const std::optional<Protocol> &protocol_,
+                         std::optional<std::string_view> handler_,
+                         std::optional<std::string_view> remote_addr_,
+                         std::optional<std::string_view> email_);
+
+    /**
+     * Construct a record that refers to the fields without copying.
+     */
+    explicit WebuiRecord(scl::ViewTag,
+                         scl::Level level_,
+                         std::string_view time_str_,
+                         std::string_view message_,
                          const std::optional<Protocol> &protocol_,
-                         const std::optional<std::string> &handler_,
-                         const std::optional<std::string> &remote_addr_,
-                         const std::optional<std::string> &email_);
+                         std::optional<std::string_view> handler_,
+                         std::optional<std::string_view> remote_addr_,
+                         std::optional<std::string_view> email_);
+
+    /**
+     * Copy ctor. The copy owns its data even if the other record refers to the caller data.
+     */
+    WebuiRecord(const WebuiRecord &other);
+
+    WebuiRecord(WebuiRecord &&other) noexcept = default;
+
+    WebuiRecord &operator=(const WebuiRecord &other);
+
+    WebuiRecord &operator=(WebuiRecord &&other) noexcept = default;
+
+    /**
+     * Copy the referred fields to a block owned by the record.
+     * Does nothing if the record owns its data already.
+     */
+    void Detach();
+
+    /**
+     * @return - true if the record owns its data
+     */
+    [[nodiscard]]
+    inline bool IsDetached() const {
+        return static_cast<bool>(m_storage);
+    }
 
     scl::Level level = scl::Level::Action;
-    std::string time_str;
-    std::string message;
+    std::string_view time_str;
+    std::string_view message;
     std::optional<Protocol> protocol;
-    std::optional<std::string> handler;
-    std::optional<std::string> remote_addr;
-    std::optional<std::string> email;
+    std::optional<std::string_view> handler;
+    std::optional<std::string_view> remote_addr;
+    std::optional<std::string_view> email;
 
 protected:
+    void WriteString(std::string &dst) const final;
+
+    /**
+     * @overload
+     * Note the email will not be alligned
+     */
+    void WriteAlignedString(std::string &dst) const final;
+
+    /**
+     * @overload
+     * Note the absent fields are omitted
+     */
+    void WriteJsonString(std::string &dst) const final;
+
+    /**
+     * @overload
+     * Note the absent fields are omitted (see WebuiRecordKey)
+     */
+    void WriteMsgPack(std::string &dst, scl::detail::MsgPackStrWriter &writer) const final;
+
     /**
      * @overload
      * Note the email will not be alligned
@@ -56,6 +138,12 @@ protected:
 
     [[nodiscard]]
     std::string Message() const final;
+
+private:
+    /**
+     * Owned block of the string fields or nullptr if the record refers to the caller data.
+     */
+    scl::detail::PoolBlock m_storage;
 };
 
 } // end of cis1::webui_logger
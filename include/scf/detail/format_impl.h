@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+
 #include <scf/detail/format_preprocessing.h>
 #include <scf/detail/format_processing.h>
 
@@ -25,14 +28,16 @@ const std::size_t start_preprocessing_index_k = 0;
 
 /**
 * The function is starting point for compile time format processing.
+* @tparam StringT - type of the result string (std::string or std::pmr::string)
 * @tparam StrHolder - type of the lambda function that contains the constexpr format string
 * @tparam Types - types of the input arguments
+* @param alloc - allocator of the result string
 * @param holder -lambda function that contains the constexpr format string
 * @param args - input arguments
 * @return - processed format
 */
-template<typename StrHolder, typename ...Types>
-inline std::string FormatImpl(StrHolder holder, Types &&... args) {
+template<typename StringT, typename StrHolder, typename ...Types>
+inline StringT FormatToImpl(const typename StringT::allocator_type &alloc, StrHolder holder, Types &&... args) {
     constexpr std::size_t len = strlen(holder());
 
     // get the indexes of the specifiers in format string
@@ -41,11 +46,24 @@ inline std::string FormatImpl(StrHolder holder, Types &&... args) {
 
     static_assert(Size(specifier_indexes) == sizeof...(Types), "unknown library error");
 
-    std::string result = holder();
+    StringT result(holder(), alloc);
     // put the arguments to the result string
     FormatProcessing(specifier_indexes, result, start_offset_k, args...);
     return result;
 }
 
+/**
+* The function is starting point for compile time format processing to std::string.
+* @tparam StrHolder - type of the lambda function that contains the constexpr format string
+* @tparam Types - types of the input arguments
+* @param holder -lambda function that contains the constexpr format string
+* @param args - input arguments
+* @return - processed format
+*/
+template<typename StrHolder, typename ...Types>
+inline std::string FormatImpl(StrHolder holder, Types &&... args) {
+    return FormatToImpl<std::string>(std::allocator<char>(), holder, std::forward<Types>(args)...);
+}
+
 } // end of scf::detail
 
@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <string_view>
+#include <type_traits>
+
 #include <scf/detail/to_string.h>
 #include <scf/detail/type_pack.h>
 
@@ -17,7 +20,8 @@ namespace scf::detail {
 * The function is end point of the format processing
 * (when the all arguments have put to the result string).
 */
-inline void FormatProcessing(TypePack<>, const std::string &, std::size_t) {
+template<typename StringT>
+inline void FormatProcessing(TypePack<>, const StringT &, std::size_t) {
 }
 
 /**
@@ -33,10 +37,10 @@ inline void FormatProcessing(TypePack<>, const std::string &, std::size_t) {
 * @param arg - current processing argument
 * @param args - remaining arguments
 */
-template<typename ...Indexes, typename T, typename ...Types>
+template<typename ...Indexes, typename StringT, typename T, typename ...Types>
 inline void FormatProcessing(
     TypePack<Indexes...> specifier_indexes,
-    std::string &result,
+    StringT &result,
     std::size_t offset,
     T &&arg,
     Types &&...args) {
@@ -47,12 +51,21 @@ inline void FormatProcessing(
 
     // erase 'specifier_size' characters from the source format starting from 'real_position'
     result.erase(real_position, specifiers::specifier_size);
-    const auto arg_as_string = ToString<specifier>(arg);
-    // put the argument as string to the result string starting from 'real_position'
-    result.insert(real_position, arg_as_string);
+    std::size_t arg_size = 0;
+    if constexpr (specifier == specifiers::string_spc_k && std::is_convertible_v<const T &, std::string_view>) {
+        // put the string argument without the intermediate copy
+        const std::string_view arg_as_string = arg;
+        result.insert(real_position, arg_as_string);
+        arg_size = arg_as_string.size();
+    } else {
+        const auto arg_as_string = ToString<specifier>(arg);
+        // put the argument as string to the result string starting from 'real_position'
+        result.insert(real_position, arg_as_string);
+        arg_size = arg_as_string.size();
+    }
 
     // calculate the index offset
-    offset += arg_as_string.size() - specifiers::specifier_size;
+    offset += arg_size - specifiers::specifier_size;
     // continue inserting
     FormatProcessing(PopFront(specifier_indexes), result, offset, args...);
 }
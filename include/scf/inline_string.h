@@ -0,0 +1,243 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace scf {
+
+/**
+ * String with N bytes of the inline (stack) storage and the heap fallback.
+ * The string is the result type of SCFormatN, so short messages are formatted without allocation.
+ * The string is implicitly convertible to std::string_view,
+ * so it is accepted by the logger methods without the conversion to std::string.
+ * @tparam N - inline capacity (without the null terminator)
+ */
+template<std::size_t N>
+class InlineString {
+public:
+    using allocator_type = std::allocator<char>;
+    using size_type = std::size_t;
+
+    static constexpr size_type npos = std::string_view::npos;
+
+    InlineString() noexcept {
+        m_inline[0] = '\0';
+    }
+
+    InlineString(std::string_view str, const allocator_type & = {}) {
+        m_inline[0] = '\0';
+        append(str);
+    }
+
+    InlineString(const char *str, const allocator_type &alloc = {})
+        : InlineString(std::string_view(str), alloc) {
+    }
+
+    InlineString(const InlineString &other)
+        : InlineString(other.view()) {
+    }
+
+    InlineString(InlineString &&other) noexcept {
+        MoveFrom(other);
+    }
+
+    InlineString &operator=(const InlineString &other) {
+        if (this != &other) {
+            clear();
+            append(other.view());
+        }
+
+        return *this;
+    }
+
+    InlineString &operator=(InlineString &&other) noexcept {
+        if (this != &other) {
+            m_heap.reset();
+            MoveFrom(other);
+        }
+
+        return *this;
+    }
+
+    ~InlineString() = default;
+
+    [[nodiscard]]
+    inline const char *data() const noexcept {
+        return m_data;
+    }
+
+    [[nodiscard]]
+    inline const char *c_str() const noexcept {
+        return m_data;
+    }
+
+    [[nodiscard]]
+    inline size_type size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]]
+    inline size_type length() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]]
+    inline bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    [[nodiscard]]
+    inline size_type capacity() const noexcept {
+        return m_capacity;
+    }
+
+    /**
+     * @return - true if the string is stored in the inline storage
+     */
+    [[nodiscard]]
+    inline bool is_inline() const noexcept {
+        return m_data == m_inline;
+    }
+
+    [[nodiscard]]
+    inline std::string_view view() const noexcept {
+        return {m_data, m_size};
+    }
+
+    inline operator std::string_view() const noexcept {
+        return view();
+    }
+
+    explicit operator std::string() const {
+        return std::string(view());
+    }
+
+    inline void clear() noexcept {
+        m_size = 0;
+        m_data[0] = '\0';
+    }
+
+    /**
+     * Reserve the storage, the string is moved to the heap if the new_capacity exceeds the current capacity.
+     * @param new_capacity - required capacity
+     */
+    void reserve(size_type new_capacity) {
+        if (new_capacity <= m_capacity) {
+            return;
+        }
+
+        std::unique_ptr<char[]> heap(new char[new_capacity + 1]);
+        std::memcpy(heap.get(), m_data, m_size + 1);
+        m_heap = std::move(heap);
+        m_data = m_heap.get();
+        m_capacity = new_capacity;
+    }
+
+    InlineString &append(std::string_view str) {
+        return insert(m_size, str);
+    }
+
+    InlineString &operator+=(std::string_view str) {
+        return append(str);
+    }
+
+    InlineString &operator+=(char ch) {
+        return append(std::string_view(&ch, 1));
+    }
+
+    /**
+     * Insert the str before the pos character.
+     * @param pos - insertion position, must not exceed size()
+     * @param str - inserted string
+     * @return - *this
+     */
+    InlineString &insert(size_type pos, std::string_view str) {
+        const bool is_aliased = str.data() >= m_data && str.data() <= m_data + m_size;
+        if (is_aliased) {
+            // the str refers to this string, so it must be copied before the data is moved
+            const std::string copy(str);
+            return insert(pos, copy);
+        }
+
+        if (m_size + str.size() > m_capacity) {
+            reserve(std::max(m_size + str.size(), 2 * m_capacity));
+        }
+
+        std::memmove(m_data + pos + str.size(), m_data + pos, m_size - pos + 1);
+        std::memmove(m_data + pos, str.data(), str.size());
+        m_size += str.size();
+        return *this;
+    }
+
+    /**
+     * Erase the count characters starting from the pos character.
+     * @param pos - position of the first erased character, must not exceed size()
+     * @param count - count of the erased characters (the rest of the string by default)
+     * @return - *this
+     */
+    InlineString &erase(size_type pos, size_type count = npos) {
+        count = std::min(count, m_size - pos);
+        std::memmove(m_data + pos, m_data + pos + count, m_size - pos - count + 1);
+        m_size -= count;
+        return *this;
+    }
+
+    friend inline bool operator==(const InlineString &lhs, std::string_view rhs) noexcept {
+        return lhs.view() == rhs;
+    }
+
+    friend inline bool operator==(std::string_view lhs, const InlineString &rhs) noexcept {
+        return lhs == rhs.view();
+    }
+
+    friend inline bool operator!=(const InlineString &lhs, std::string_view rhs) noexcept {
+        return lhs.view() != rhs;
+    }
+
+    friend inline bool operator!=(std::string_view lhs, const InlineString &rhs) noexcept {
+        return lhs != rhs.view();
+    }
+
+    friend inline std::ostream &operator<<(std::ostream &os, const InlineString &str) {
+        return os << str.view();
+    }
+
+private:
+    void MoveFrom(InlineString &other) noexcept {
+        if (other.is_inline()) {
+            std::memcpy(m_inline, other.m_inline, other.m_size + 1);
+            m_data = m_inline;
+            m_capacity = N;
+        } else {
+            m_heap = std::move(other.m_heap);
+            m_data = m_heap.get();
+            m_capacity = other.m_capacity;
+        }
+
+        m_size = other.m_size;
+
+        other.m_data = other.m_inline;
+        other.m_capacity = N;
+        other.clear();
+    }
+
+    char m_inline[N + 1];
+    std::unique_ptr<char[]> m_heap;
+    char *m_data = m_inline;
+    size_type m_size = 0;
+    size_type m_capacity = N;
+};
+
+} // end of scf
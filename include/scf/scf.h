@@ -9,7 +9,10 @@
 #pragma once
 
 #include <cstring>
+#include <memory_resource>
+#include <string>
 
+#include <scf/inline_string.h>
 #include <scf/detail/format_impl.h>
 
 /**
@@ -19,3 +22,19 @@
 #define SCFormat(str, ...) \
 ::scf::detail::FormatImpl([](){return str;}, ##__VA_ARGS__)
 
+
+/**
+* The macro is the same as SCFormat, but the result std::pmr::string
+* is allocated from the resource (std::pmr::memory_resource *).
+*/
+#define SCFormatPmr(resource, str, ...) \
+::scf::detail::FormatToImpl<std::pmr::string>( \
+    std::pmr::polymorphic_allocator<char>(resource), [](){return str;}, ##__VA_ARGS__)
+
+/**
+* The macro is the same as SCFormat, but the result is the scf::InlineString<N>
+* that stores up to N characters without allocation.
+*/
+#define SCFormatN(N, str, ...) \
+::scf::detail::FormatToImpl<::scf::InlineString<N>>( \
+    std::allocator<char>(), [](){return str;}, ##__VA_ARGS__)
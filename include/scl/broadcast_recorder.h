@@ -0,0 +1,426 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include <scl/levels.h>
+#include <scl/recorder.h>
+#include <scl/sync.h>
+
+namespace scl {
+
+template<typename RecordT, typename SyncT>
+class BroadcastRecorder;
+
+/**
+ * Non-moving broadcast recorder pointer alias.
+ */
+template<typename RecordT, typename SyncT = sync::Mutex>
+using BroadcastRecorderPtr = std::unique_ptr<BroadcastRecorder<RecordT, SyncT>>;
+
+namespace detail {
+
+/**
+ * Single-writer multi-reader ring of serialized records.
+ * The record descriptors (position, data offset, size and level) are stored in a slot ring,
+ * the record data is stored in a byte ring. The readers don't register within the ring:
+ * every reader has its own cursor and validates the copied record after the copying,
+ * so the writer never waits for the readers and a lagging reader skips the overwritten records.
+ */
+class BroadcastRing {
+public:
+    /**
+     * @param records_count - count of the descriptor slots
+     * @param data_size - size of the byte ring
+     */
+    BroadcastRing(std::size_t records_count, std::size_t data_size)
+        : m_records_count(records_count),
+          m_data_size(data_size),
+          m_slots(new Slot[records_count]),
+          m_data(new char[data_size]) {
+    }
+
+    /**
+     * Append a record. The method must be called by a single writer at once.
+     * @param level - level of the record
+     * @param text - serialized record (it is truncated to the byte ring size)
+     */
+    void Publish(Level level, std::string_view text) {
+        const auto position = m_head.load(std::memory_order_relaxed);
+        const auto size = std::min(text.size(), m_data_size);
+        const auto offset = m_reserved.load(std::memory_order_relaxed);
+
+        // invalidate the readers of the overwritten descriptor and data before the writing
+        auto &slot = m_slots[position % m_records_count];
+        slot.position.store(invalid_position_k, std::memory_order_relaxed);
+        m_reserved.store(offset + size, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const auto begin = offset % m_data_size;
+        const auto first_part = std::min(size, m_data_size - begin);
+        std::memcpy(m_data.get() + begin, text.data(), first_part);
+        std::memcpy(m_data.get(), text.data() + first_part, size - first_part);
+
+        slot.offset.store(offset, std::memory_order_relaxed);
+        slot.size.store(size, std::memory_order_relaxed);
+        slot.level.store(level, std::memory_order_relaxed);
+        slot.position.store(position, std::memory_order_release);
+
+        m_head.store(position + 1, std::memory_order_release);
+    }
+
+    /**
+     * Copy the record at the position.
+     * @param position - position of the record, must be less than Head()
+     * @param level - level of the record
+     * @param dst - destination buffer
+     * @return - false if the record is overwritten
+     */
+    bool Read(std::uint64_t position, Level &level, std::string &dst) const {
+        const auto &slot = m_slots[position % m_records_count];
+        if (slot.position.load(std::memory_order_acquire) != position) {
+            return false;
+        }
+
+        const auto offset = slot.offset.load(std::memory_order_relaxed);
+        const auto size = slot.size.load(std::memory_order_relaxed);
+        level = slot.level.load(std::memory_order_relaxed);
+
+        const auto begin = offset % m_data_size;
+        const auto first_part = std::min(size, m_data_size - begin);
+        dst.resize(size);
+        std::memcpy(dst.data(), m_data.get() + begin, first_part);
+        std::memcpy(dst.data() + first_part, m_data.get(), size - first_part);
+
+        // the copy is valid if neither the descriptor nor the data has been overwritten during the copying
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.position.load(std::memory_order_relaxed) == position
+               && m_reserved.load(std::memory_order_relaxed) <= offset + m_data_size;
+    }
+
+    /**
+     * @return - position of the next record
+     */
+    [[nodiscard]]
+    inline std::uint64_t Head() const {
+        return m_head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return - position of the oldest record that may be available
+     */
+    [[nodiscard]]
+    inline std::uint64_t Oldest() const {
+        const auto head = Head();
+        return head > m_records_count ? head - m_records_count : 0;
+    }
+
+    /**
+     * Wait until the record at the position is published.
+     * @param position - position of the record
+     * @param timeout - max waiting time
+     * @return - true if the record is published
+     */
+    bool WaitFor(std::uint64_t position, std::chrono::milliseconds timeout) {
+        if (Head() > position) {
+            return true;
+        }
+
+        std::unique_lock lock(m_wait_mutex);
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        const bool is_published = m_published.wait_for(lock, timeout, [&] { return Head() > position; });
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+        return is_published;
+    }
+
+    /**
+     * Wake up the waiting readers if there are such readers.
+     */
+    inline void Notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) != 0) {
+            // the lock prevents the lost wake-up between the waiter check and its waiting
+            { std::lock_guard lock(m_wait_mutex); }
+            m_published.notify_all();
+        }
+    }
+
+private:
+    static constexpr std::uint64_t invalid_position_k = ~std::uint64_t{0};
+
+    struct Slot {
+        std::atomic<std::uint64_t> position{invalid_position_k};
+        std::atomic<std::uint64_t> offset{0};
+        std::atomic<std::size_t> size{0};
+        std::atomic<Level> level{Level::Debug};
+    };
+
+    std::size_t m_records_count;
+
+    std::size_t m_data_size;
+
+    std::unique_ptr<Slot[]> m_slots;
+
+    std::unique_ptr<char[]> m_data;
+
+    /**
+     * Position of the next record.
+     */
+    std::atomic<std::uint64_t> m_head{0};
+
+    /**
+     * End offset of the data written to the byte ring (including the record being written).
+     */
+    std::atomic<std::uint64_t> m_reserved{0};
+
+    std::mutex m_wait_mutex;
+
+    std::condition_variable m_published;
+
+    std::atomic<std::size_t> m_waiters{0};
+};
+
+} // end of detail
+
+/**
+ * Broadcast recorder that implement the IRecorder interface.
+ * The recorder publishes the serialized records to an in-memory ring,
+ * the subscribers (eg live log viewers of a web UI) read the ring by their own cursors.
+ * A record is stored once for all the subscribers, the subscribers don't register within the writer,
+ * and a subscriber that lags behind the ring skips ahead to the oldest available record instead of blocking the writer.
+ * @tparam RecordT - type of record
+ * @tparam SyncT - synchronization strategy of the writing threads (sync::Mutex by default,
+ *                 sync::None for single-threaded applications or sync::SpinLock)
+ */
+template<typename RecordT, typename SyncT = sync::Mutex>
+class BroadcastRecorder : public IRecorder<RecordT> {
+public:
+    /**
+     * Initialization error info.
+     */
+    enum class InitError {
+        IncorrectRingSize = 1,
+    };
+
+    /**
+     * Initialization result: ether pointer to an initialized recorder or an error info.
+     */
+    using InitResult = std::variant<BroadcastRecorderPtr<RecordT, SyncT>, InitError>;
+
+    /**
+     * Broadcast recorder options.
+     */
+    struct Options {
+        /**
+         * Max count of the kept records.
+         */
+        std::size_t records_count = 64 * 1024;
+
+        /**
+         * Max size of the kept records.
+         */
+        std::size_t data_size = 8 * 1024 * 1024;
+
+        /**
+         * Allow to align entry attributes, if the values is true.
+         */
+        bool align = false;
+    };
+
+    /**
+     * Reader of the records. The subscription may outlive the recorder.
+     * Note a subscription must be used by a single thread at once.
+     */
+    class Subscription {
+    public:
+        /**
+         * Read the available records.
+         * @param fn - function that is called as fn(position, level, record) for every record,
+         *             the record view is valid until the function returns
+         * @param max_count - max count of the read records
+         * @return - count of the read records
+         */
+        template<typename Fn>
+        std::size_t Poll(Fn &&fn, std::size_t max_count = std::numeric_limits<std::size_t>::max()) {
+            std::size_t count = 0;
+            while (count < max_count) {
+                const auto oldest = m_ring->Oldest();
+                if (m_position < oldest) {
+                    // the subscriber lags behind the ring
+                    m_skipped += oldest - m_position;
+                    m_position = oldest;
+                }
+
+                if (m_position >= m_ring->Head()) {
+                    break;
+                }
+
+                Level level;
+                if (!m_ring->Read(m_position, level, m_buffer)) {
+                    ++m_skipped;
+                    ++m_position;
+                    continue;
+                }
+
+                fn(m_position, level, std::string_view(m_buffer));
+                ++m_position;
+                ++count;
+            }
+
+            return count;
+        }
+
+        /**
+         * Wait until a new record is available.
+         * @param timeout - max waiting time
+         * @return - true if a record is available
+         */
+        inline bool Wait(std::chrono::milliseconds timeout) {
+            return m_ring->WaitFor(m_position, timeout);
+        }
+
+        /**
+         * @return - position of the next record to read (it may be used to resume the subscription)
+         */
+        [[nodiscard]]
+        inline std::uint64_t Position() const {
+            return m_position;
+        }
+
+        /**
+         * @return - count of the records that are skipped because the subscriber lagged behind
+         */
+        [[nodiscard]]
+        inline std::uint64_t Skipped() const {
+            return m_skipped;
+        }
+
+    private:
+        friend class BroadcastRecorder;
+
+        Subscription(std::shared_ptr<detail::BroadcastRing> ring, std::uint64_t position)
+            : m_ring(std::move(ring)),
+              m_position(position) {
+        }
+
+        std::shared_ptr<detail::BroadcastRing> m_ring;
+
+        std::uint64_t m_position;
+
+        std::uint64_t m_skipped = 0;
+
+        /**
+         * Copy of the current record.
+         */
+        std::string m_buffer;
+    };
+
+    static std::string ToStr(InitError err) {
+        switch (err) {
+            case InitError::IncorrectRingSize:
+                return "IncorrectRingSize";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /**
+     * Init a BroadcastRecorder instance.
+     * @param options - broadcast recorder options
+     * @return - ether pointer to an initialized recorder or an error info
+     */
+    static InitResult Init(const Options &options) {
+        if (options.records_count == 0 || options.data_size == 0) {
+            return InitError::IncorrectRingSize;
+        }
+
+        return BroadcastRecorderPtr<RecordT, SyncT>(new BroadcastRecorder(options));
+    }
+
+    /**
+     * Default derived dtor.
+     */
+    ~BroadcastRecorder() final = default;
+
+    /**
+     * @overload
+     */
+    void OnRecord(const RecordT &record) final {
+        // the buffer is reused by the records of the thread
+        thread_local std::string record_str;
+        record_str.clear();
+
+        if (m_options.align) {
+            record.AppendAlignedString(record_str);
+        } else {
+            record.AppendString(record_str);
+        }
+
+        {
+            std::lock_guard lock(m_sync);
+            m_ring->Publish(record.level, record_str);
+        }
+
+        m_ring->Notify();
+    }
+
+    /**
+     * Subscribe to the new records.
+     * @return - subscription
+     */
+    Subscription Subscribe() const {
+        return Subscription(m_ring, m_ring->Head());
+    }
+
+    /**
+     * Subscribe to the records starting from the position.
+     * @param position - position of the first record (eg Subscription::Position() of a previous subscription),
+     *                   it is clamped to the available records (0 means the oldest available record)
+     * @return - subscription
+     */
+    Subscription Subscribe(std::uint64_t position) const {
+        return Subscription(m_ring, std::clamp(position, m_ring->Oldest(), m_ring->Head()));
+    }
+
+private:
+    /**
+     * Private ctor.
+     * @param options - broadcast recorder options
+     */
+    explicit BroadcastRecorder(const Options &options)
+        : m_options(options),
+          m_ring(std::make_shared<detail::BroadcastRing>(options.records_count, options.data_size)) {
+    }
+
+    /**
+     * Broadcast recorder options.
+     */
+    Options m_options;
+
+    std::shared_ptr<detail::BroadcastRing> m_ring;
+
+    /**
+     * Synchronization of the writing threads.
+     */
+    SyncT m_sync;
+};
+
+} // end of scl
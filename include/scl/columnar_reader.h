@@ -0,0 +1,510 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <scl/levels.h>
+#include <scl/detail/columnar_format.h>
+
+namespace scl {
+
+class ColumnarReader;
+
+/**
+ * Non-moving columnar reader pointer alias.
+ */
+using ColumnarReaderPtr = std::unique_ptr<ColumnarReader>;
+
+/**
+ * Column of a block loaded by the ColumnarReader.
+ */
+class ColumnarColumn {
+public:
+    /**
+     * @return - column encoding
+     */
+    [[nodiscard]]
+    inline detail::ColumnType Type() const {
+        return m_type;
+    }
+
+    /**
+     * @param index - index of the record within the block
+     * @return - true if the record has the field
+     */
+    [[nodiscard]]
+    inline bool Has(std::size_t index) const {
+        return (static_cast<unsigned char>(m_bitmap[index / 8]) & (1u << (index % 8))) != 0;
+    }
+
+    /**
+     * @param index - index of the record within the block
+     * @return - integer value of the field, the type must be ColumnType::Integer
+     */
+    [[nodiscard]]
+    inline std::int64_t Integer(std::size_t index) const {
+        return static_cast<std::int64_t>(m_base + detail::LoadLe(m_values + index * m_width, m_width));
+    }
+
+    /**
+     * @param index - index of the record within the block, the record must have the field (see Has())
+     * @return - string value of the field, the type must be ColumnType::Dictionary or ColumnType::Plain
+     */
+    [[nodiscard]]
+    inline std::string_view String(std::size_t index) const {
+        if (m_type == detail::ColumnType::Dictionary) {
+            return DictionaryValue(DictionaryId(index));
+        }
+
+        return Range(index);
+    }
+
+    /**
+     * @return - count of the distinct values of the ColumnType::Dictionary column
+     */
+    [[nodiscard]]
+    inline std::size_t DictionarySize() const {
+        return m_dictionary_size;
+    }
+
+    /**
+     * Dictionary id allows to group the records without the string comparison.
+     * @param index - index of the record within the block, the record must have the field (see Has())
+     * @return - dictionary id of the field value, the type must be ColumnType::Dictionary
+     */
+    [[nodiscard]]
+    inline std::size_t DictionaryId(std::size_t index) const {
+        return static_cast<std::size_t>(detail::LoadLe(m_values + index * m_width, m_width));
+    }
+
+    /**
+     * @param id - dictionary id (less than DictionarySize())
+     * @return - dictionary value
+     */
+    [[nodiscard]]
+    inline std::string_view DictionaryValue(std::size_t id) const {
+        return Range(id);
+    }
+
+private:
+    friend class ColumnarReader;
+
+    inline std::string_view Range(std::size_t index) const {
+        const auto begin = detail::LoadLe(m_offsets + index * 4, 4);
+        const auto end = detail::LoadLe(m_offsets + (index + 1) * 4, 4);
+        return {m_bytes + begin, static_cast<std::size_t>(end - begin)};
+    }
+
+    /**
+     * Set the pointers to the column parts within the loaded data and validate them once,
+     * so the accessors don't read out of the data: the string offsets must not decrease
+     * and the dictionary ids of the present fields must be less than the dictionary size.
+     * @return - false if the data is malformed
+     */
+    bool Parse(detail::ColumnType type, std::size_t records_count) {
+        using Type = detail::ColumnType;
+
+        m_type = type;
+        const char *data = m_data.data();
+        const std::size_t size = m_data.size();
+        std::size_t pos = detail::BitmapSize(records_count);
+        if (pos > size) {
+            return false;
+        }
+
+        m_bitmap = data;
+        if (type == Type::Integer) {
+            if (size - pos < 9) {
+                return false;
+            }
+
+            m_base = detail::LoadLe(data + pos, 8);
+            m_width = static_cast<std::size_t>(detail::LoadLe(data + pos + 8, 1));
+            pos += 9;
+            m_values = data + pos;
+            return IsWidthCorrect() && (size - pos) / m_width >= records_count;
+        }
+
+        std::size_t ranges_count = records_count;
+        if (type == Type::Dictionary) {
+            if (size - pos < 5) {
+                return false;
+            }
+
+            m_width = static_cast<std::size_t>(detail::LoadLe(data + pos, 1));
+            m_dictionary_size = static_cast<std::size_t>(detail::LoadLe(data + pos + 1, 4));
+            ranges_count = m_dictionary_size;
+            pos += 5;
+        } else if (type != Type::Plain) {
+            return false;
+        }
+
+        if ((size - pos) / 4 < ranges_count + 1) {
+            return false;
+        }
+
+        m_offsets = data + pos;
+        pos += (ranges_count + 1) * 4;
+        m_bytes = data + pos;
+        const auto bytes_size = detail::LoadLe(m_offsets + ranges_count * 4, 4);
+        if (size - pos < bytes_size || !AreOffsetsCorrect(ranges_count)) {
+            return false;
+        }
+
+        pos += static_cast<std::size_t>(bytes_size);
+        if (type == Type::Plain) {
+            return true;
+        }
+
+        m_values = data + pos;
+        if (!IsWidthCorrect() || (size - pos) / m_width < records_count) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < records_count; ++i) {
+            if (Has(i) && DictionaryId(i) >= m_dictionary_size) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @param ranges_count - count of the string ranges
+     * @return - true if the offsets don't decrease (the last offset is the size of the bytes)
+     */
+    bool AreOffsetsCorrect(std::size_t ranges_count) const {
+        auto previous = detail::LoadLe(m_offsets, 4);
+        for (std::size_t i = 1; i <= ranges_count; ++i) {
+            const auto offset = detail::LoadLe(m_offsets + i * 4, 4);
+            if (offset < previous) {
+                return false;
+            }
+
+            previous = offset;
+        }
+
+        return true;
+    }
+
+    inline bool IsWidthCorrect() const {
+        return m_width == 1 || m_width == 2 || m_width == 4 || m_width == 8;
+    }
+
+    /**
+     * Column data, the buffer is reused by the blocks.
+     */
+    std::string m_data;
+
+    detail::ColumnType m_type = detail::ColumnType::None;
+    const char *m_bitmap = nullptr;
+    const char *m_values = nullptr;
+    const char *m_offsets = nullptr;
+    const char *m_bytes = nullptr;
+    std::uint64_t m_base = 0;
+    std::size_t m_width = 1;
+    std::size_t m_dictionary_size = 0;
+};
+
+/**
+ * Block of the records loaded by the ColumnarReader.
+ */
+class ColumnarBlock {
+public:
+    /**
+     * @return - count of the block records
+     */
+    [[nodiscard]]
+    inline std::size_t RecordsCount() const {
+        return m_records_count;
+    }
+
+    /**
+     * @return - min time of the block records (see TimeStrToSeconds()) or std::nullopt if there is no time column
+     */
+    [[nodiscard]]
+    inline std::optional<std::int64_t> MinTime() const {
+        return HasTime() ? std::optional<std::int64_t>(m_min_time) : std::nullopt;
+    }
+
+    /**
+     * @return - max time of the block records or std::nullopt if there is no time column
+     */
+    [[nodiscard]]
+    inline std::optional<std::int64_t> MaxTime() const {
+        return HasTime() ? std::optional<std::int64_t>(m_max_time) : std::nullopt;
+    }
+
+    /**
+     * @param key - column key (eg RecordKey or cis1::core_logger::CoreRecordKey)
+     * @return - loaded column or nullptr if the column is not loaded or the block has no such column
+     */
+    template<typename KeyT>
+    [[nodiscard]]
+    inline const ColumnarColumn *Column(KeyT key) const {
+        const auto index = static_cast<std::size_t>(key);
+        return index < detail::columnar::max_columns_k && m_is_loaded[index] ? &m_columns[index] : nullptr;
+    }
+
+private:
+    friend class ColumnarReader;
+
+    inline bool HasTime() const {
+        return m_min_time <= m_max_time;
+    }
+
+    std::size_t m_records_count = 0;
+    std::int64_t m_min_time = 0;
+    std::int64_t m_max_time = 0;
+    std::array<bool, detail::columnar::max_columns_k> m_is_loaded{};
+    std::array<ColumnarColumn, detail::columnar::max_columns_k> m_columns;
+};
+
+/**
+ * Reader of the segment files written by the ColumnarRecorder.
+ * The reader loads only the requested columns and skips the blocks by their time and level statistics,
+ * so a query like "count the errors per action within the last hour" reads a small part of the segment.
+ * The column buffers are reused by the blocks.
+ */
+class ColumnarReader {
+public:
+    /**
+     * Initialization error info.
+     */
+    enum class InitError {
+        CantOpenFile = 1,
+        NotSegmentFile,
+    };
+
+    /**
+     * Initialization result: ether pointer to an initialized reader or an error info.
+     */
+    using InitResult = std::variant<ColumnarReaderPtr, InitError>;
+
+    /**
+     * Scan options.
+     */
+    struct ScanOptions {
+        /**
+         * Keys of the loaded columns (see Columns()), all the columns are loaded if the value is empty.
+         */
+        std::vector<std::uint8_t> columns;
+
+        /**
+         * The blocks that have no records at or after the time are skipped.
+         */
+        std::optional<std::int64_t> min_time = std::nullopt;
+
+        /**
+         * The blocks that have no records at or before the time are skipped.
+         */
+        std::optional<std::int64_t> max_time = std::nullopt;
+
+        /**
+         * The blocks that have no records at or above the level are skipped.
+         */
+        std::optional<Level> level = std::nullopt;
+    };
+
+    /**
+     * Scan statistics.
+     */
+    struct ScanStats {
+        std::size_t blocks_count = 0;
+        std::size_t skipped_blocks_count = 0;
+
+        /**
+         * The segment contains an incorrect or a truncated block, the scan stopped on it.
+         */
+        bool is_malformed = false;
+    };
+
+    static std::string ToStr(InitError err) {
+        switch (err) {
+            case InitError::CantOpenFile:
+                return "CantOpenFile";
+            case InitError::NotSegmentFile:
+                return "NotSegmentFile";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /**
+     * Init a ColumnarReader instance.
+     * @param path - path to the segment file
+     * @return - ether pointer to an initialized reader or an error info
+     */
+    static InitResult Init(const std::filesystem::path &path) {
+        namespace Col = detail::columnar;
+
+        ColumnarReaderPtr instance(new ColumnarReader());
+        instance->m_file.open(path, std::ios::binary);
+        if (!instance->m_file.is_open()) {
+            return InitError::CantOpenFile;
+        }
+
+        instance->m_file.seekg(0, std::ios::end);
+        instance->m_file_size = static_cast<std::uint64_t>(instance->m_file.tellg());
+        instance->m_file.seekg(0);
+
+        std::string magic(Col::segment_magic_k.size(), '\0');
+        if (!instance->m_file.read(magic.data(), static_cast<std::streamsize>(magic.size()))
+            || magic != Col::segment_magic_k) {
+            return InitError::NotSegmentFile;
+        }
+
+        return instance;
+    }
+
+    /**
+     * @param keys - column keys (eg cis1::core_logger::CoreRecordKey values)
+     * @return - value of the ScanOptions::columns
+     */
+    template<typename ...KeyT>
+    static std::vector<std::uint8_t> Columns(KeyT ...keys) {
+        return {static_cast<std::uint8_t>(keys)...};
+    }
+
+    /**
+     * Scan the segment.
+     * @param options - scan options
+     * @param fn - function that is called as fn(const ColumnarBlock &) for every not skipped block,
+     *             the block is valid until the function returns
+     * @return - scan statistics
+     */
+    template<typename Fn>
+    ScanStats Scan(const ScanOptions &options, Fn &&fn) {
+        namespace Col = detail::columnar;
+        using detail::LoadLe;
+
+        std::array<bool, Col::max_columns_k> is_requested{};
+        for (const auto key : options.columns) {
+            if (key < Col::max_columns_k) {
+                is_requested[key] = true;
+            }
+        }
+
+        ScanStats stats;
+        m_file.clear();
+        m_file.seekg(static_cast<std::streamoff>(Col::segment_magic_k.size()));
+
+        while (true) {
+            char header[Col::block_header_size_k];
+            m_file.read(header, sizeof(header));
+            const auto read_size = static_cast<std::size_t>(m_file.gcount());
+            if (read_size == 0) {
+                break;
+            }
+
+            if (read_size != sizeof(header) || LoadLe(header, 4) != Col::block_magic_k) {
+                stats.is_malformed = true;
+                break;
+            }
+
+            auto &block = m_block;
+            block.m_records_count = static_cast<std::size_t>(LoadLe(header + 4, 4));
+            const auto data_size = LoadLe(header + 8, 8);
+            block.m_min_time = static_cast<std::int64_t>(LoadLe(header + 16, 8));
+            block.m_max_time = static_cast<std::int64_t>(LoadLe(header + 24, 8));
+            const auto min_level = static_cast<std::uint8_t>(LoadLe(header + 32, 1));
+            const auto columns_count = static_cast<std::size_t>(LoadLe(header + 34, 1));
+
+            m_entries.resize(columns_count * Col::column_entry_size_k);
+            if (!m_file.read(m_entries.data(), static_cast<std::streamsize>(m_entries.size()))) {
+                stats.is_malformed = true;
+                break;
+            }
+
+            const auto data_begin = m_file.tellg();
+            // the sizes are bounded by the file, so a corrupt header doesn't cause a huge allocation
+            if (data_begin < 0 || data_size > m_file_size - static_cast<std::uint64_t>(data_begin)) {
+                stats.is_malformed = true;
+                break;
+            }
+
+            const auto block_end = data_begin + static_cast<std::streamoff>(data_size);
+            ++stats.blocks_count;
+
+            const bool is_out_of_time = block.HasTime()
+                                        && ((options.min_time && block.m_max_time < *options.min_time)
+                                            || (options.max_time && block.m_min_time > *options.max_time));
+            // the lower level value is the more important record
+            const bool is_out_of_level = options.level
+                                         && (min_level == Col::no_level_k
+                                             || min_level > static_cast<std::uint8_t>(*options.level));
+            if (is_out_of_time || is_out_of_level) {
+                ++stats.skipped_blocks_count;
+                m_file.seekg(block_end);
+                continue;
+            }
+
+            block.m_is_loaded.fill(false);
+            for (std::size_t i = 0; i < columns_count; ++i) {
+                const char *entry = m_entries.data() + i * Col::column_entry_size_k;
+                const auto key = static_cast<std::size_t>(LoadLe(entry, 1));
+                if (key >= Col::max_columns_k || (!options.columns.empty() && !is_requested[key])) {
+                    continue;
+                }
+
+                const auto type = static_cast<detail::ColumnType>(LoadLe(entry + 1, 1));
+                const auto offset = LoadLe(entry + 2, 8);
+                const auto size = LoadLe(entry + 10, 8);
+                if (offset > data_size || size > data_size - offset) {
+                    stats.is_malformed = true;
+                    return stats;
+                }
+
+                auto &column = block.m_columns[key];
+                column.m_data.resize(static_cast<std::size_t>(size));
+                m_file.seekg(data_begin + static_cast<std::streamoff>(offset));
+                if (!m_file.read(column.m_data.data(), static_cast<std::streamsize>(size))
+                    || !column.Parse(type, block.m_records_count)) {
+                    stats.is_malformed = true;
+                    return stats;
+                }
+
+                block.m_is_loaded[key] = true;
+            }
+
+            fn(static_cast<const ColumnarBlock &>(block));
+            m_file.seekg(block_end);
+        }
+
+        return stats;
+    }
+
+private:
+    ColumnarReader() = default;
+
+    std::ifstream m_file;
+
+    std::uint64_t m_file_size = 0;
+
+    /**
+     * Current block, the column buffers are reused by the blocks.
+     */
+    ColumnarBlock m_block;
+
+    std::string m_entries;
+};
+
+} // end of scl
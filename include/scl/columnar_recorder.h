@@ -0,0 +1,454 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include <scl/msgpack_reader.h>
+#include <scl/record.h>
+#include <scl/recorder.h>
+#include <scl/sync.h>
+#include <scl/detail/columnar_format.h>
+
+namespace scl {
+
+template<typename RecordT, typename SyncT>
+class ColumnarRecorder;
+
+/**
+ * Non-moving columnar recorder pointer alias.
+ */
+template<typename RecordT, typename SyncT = sync::Mutex>
+using ColumnarRecorderPtr = std::unique_ptr<ColumnarRecorder<RecordT, SyncT>>;
+
+/**
+ * Columnar recorder that implement the IRecorder interface.
+ * The recorder buffers the records to blocks and writes every block field by field to a segment file
+ * (see detail/columnar_format.h), so a query reads only the needed columns of the blocks (see ColumnarReader):
+ * - the integer fields (level, time, pids, protocol) are stored as the block min value and the narrowest differences;
+ * - the message is stored as the concatenated strings and their offsets;
+ * - other string fields (session id, action, handler etc.) are dictionary-encoded.
+ * Every block header contains the min/max time and level of the block records.
+ *
+ * The fields of a record are taken from its MessagePack serialization (see RecordFormat::MessagePack),
+ * so the column keys are the record keys (eg cis1::core_logger::CoreRecordKey).
+ * The column type is set by the first value of the block, a value of another type (eg a time of an unexpected format)
+ * is stored as an absent one.
+ * @tparam RecordT - type of record
+ * @tparam SyncT - synchronization strategy of the writing threads (sync::Mutex by default,
+ *                 sync::None for single-threaded applications or sync::SpinLock)
+ */
+template<typename RecordT, typename SyncT = sync::Mutex>
+class ColumnarRecorder : public IRecorder<RecordT> {
+public:
+    /**
+     * Initialization error info.
+     */
+    enum class InitError {
+        CantOpenFile = 1,
+        NotSegmentFile,
+        IncorrectBlockSize,
+    };
+
+    /**
+     * Initialization result: ether pointer to an initialized recorder or an error info.
+     */
+    using InitResult = std::variant<ColumnarRecorderPtr<RecordT, SyncT>, InitError>;
+
+    /**
+     * Columnar recorder options.
+     */
+    struct Options {
+        /**
+         * Path to the segment file, the blocks are appended to an existing segment.
+         */
+        std::filesystem::path path;
+
+        /**
+         * Max count of the records of a block.
+         */
+        std::size_t block_records_count = 8192;
+
+        /**
+         * Max size of the serialized records of a block.
+         */
+        std::size_t block_data_size = 4 * 1024 * 1024;
+    };
+
+    static std::string ToStr(InitError err) {
+        switch (err) {
+            case InitError::CantOpenFile:
+                return "CantOpenFile";
+            case InitError::NotSegmentFile:
+                return "NotSegmentFile";
+            case InitError::IncorrectBlockSize:
+                return "IncorrectBlockSize";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /**
+     * Init a ColumnarRecorder instance.
+     * @param options - columnar recorder options
+     * @return - ether pointer to an initialized recorder or an error info
+     */
+    static InitResult Init(const Options &options) {
+        namespace Col = detail::columnar;
+
+        if (options.block_records_count == 0 || options.block_data_size == 0
+            || options.block_data_size > std::numeric_limits<std::uint32_t>::max()) {
+            return InitError::IncorrectBlockSize;
+        }
+
+        std::error_code ec{};
+        const auto size = std::filesystem::file_size(options.path, ec);
+        const bool is_new = ec || size == 0;
+        if (!is_new) {
+            std::ifstream segment(options.path, std::ios::binary);
+            std::string magic(Col::segment_magic_k.size(), '\0');
+            if (!segment.read(magic.data(), static_cast<std::streamsize>(magic.size()))
+                || magic != Col::segment_magic_k) {
+                return InitError::NotSegmentFile;
+            }
+        }
+
+        ColumnarRecorderPtr<RecordT, SyncT> instance(new ColumnarRecorder(options));
+        instance->m_file.open(options.path, std::ios::app | std::ios::binary);
+        if (!instance->m_file.is_open()) {
+            return InitError::CantOpenFile;
+        }
+
+        if (is_new) {
+            instance->m_file.write(Col::segment_magic_k.data(), Col::segment_magic_k.size());
+        }
+
+        return instance;
+    }
+
+    /**
+     * Dtor writes the buffered records.
+     */
+    ~ColumnarRecorder() final {
+        Flush();
+    }
+
+    /**
+     * @overload
+     */
+    void OnRecord(const RecordT &record) final {
+        // the buffers are reused by the records of the thread
+        thread_local std::string record_msgpack;
+        thread_local MsgPackRecord fields;
+        record_msgpack.clear();
+        record.AppendMsgPack(record_msgpack);
+
+        std::size_t size = 0;
+        if (MsgPackReader::Parse(record_msgpack, fields, size) != MsgPackReader::ParseResult::Ok) {
+            return;
+        }
+
+        std::lock_guard lock(m_sync);
+        // the serialized record size is the upper bound of its string fields size
+        if (m_records_count != 0 && m_data_size + record_msgpack.size() > m_options.block_data_size) {
+            WriteBlock();
+        }
+
+        for (std::size_t key = 0; key < MsgPackRecord::max_keys_k; ++key) {
+            const auto &value = fields.Get(key);
+            if (value.type == MsgPackValue::Type::Integer || value.type == MsgPackValue::Type::String) {
+                m_columns[key].Append(key, m_records_count, value);
+            }
+        }
+
+        ++m_records_count;
+        m_data_size += record_msgpack.size();
+        if (m_records_count == m_options.block_records_count) {
+            WriteBlock();
+        }
+    }
+
+    /**
+     * Write the buffered records as a block.
+     */
+    void Flush() {
+        std::lock_guard lock(m_sync);
+        WriteBlock();
+        m_file.flush();
+    }
+
+private:
+    /**
+     * Values of a block column.
+     */
+    struct ColumnBuilder {
+        detail::ColumnType type = detail::ColumnType::None;
+
+        /**
+         * Presence flag per record.
+         */
+        std::vector<std::uint8_t> presence;
+
+        /**
+         * Integer, dictionary id or end offset of the string bytes per record.
+         */
+        std::vector<std::int64_t> values;
+
+        /**
+         * Plain string bytes or dictionary value bytes.
+         */
+        std::string bytes;
+
+        std::vector<std::uint32_t> dictionary_ends;
+        std::unordered_map<std::string, std::uint32_t> dictionary;
+        std::string lookup_key;
+
+        void Append(std::size_t key, std::size_t index, const MsgPackValue &value) {
+            using Type = detail::ColumnType;
+
+            if (type == Type::None) {
+                type = value.type == MsgPackValue::Type::Integer ? Type::Integer
+                       : key == static_cast<std::size_t>(RecordKey::Message) ? Type::Plain
+                       : Type::Dictionary;
+            }
+
+            const bool is_integer = type == Type::Integer;
+            if (is_integer != (value.type == MsgPackValue::Type::Integer)) {
+                // the value of another type is stored as an absent one
+                return;
+            }
+
+            Pad(index);
+            presence.push_back(1);
+            if (type == Type::Integer) {
+                values.push_back(value.integer);
+            } else if (type == Type::Plain) {
+                bytes += value.string;
+                values.push_back(static_cast<std::int64_t>(bytes.size()));
+            } else {
+                // the reused key doesn't allocate on the lookup of an existing value
+                lookup_key.assign(value.string);
+                auto it = dictionary.find(lookup_key);
+                if (it == dictionary.end()) {
+                    it = dictionary.emplace(lookup_key, static_cast<std::uint32_t>(dictionary.size())).first;
+                    bytes += value.string;
+                    dictionary_ends.push_back(static_cast<std::uint32_t>(bytes.size()));
+                }
+
+                values.push_back(it->second);
+            }
+        }
+
+        /**
+         * Add the absent values up to the records count.
+         */
+        void Pad(std::size_t records_count) {
+            const auto absent_value = type == detail::ColumnType::Plain ? static_cast<std::int64_t>(bytes.size()) : 0;
+            presence.resize(records_count, 0);
+            values.resize(records_count, absent_value);
+        }
+
+        void Clear() {
+            type = detail::ColumnType::None;
+            presence.clear();
+            values.clear();
+            bytes.clear();
+            dictionary_ends.clear();
+            dictionary.clear();
+        }
+    };
+
+    /**
+     * Private ctor.
+     * @param options - columnar recorder options
+     */
+    explicit ColumnarRecorder(const Options &options)
+        : m_options(options) {
+    }
+
+    /**
+     * Write the buffered records as a block.
+     * Note: the method should be called after the m_sync will be locked.
+     */
+    void WriteBlock() {
+        namespace Col = detail::columnar;
+        using detail::AppendLe;
+
+        if (m_records_count == 0) {
+            return;
+        }
+
+        std::int64_t min_time = std::numeric_limits<std::int64_t>::max();
+        std::int64_t max_time = std::numeric_limits<std::int64_t>::min();
+        std::uint8_t min_level = Col::no_level_k;
+        std::uint8_t max_level = 0;
+
+        m_block.clear();
+        m_entries.clear();
+        std::size_t columns_count = 0;
+        for (std::size_t key = 0; key < Col::max_columns_k; ++key) {
+            auto &column = m_columns[key];
+            if (column.type == detail::ColumnType::None) {
+                continue;
+            }
+
+            column.Pad(m_records_count);
+            if (column.type == detail::ColumnType::Integer) {
+                for (std::size_t i = 0; i < m_records_count; ++i) {
+                    if (column.presence[i] == 0) {
+                        continue;
+                    }
+
+                    const auto value = column.values[i];
+                    if (key == static_cast<std::size_t>(RecordKey::Time)) {
+                        min_time = std::min(min_time, value);
+                        max_time = std::max(max_time, value);
+                    } else if (key == static_cast<std::size_t>(RecordKey::Level)) {
+                        min_level = std::min(min_level, static_cast<std::uint8_t>(value));
+                        max_level = std::max(max_level, static_cast<std::uint8_t>(value));
+                    }
+                }
+            }
+
+            const auto offset = m_block.size();
+            WriteColumn(column);
+
+            AppendLe(m_entries, key, 1);
+            AppendLe(m_entries, static_cast<std::uint8_t>(column.type), 1);
+            AppendLe(m_entries, offset, 8);
+            AppendLe(m_entries, m_block.size() - offset, 8);
+            ++columns_count;
+            column.Clear();
+        }
+
+        std::string header;
+        AppendLe(header, Col::block_magic_k, 4);
+        AppendLe(header, m_records_count, 4);
+        AppendLe(header, m_block.size(), 8);
+        AppendLe(header, static_cast<std::uint64_t>(min_time), 8);
+        AppendLe(header, static_cast<std::uint64_t>(max_time), 8);
+        AppendLe(header, min_level, 1);
+        AppendLe(header, max_level, 1);
+        AppendLe(header, columns_count, 1);
+
+        m_file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        m_file.write(m_entries.data(), static_cast<std::streamsize>(m_entries.size()));
+        m_file.write(m_block.data(), static_cast<std::streamsize>(m_block.size()));
+
+        m_records_count = 0;
+        m_data_size = 0;
+    }
+
+    /**
+     * Append the column data to the block.
+     */
+    void WriteColumn(const ColumnBuilder &column) {
+        using detail::AppendLe;
+        using Type = detail::ColumnType;
+
+        const auto bitmap_begin = m_block.size();
+        m_block.resize(bitmap_begin + detail::BitmapSize(m_records_count), '\0');
+        for (std::size_t i = 0; i < m_records_count; ++i) {
+            if (column.presence[i] != 0) {
+                m_block[bitmap_begin + i / 8] = static_cast<char>(m_block[bitmap_begin + i / 8] | (1 << (i % 8)));
+            }
+        }
+
+        if (column.type == Type::Integer) {
+            std::int64_t min_value = std::numeric_limits<std::int64_t>::max();
+            std::int64_t max_value = std::numeric_limits<std::int64_t>::min();
+            for (std::size_t i = 0; i < m_records_count; ++i) {
+                if (column.presence[i] != 0) {
+                    min_value = std::min(min_value, column.values[i]);
+                    max_value = std::max(max_value, column.values[i]);
+                }
+            }
+
+            const auto base = min_value <= max_value ? min_value : 0;
+            const auto width = detail::IntegerWidth(min_value <= max_value
+                                                    ? static_cast<std::uint64_t>(max_value) - base : 0);
+            AppendLe(m_block, static_cast<std::uint64_t>(base), 8);
+            AppendLe(m_block, width, 1);
+            for (std::size_t i = 0; i < m_records_count; ++i) {
+                const auto delta = column.presence[i] != 0 ? static_cast<std::uint64_t>(column.values[i]) - base : 0;
+                AppendLe(m_block, delta, width);
+            }
+
+            return;
+        }
+
+        if (column.type == Type::Dictionary) {
+            const auto width = detail::IntegerWidth(column.dictionary_ends.size());
+            AppendLe(m_block, width, 1);
+            AppendLe(m_block, column.dictionary_ends.size(), 4);
+            AppendLe(m_block, 0, 4);
+            for (const auto end : column.dictionary_ends) {
+                AppendLe(m_block, end, 4);
+            }
+
+            m_block += column.bytes;
+            for (std::size_t i = 0; i < m_records_count; ++i) {
+                AppendLe(m_block, static_cast<std::uint64_t>(column.values[i]), width);
+            }
+
+            return;
+        }
+
+        AppendLe(m_block, 0, 4);
+        for (std::size_t i = 0; i < m_records_count; ++i) {
+            AppendLe(m_block, static_cast<std::uint64_t>(column.values[i]), 4);
+        }
+
+        m_block += column.bytes;
+    }
+
+    /**
+     * Columnar recorder options.
+     */
+    Options m_options;
+
+    std::ofstream m_file;
+
+    /**
+     * Columns of the buffered records by the record keys.
+     */
+    std::array<ColumnBuilder, detail::columnar::max_columns_k> m_columns;
+
+    std::size_t m_records_count = 0;
+
+    /**
+     * Size of the serialized buffered records.
+     */
+    std::size_t m_data_size = 0;
+
+    /**
+     * Buffers of the written block: column entries and column data.
+     */
+    std::string m_entries;
+    std::string m_block;
+
+    /**
+     * Synchronization of the writing threads.
+     */
+    SyncT m_sync;
+};
+
+} // end of scl
@@ -9,24 +9,30 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <iostream>
 #include <scl/recorder.h>
+#include <scl/sync.h>
+#include <scl/detail/sanitize.h>
 
 namespace scl {
 
-template<typename RecordT>
+template<typename RecordT, typename SyncT>
 class ConsoleRecorder;
 
 /**
  * Alias of non-moving console recorder pointer.
  */
-template<typename RecordT>
-using ConsoleRecorderPtr = std::unique_ptr<ConsoleRecorder<RecordT>>;
+template<typename RecordT, typename SyncT = sync::Mutex>
+using ConsoleRecorderPtr = std::unique_ptr<ConsoleRecorder<RecordT, SyncT>>;
 
 /**
  * Console recorder that implement the IRecorder interface.
+ * @tparam RecordT - type of record
+ * @tparam SyncT - synchronization strategy of the printing (sync::Mutex by default,
+ *                 sync::None for single-threaded applications or sync::SpinLock)
  */
-template<typename RecordT>
+template<typename RecordT, typename SyncT = sync::Mutex>
 class ConsoleRecorder : public IRecorder<RecordT> {
 public:
     /**
@@ -35,8 +41,21 @@ public:
     struct Options {
         /**
          * Allow to align entry attributes, if the values is true.
+         * The option is equivalent to the RecordFormat::Aligned format.
          */
         bool align = false;
+
+        /**
+         * Serialization format of the records.
+         * The binary records (see IsBinaryFormat()) are not separated by line breaks.
+         */
+        RecordFormat format = RecordFormat::Plain;
+
+        /**
+         * Escape the control characters and the backslash of the plain and aligned records ("\n" -> "\\n" etc.),
+         * so a multi-line message takes a single line. The option doesn't affect the JSON Lines and MessagePack records.
+         */
+        bool sanitize = false;
     };
 
     /**
@@ -49,18 +68,26 @@ public:
      * @param options - console recorder options
      * @return - ether pointer to an initialized recorder or an error info
      */
-    static ConsoleRecorderPtr<RecordT> Init(const Options &options) {
-        return ConsoleRecorderPtr<RecordT>(new ConsoleRecorder(options));
+    static ConsoleRecorderPtr<RecordT, SyncT> Init(const Options &options) {
+        return ConsoleRecorderPtr<RecordT, SyncT>(new ConsoleRecorder(options));
     }
 
     /**
      * @overload
      */
     inline void OnRecord(const RecordT &record) final {
-        if (m_options.align) {
-            std::cout << record.ToAlignedString() << std::endl;
+        std::string record_str;
+        record.AppendFormatted(record_str, m_format);
+        if (m_sanitize) {
+            detail::SanitizeControlChars(record_str);
+        }
+
+        std::lock_guard lock(m_sync);
+        if (IsBinaryFormat(m_format)) {
+            std::cout.write(record_str.data(), static_cast<std::streamsize>(record_str.size()));
+            std::cout.flush();
         } else {
-            std::cout << record.ToString() << std::endl;
+            std::cout << record_str << std::endl;
         }
     }
 
@@ -70,13 +97,32 @@ private:
      * @param options - console recorder options
      */
     explicit ConsoleRecorder(const Options &options)
-        : m_options(options) {
+        : m_options(options),
+          m_format(options.align && options.format == RecordFormat::Plain ? RecordFormat::Aligned
+                                                                          : options.format),
+          m_sanitize(options.sanitize
+                     && (m_format == RecordFormat::Plain || m_format == RecordFormat::Aligned)) {
     }
 
     /**
      * Console recorder options.
      */
     Options m_options;
+
+    /**
+     * Serialization format that takes the align option into account.
+     */
+    RecordFormat m_format;
+
+    /**
+     * Escape the control characters of the serialized records.
+     */
+    bool m_sanitize;
+
+    /**
+     * Synchronization of the printing.
+     */
+    SyncT m_sync;
 };
 
 }
@@ -0,0 +1,238 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the Bloom filter of the log file fields (see FileRecorder::Options::bloom_filter_size).
+ * The filter of a closed log file is kept in the "<log file>.bloom" sidecar, all the integers are little-endian.
+ *
+ * filter:     "SCLBLM01" u32 hashes_count, u64 words_count, u64 words[words_count]
+ *
+ * A value is hashed together with its field, so a session id doesn't match an equal action.
+ * The hashes don't depend on the platform, so the filters may be checked on another host.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <scl/detail/columnar_format.h>
+#include <scl/detail/record_fields.h>
+
+namespace scl::detail {
+
+namespace bloom {
+constexpr std::string_view magic_k = "SCLBLM01";
+constexpr std::string_view extension_k = ".bloom";
+constexpr std::size_t header_size_k = 8 + 4 + 8;
+
+/**
+ * Count of the bit probes per value: about 1% of false positives if there are 10 bits per value.
+ */
+constexpr std::uint32_t hashes_count_k = 7;
+} // end of bloom
+
+/**
+ * Indexed field of the records.
+ */
+enum class BloomField : std::uint8_t {
+    SessionId = 1,
+    Action,
+    Handler,
+};
+
+/**
+ * @param log_path - path to a log file
+ * @return - path to the Bloom filter sidecar of the log file
+ */
+inline std::filesystem::path BloomFilterPath(const std::filesystem::path &log_path) {
+    auto filter_path = log_path;
+    filter_path += bloom::extension_k;
+    return filter_path;
+}
+
+/**
+ * Hash the value of the field (FNV-1a and the SplitMix64 finalizer).
+ * @param field - field
+ * @param value - value of the field
+ * @return - hash
+ */
+inline std::uint64_t BloomHash(BloomField field, std::string_view value) {
+    std::uint64_t hash = 0xcbf29ce484222325ull ^ static_cast<std::uint64_t>(field);
+    for (const char ch : value) {
+        hash = (hash ^ static_cast<unsigned char>(ch)) * 0x100000001b3ull;
+    }
+
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    return hash ^ (hash >> 31);
+}
+
+/**
+ * Hash the indexed fields of the record (the session id, action and handler if the record has them).
+ * @param record - record
+ * @param hashes - destination of the hashes
+ * @return - count of the hashes
+ */
+template<typename RecordT>
+std::size_t RecordBloomHashes(const RecordT &record, std::array<std::uint64_t, 3> &hashes) {
+    std::size_t count = 0;
+    if constexpr (HasSessionId<RecordT>::value) {
+        if (record.session_id) {
+            hashes[count++] = BloomHash(BloomField::SessionId, *record.session_id);
+        }
+    }
+
+    if constexpr (HasAction<RecordT>::value) {
+        if (record.action) {
+            hashes[count++] = BloomHash(BloomField::Action, *record.action);
+        }
+    }
+
+    if constexpr (HasHandler<RecordT>::value) {
+        if (record.handler) {
+            hashes[count++] = BloomHash(BloomField::Handler, *record.handler);
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Bloom filter: a value that was added is always found, a value that wasn't added is rarely found.
+ * The bits of a value are selected by the double hashing (h1 + i * h2).
+ */
+class BloomFilter {
+public:
+    /**
+     * @param size - size of the filter in bytes (rounded up to 8 bytes)
+     * @param hashes_count - count of the bit probes per value
+     */
+    explicit BloomFilter(std::size_t size, std::uint32_t hashes_count = bloom::hashes_count_k)
+        : m_hashes_count(hashes_count),
+          m_words(std::max<std::size_t>(1, (size + 7) / 8), 0) {
+    }
+
+    /**
+     * Load the filter from the sidecar.
+     * @param path - path to the filter file
+     * @return - filter or std::nullopt if the file couldn't be read or has another format
+     */
+    static std::optional<BloomFilter> Load(const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::binary);
+        char header[bloom::header_size_k];
+        if (!file.read(header, sizeof(header))
+            || std::string_view(header, bloom::magic_k.size()) != bloom::magic_k) {
+            return std::nullopt;
+        }
+
+        const auto hashes_count = static_cast<std::uint32_t>(LoadLe(header + 8, 4));
+        const auto words_count = LoadLe(header + 12, 8);
+        std::error_code ec{};
+        if (hashes_count == 0 || words_count == 0
+            || std::filesystem::file_size(path, ec) != bloom::header_size_k + words_count * 8 || ec) {
+            return std::nullopt;
+        }
+
+        std::string data(static_cast<std::size_t>(words_count * 8), '\0');
+        if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+            return std::nullopt;
+        }
+
+        BloomFilter filter(data.size(), hashes_count);
+        for (std::size_t i = 0; i < filter.m_words.size(); ++i) {
+            filter.m_words[i] = LoadLe(data.data() + i * 8, 8);
+        }
+
+        return filter;
+    }
+
+    /**
+     * Save the filter to the sidecar.
+     * @param path - path to the filter file
+     * @return - true if the filter has been saved successfully, else false
+     */
+    bool Save(const std::filesystem::path &path) const {
+        std::string data(bloom::magic_k);
+        data.reserve(bloom::header_size_k + m_words.size() * 8);
+        AppendLe(data, m_hashes_count, 4);
+        AppendLe(data, m_words.size(), 8);
+        for (const auto word : m_words) {
+            AppendLe(data, word, 8);
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(file.flush());
+    }
+
+    /**
+     * @param hash - hash of the value (see BloomHash())
+     */
+    void Add(std::uint64_t hash) {
+        const auto bits_count = m_words.size() * 64;
+        const auto h2 = (hash >> 32) | 1;
+        for (std::uint32_t i = 0; i < m_hashes_count; ++i, hash += h2) {
+            const auto bit = hash % bits_count;
+            m_words[bit / 64] |= std::uint64_t{1} << (bit % 64);
+        }
+    }
+
+    /**
+     * @param hash - hash of the value (see BloomHash())
+     * @return - false if the value has not been added for sure
+     */
+    [[nodiscard]]
+    bool MayContain(std::uint64_t hash) const {
+        const auto bits_count = m_words.size() * 64;
+        const auto h2 = (hash >> 32) | 1;
+        for (std::uint32_t i = 0; i < m_hashes_count; ++i, hash += h2) {
+            const auto bit = hash % bits_count;
+            if (!(m_words[bit / 64] & (std::uint64_t{1} << (bit % 64)))) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Add the values of another filter of the same size.
+     * @param other - filter
+     * @return - false if the filters have different sizes
+     */
+    bool Merge(const BloomFilter &other) {
+        if (other.m_words.size() != m_words.size() || other.m_hashes_count != m_hashes_count) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < m_words.size(); ++i) {
+            m_words[i] |= other.m_words[i];
+        }
+
+        return true;
+    }
+
+    void Clear() {
+        std::fill(m_words.begin(), m_words.end(), 0);
+    }
+
+private:
+    std::uint32_t m_hashes_count;
+
+    std::vector<std::uint64_t> m_words;
+};
+
+} // end of scl::detail
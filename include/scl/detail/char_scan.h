@@ -0,0 +1,136 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the masked scan of a text for the special characters: the control characters (0x00-0x1f)
+ * and two extra characters (eg '"' and '\\' of the JSON strings, see json_format.h and sanitize.h).
+ * The text is scanned by 32 (AVX2) or 16 (SSE2) bytes at once, so a clean text is passed by a few comparisons.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace scl::detail {
+
+/**
+ * @param ch - character
+ * @param first - first extra character
+ * @param second - second extra character
+ * @return - true if the character is a control character (0x00-0x1f) or one of the extra characters
+ */
+inline constexpr bool IsSpecialChar(unsigned char ch, char first, char second) {
+    return ch < 0x20 || ch == static_cast<unsigned char>(first) || ch == static_cast<unsigned char>(second);
+}
+
+#if defined(__AVX2__)
+/**
+ * Scan the text by 32 bytes for the special characters (see IsSpecialChar()).
+ * @param data - text data
+ * @param size - text size
+ * @param pos - position to start from, it is set to the position of the unscanned tail
+ * @param first - first extra character
+ * @param second - second extra character
+ * @return - true if a special character is found at the pos
+ */
+inline bool ScanSpecialChars32(const char *data, std::size_t size, std::size_t &pos, char first, char second) {
+    const __m256i first_chars = _mm256_set1_epi8(first);
+    const __m256i second_chars = _mm256_set1_epi8(second);
+    const __m256i control_max = _mm256_set1_epi8(0x1f);
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+        // ch <= 0x1f if max(ch, 0x1f) == 0x1f (unsigned)
+        const __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, first_chars), _mm256_cmpeq_epi8(chunk, second_chars)),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control_max), control_max));
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(special));
+        if (mask != 0) {
+            pos += static_cast<std::size_t>(__builtin_ctz(mask));
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+/**
+ * Scan the text by 16 bytes for the special characters (see IsSpecialChar()).
+ * @param data - text data
+ * @param size - text size
+ * @param pos - position to start from, it is set to the position of the unscanned tail
+ * @param first - first extra character
+ * @param second - second extra character
+ * @return - true if a special character is found at the pos
+ */
+inline bool ScanSpecialChars16(const char *data, std::size_t size, std::size_t &pos, char first, char second) {
+    const __m128i first_chars = _mm_set1_epi8(first);
+    const __m128i second_chars = _mm_set1_epi8(second);
+    const __m128i control_max = _mm_set1_epi8(0x1f);
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+        // ch <= 0x1f if max(ch, 0x1f) == 0x1f (unsigned)
+        const __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, first_chars), _mm_cmpeq_epi8(chunk, second_chars)),
+            _mm_cmpeq_epi8(_mm_max_epu8(chunk, control_max), control_max));
+        const auto mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+        if (mask != 0) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            pos += index;
+#else
+            pos += static_cast<std::size_t>(__builtin_ctz(mask));
+#endif
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif
+
+/**
+ * Find the first special character (see IsSpecialChar()).
+ * @param data - text data
+ * @param size - text size
+ * @param first - first extra character
+ * @param second - second extra character
+ * @return - index of the character or the size if there is no such character
+ */
+inline std::size_t FindSpecialChar(const char *data, std::size_t size, char first, char second) {
+    std::size_t pos = 0;
+
+#if defined(__AVX2__)
+    if (ScanSpecialChars32(data, size, pos, first, second)) {
+        return pos;
+    }
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+    if (ScanSpecialChars16(data, size, pos, first, second)) {
+        return pos;
+    }
+#endif
+
+    for (; pos < size; ++pos) {
+        if (IsSpecialChar(static_cast<unsigned char>(data[pos]), first, second)) {
+            return pos;
+        }
+    }
+
+    return size;
+}
+
+} // end of scl::detail
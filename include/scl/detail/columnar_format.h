@@ -0,0 +1,133 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the layout of the columnar segments (see ColumnarRecorder and ColumnarReader).
+ * All the integers are little-endian.
+ *
+ * segment:    "SCLCOLS1" block...
+ * block:      header column_entry[columns_count] column_data...
+ * header:     u32 magic, u32 records_count, u64 data_size (size of the column data),
+ *             i64 min_time, i64 max_time, u8 min_level, u8 max_level, u8 columns_count
+ * column:     u8 key (see RecordKey), u8 type (see ColumnType), u64 offset (within the column data), u64 size
+ *
+ * Every column data starts with the presence bitmap: bit i is set if the record i has the field.
+ * ColumnType::Integer:    bitmap, i64 base, u8 width, width-byte (value - base) per record
+ * ColumnType::Dictionary: bitmap, u8 width, u32 dictionary_size, u32 offsets[dictionary_size + 1], bytes,
+ *                         width-byte dictionary id per record
+ * ColumnType::Plain:      bitmap, u32 offsets[records_count + 1], bytes
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace scl::detail {
+
+namespace columnar {
+constexpr std::string_view segment_magic_k = "SCLCOLS1";
+constexpr std::uint32_t block_magic_k = 0x424c4353;
+constexpr std::size_t block_header_size_k = 4 + 4 + 8 + 8 + 8 + 1 + 1 + 1;
+constexpr std::size_t column_entry_size_k = 1 + 1 + 8 + 8;
+
+/**
+ * Max count of the column keys (equal to MsgPackRecord::max_keys_k).
+ */
+constexpr std::size_t max_columns_k = 16;
+
+/**
+ * Level statistics of a block without the levels.
+ */
+constexpr std::uint8_t no_level_k = 0xff;
+} // end of columnar
+
+/**
+ * Encoding of a column.
+ */
+enum class ColumnType : std::uint8_t {
+    None = 0,
+
+    /**
+     * Frame of reference integers: the min value and the fixed-width differences.
+     */
+    Integer,
+
+    /**
+     * Dictionary of the distinct strings and the fixed-width ids of the records.
+     */
+    Dictionary,
+
+    /**
+     * Concatenated strings and their offsets.
+     */
+    Plain,
+};
+
+/**
+ * Append a little-endian value.
+ * @param dst - destination string
+ * @param value - value
+ * @param size - count of the value bytes
+ */
+inline void AppendLe(std::string &dst, std::uint64_t value, std::size_t size) {
+    char buffer[8];
+    for (std::size_t i = 0; i < size; ++i) {
+        buffer[i] = static_cast<char>(value >> (8 * i));
+    }
+
+    dst.append(buffer, size);
+}
+
+/**
+ * Load a little-endian value.
+ * @param data - data of the size bytes
+ * @param size - count of the value bytes
+ * @return - value
+ */
+inline std::uint64_t LoadLe(const char *data, std::size_t size) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+
+    return value;
+}
+
+/**
+ * @param max_value - max stored value
+ * @return - min count of bytes (1, 2, 4 or 8) that keeps the value
+ */
+inline std::size_t IntegerWidth(std::uint64_t max_value) {
+    if (max_value <= std::numeric_limits<std::uint8_t>::max()) {
+        return 1;
+    }
+
+    if (max_value <= std::numeric_limits<std::uint16_t>::max()) {
+        return 2;
+    }
+
+    if (max_value <= std::numeric_limits<std::uint32_t>::max()) {
+        return 4;
+    }
+
+    return 8;
+}
+
+/**
+ * @param records_count - count of the records
+ * @return - size of the presence bitmap
+ */
+inline constexpr std::size_t BitmapSize(std::size_t records_count) {
+    return (records_count + 7) / 8;
+}
+
+} // end of scl::detail
@@ -0,0 +1,169 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the non-blocking connected datagram socket (UDP or Unix domain)
+ * that sends a batch of datagrams by a single sendmmsg() where it is available.
+ */
+
+#pragma once
+
+#include <scl/detail/unix_socket.h>
+
+#ifdef SCL_HAS_UNIX_SOCKET
+
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace scl::detail {
+
+/**
+ * Non-blocking connected datagram socket.
+ */
+class DatagramSocket {
+public:
+    DatagramSocket() = default;
+
+    DatagramSocket(const DatagramSocket &) = delete;
+
+    DatagramSocket &operator=(const DatagramSocket &) = delete;
+
+    ~DatagramSocket() {
+        Close();
+    }
+
+    /**
+     * Connect the UDP socket.
+     * @param host - host name or address
+     * @param port - port
+     * @return - true if the address is resolved and the socket is connected
+     */
+    bool ConnectUdp(const std::string &host, std::uint16_t port) {
+        Close();
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_DGRAM;
+
+        addrinfo *addresses = nullptr;
+        if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+            return false;
+        }
+
+        for (auto *address = addresses; address != nullptr; address = address->ai_next) {
+            if (Open(address->ai_family) && ::connect(m_fd, address->ai_addr, address->ai_addrlen) == 0) {
+                break;
+            }
+
+            Close();
+        }
+
+        ::freeaddrinfo(addresses);
+        return IsOpen();
+    }
+
+    /**
+     * Connect the Unix domain datagram socket.
+     * @param path - socket path, must be correct (see IsUnixSocketPathCorrect())
+     * @return - true if the socket is connected
+     */
+    bool ConnectUnix(const std::string &path) {
+        Close();
+
+        const auto address = MakeUnixSocketAddress(path);
+        if (!Open(AF_UNIX) || ::connect(m_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Send the datagrams without blocking.
+     * @param datagrams - datagrams, one buffer per datagram
+     * @return - count of the sent datagrams (the datagrams are sent in order) or -1 if no datagram is sent
+     *           (errno is set, EAGAIN if the socket buffer is full)
+     */
+    int Send(const std::vector<iovec> &datagrams) {
+#ifdef __linux__
+        m_messages.resize(datagrams.size());
+        for (std::size_t i = 0; i < datagrams.size(); ++i) {
+            m_messages[i] = mmsghdr{};
+            m_messages[i].msg_hdr.msg_iov = const_cast<iovec *>(&datagrams[i]);
+            m_messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int sent;
+        do {
+            sent = ::sendmmsg(m_fd, m_messages.data(), static_cast<unsigned>(m_messages.size()),
+                              MSG_DONTWAIT | MSG_NOSIGNAL);
+        } while (sent < 0 && errno == EINTR);
+
+        return sent;
+#else
+        int sent = 0;
+        for (const auto &datagram : datagrams) {
+            ssize_t result;
+            do {
+                result = ::send(m_fd, datagram.iov_base, datagram.iov_len, MSG_DONTWAIT | MSG_NOSIGNAL);
+            } while (result < 0 && errno == EINTR);
+
+            if (result < 0) {
+                return sent == 0 ? -1 : sent;
+            }
+
+            ++sent;
+        }
+
+        return sent;
+#endif
+    }
+
+    void Close() {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    [[nodiscard]]
+    inline bool IsOpen() const {
+        return m_fd >= 0;
+    }
+
+private:
+    bool Open(int family) {
+        m_fd = ::socket(family, SOCK_DGRAM, 0);
+        if (m_fd < 0) {
+            return false;
+        }
+
+        ::fcntl(m_fd, F_SETFD, FD_CLOEXEC);
+        ::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+        return true;
+    }
+
+    int m_fd = -1;
+
+#ifdef __linux__
+    std::vector<mmsghdr> m_messages;
+#endif
+};
+
+} // end of scl::detail
+
+#endif
@@ -61,6 +61,11 @@ const auto pid_length_k = NumberTrait<ProcessId>::max_digits_count;
 
 // The longest level name is "Unknown"
 const auto level_length_k = 7;
+
+// the sequence number token is "#<number>" (see IRecord::Sequence()),
+// the aligned token is widened instead of the truncation if the number is longer
+const char sequence_mark_k = '#';
+const auto sequence_length_k = 12;
 } // end of log_formatting
 
 } // end of scl::detail
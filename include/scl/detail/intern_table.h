@@ -0,0 +1,191 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace scl::detail {
+
+/**
+ * Insert-only table that maps the strings to the sequential ids (0, 1, ...) without locks.
+ * The table is an open addressing hash table of the node pointers:
+ * a new string is inserted by a CAS of an empty slot and gets the next id after the insertion,
+ * so the ids have no gaps. The strings are never removed, so the returned views are valid until the table is destroyed.
+ * The count of the strings is limited, Intern() returns std::nullopt if the table is full.
+ */
+class InternTable {
+public:
+    /**
+     * @param capacity - max count of the strings
+     */
+    explicit InternTable(std::size_t capacity)
+        : m_capacity(capacity),
+          m_mask(SlotsCount(capacity) - 1),
+          m_slots(new std::atomic<Node *>[m_mask + 1]),
+          m_nodes(new std::atomic<Node *>[capacity]) {
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            m_slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        for (std::size_t i = 0; i < capacity; ++i) {
+            m_nodes[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    InternTable(const InternTable &) = delete;
+
+    InternTable &operator=(const InternTable &) = delete;
+
+    ~InternTable() {
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            delete m_slots[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Get the id of the string, the string is inserted if it is not found.
+     * @param str - string
+     * @return - id of the string or std::nullopt if the table is full
+     */
+    std::optional<std::uint32_t> Intern(std::string_view str) {
+        const auto hash = std::hash<std::string_view>{}(str);
+        std::unique_ptr<Node> new_node;
+
+        for (std::size_t i = 0, index = hash & m_mask; i <= m_mask; ++i, index = (index + 1) & m_mask) {
+            Node *node = m_slots[index].load(std::memory_order_acquire);
+            if (node == nullptr) {
+                if (m_size.load(std::memory_order_relaxed) >= m_capacity) {
+                    return std::nullopt;
+                }
+
+                if (!new_node) {
+                    new_node.reset(new Node{hash, std::string(str), {pending_id_k}});
+                }
+
+                if (m_slots[index].compare_exchange_strong(node, new_node.get(), std::memory_order_acq_rel)) {
+                    return Publish(new_node.release());
+                }
+
+                // the slot is taken by another thread, the node is checked below
+            }
+
+            if (node->hash == hash && node->value == str) {
+                return WaitForId(*node);
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * @param id - id returned by Intern() or any id below it
+     * @return - interned string
+     */
+    [[nodiscard]]
+    std::string_view Value(std::uint32_t id) const {
+        // a lower id may be assigned to the node of another thread that is not published yet
+        // (the window is a few instructions long)
+        Node *node = m_nodes[id].load(std::memory_order_acquire);
+        while (node == nullptr) {
+            std::this_thread::yield();
+            node = m_nodes[id].load(std::memory_order_acquire);
+        }
+
+        return node->value;
+    }
+
+    /**
+     * @return - count of the interned strings
+     */
+    [[nodiscard]]
+    inline std::size_t Size() const {
+        return std::min(m_size.load(std::memory_order_acquire), m_capacity);
+    }
+
+private:
+    static constexpr std::uint32_t pending_id_k = ~std::uint32_t{0} - 1;
+    static constexpr std::uint32_t overflow_id_k = ~std::uint32_t{0};
+
+    struct Node {
+        std::size_t hash;
+        std::string value;
+        std::atomic<std::uint32_t> id;
+    };
+
+    /**
+     * @return - power of two count of the slots that keeps the load factor below 1/2
+     */
+    static inline std::size_t SlotsCount(std::size_t capacity) {
+        std::size_t count = 16;
+        while (count < 2 * capacity) {
+            count *= 2;
+        }
+
+        return count;
+    }
+
+    /**
+     * Assign the next id to the inserted node.
+     */
+    std::optional<std::uint32_t> Publish(Node *node) {
+        const auto id = m_size.fetch_add(1, std::memory_order_acq_rel);
+        if (id >= m_capacity) {
+            // the concurrent insertions overflowed the table, the node stays without an id
+            node->id.store(overflow_id_k, std::memory_order_release);
+            return std::nullopt;
+        }
+
+        m_nodes[id].store(node, std::memory_order_release);
+        node->id.store(static_cast<std::uint32_t>(id), std::memory_order_release);
+        return static_cast<std::uint32_t>(id);
+    }
+
+    /**
+     * Wait until the node inserted by another thread gets its id (the window is a few instructions long).
+     */
+    static std::optional<std::uint32_t> WaitForId(const Node &node) {
+        auto id = node.id.load(std::memory_order_acquire);
+        while (id == pending_id_k) {
+            std::this_thread::yield();
+            id = node.id.load(std::memory_order_acquire);
+        }
+
+        if (id == overflow_id_k) {
+            return std::nullopt;
+        }
+
+        return id;
+    }
+
+    std::size_t m_capacity;
+
+    std::size_t m_mask;
+
+    std::unique_ptr<std::atomic<Node *>[]> m_slots;
+
+    /**
+     * Nodes by their ids.
+     */
+    std::unique_ptr<std::atomic<Node *>[]> m_nodes;
+
+    /**
+     * Count of the assigned ids (it may exceed the capacity on the overflow).
+     */
+    std::atomic<std::size_t> m_size{0};
+};
+
+} // end of scl::detail
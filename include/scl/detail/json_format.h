@@ -0,0 +1,120 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the functions that write the JSON Lines records:
+ *   {"key":"escaped string","key":123}
+ * The strings are scanned for the characters that must be escaped ('"', '\\' and the control characters)
+ * by 32 (AVX2) or 16 (SSE2) bytes at once (see char_scan.h),
+ * so a string without such characters is appended by a single copy.
+ * Note the strings are not validated as UTF-8.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <scl/detail/char_scan.h>
+#include <scl/detail/record_format.h>
+
+namespace scl::detail {
+
+/**
+ * @param ch - character
+ * @return - true if the character must be escaped within a JSON string
+ */
+inline constexpr bool IsJsonSpecial(unsigned char ch) {
+    return IsSpecialChar(ch, '"', '\\');
+}
+
+/**
+ * Find the first character that must be escaped (see IsJsonSpecial()).
+ * @param data - string data
+ * @param size - string size
+ * @return - index of the character or the size if there is no such character
+ */
+inline std::size_t FindJsonSpecial(const char *data, std::size_t size) {
+    return FindSpecialChar(data, size, '"', '\\');
+}
+
+/**
+ * Append the escaped character.
+ * @param dst - destination string
+ * @param ch - character that must be escaped (see IsJsonSpecial())
+ */
+inline void AppendJsonEscape(std::string &dst, unsigned char ch) {
+    switch (ch) {
+        case '"':
+            dst += "\\\"";
+            return;
+        case '\\':
+            dst += "\\\\";
+            return;
+        case '\b':
+            dst += "\\b";
+            return;
+        case '\f':
+            dst += "\\f";
+            return;
+        case '\n':
+            dst += "\\n";
+            return;
+        case '\r':
+            dst += "\\r";
+            return;
+        case '\t':
+            dst += "\\t";
+            return;
+        default: {
+            constexpr char hex_k[] = "0123456789abcdef";
+            const char escape[] = {'\\', 'u', '0', '0', hex_k[ch >> 4], hex_k[ch & 0xf]};
+            dst.append(escape, sizeof(escape));
+        }
+    }
+}
+
+/**
+ * Append the quoted and escaped JSON string.
+ * @param dst - destination string
+ * @param str - string
+ */
+inline void AppendJsonString(std::string &dst, std::string_view str) {
+    dst += '"';
+
+    const char *data = str.data();
+    std::size_t size = str.size();
+    while (true) {
+        const auto clean_size = FindJsonSpecial(data, size);
+        dst.append(data, clean_size);
+        if (clean_size == size) {
+            break;
+        }
+
+        AppendJsonEscape(dst, static_cast<unsigned char>(data[clean_size]));
+        data += clean_size + 1;
+        size -= clean_size + 1;
+    }
+
+    dst += '"';
+}
+
+/**
+ * Append the integer JSON value.
+ * @param dst - destination string
+ * @param value - value
+ */
+template<typename T>
+inline void AppendJsonInteger(std::string &dst, T value) {
+    char buffer[24];
+    dst += IntegerToChars(buffer, value);
+}
+
+} // end of scl::detail
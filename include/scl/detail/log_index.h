@@ -0,0 +1,269 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the sparse index of the text log files (see FileRecorder::Options::index and LogIndexReader).
+ * The index of a log file is kept in the "<log file>.idx" sidecar, all the integers are little-endian.
+ *
+ * index:      "SCLIDX01" entry...
+ * entry:      i64 time (see TimeStrToSeconds()), u64 sequence (number of the record within the log file),
+ *             u64 offset (offset of the record within the log file)
+ *
+ * An entry is appended every records_interval records or bytes_interval bytes,
+ * so the index takes a few bytes per thousands of records and its writing costs nothing in average.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include <scl/detail/columnar_format.h>
+#include <scl/detail/misc.h>
+#include <scl/detail/record_fields.h>
+
+namespace scl::detail {
+
+namespace log_index {
+constexpr std::string_view magic_k = "SCLIDX01";
+constexpr std::string_view extension_k = ".idx";
+constexpr std::size_t entry_size_k = 8 + 8 + 8;
+} // end of log_index
+
+/**
+ * Index entry: position of a record within the log file.
+ */
+struct LogIndexEntry {
+    /**
+     * Time of the record (see TimeStrToSeconds()).
+     */
+    std::int64_t time;
+
+    /**
+     * Number of the record within the log file (starts with 0).
+     */
+    std::uint64_t sequence;
+
+    /**
+     * Offset of the record within the log file.
+     */
+    std::uint64_t offset;
+};
+
+/**
+ * @param log_path - path to a log file
+ * @return - path to the index sidecar of the log file
+ */
+inline std::filesystem::path LogIndexPath(const std::filesystem::path &log_path) {
+    auto index_path = log_path;
+    index_path += log_index::extension_k;
+    return index_path;
+}
+
+/**
+ * Load the index entry.
+ * @param data - data of the log_index::entry_size_k bytes
+ * @return - index entry
+ */
+inline LogIndexEntry LoadLogIndexEntry(const char *data) {
+    return {static_cast<std::int64_t>(LoadLe(data, 8)), LoadLe(data + 8, 8), LoadLe(data + 16, 8)};
+}
+
+/**
+ * @param record - record
+ * @return - time of the record or the current time if the record has no time (see TimeStrToSeconds())
+ */
+template<typename RecordT>
+std::int64_t RecordTimeSeconds(const RecordT &record) {
+    if constexpr (HasTimeStr<RecordT>::value) {
+        if (const auto seconds = TimeStrToSeconds(record.time_str)) {
+            return *seconds;
+        }
+    }
+
+    return TimeStrToSeconds(CurTimeStrView()).value_or(0);
+}
+
+/**
+ * Writer of the index sidecar of the opened log file.
+ * Note the writer is not synchronized, it is called under the lock of the recorder.
+ */
+class LogIndexWriter {
+public:
+    /**
+     * @param records_interval - max count of the records between the index entries
+     * @param bytes_interval - max count of the bytes between the index entries
+     */
+    LogIndexWriter(std::size_t records_interval, std::size_t bytes_interval)
+        : m_records_interval(records_interval),
+          m_bytes_interval(bytes_interval) {
+    }
+
+    /**
+     * Open the index of the log file, the method is called after the log file is opened.
+     * If the log file is not empty, the sequence numbers continue the existing index:
+     * the records after its last entry are counted.
+     * @param log_path - path to the log file
+     * @return - true if the index has been opened successfully, else false
+     */
+    bool Open(const std::filesystem::path &log_path) {
+        namespace fs = std::filesystem;
+
+        m_index_file.close();
+        m_is_entry_due = true;
+        m_records_since_entry = 0;
+        m_bytes_since_entry = 0;
+
+        std::error_code ec{};
+        const auto log_size = fs::file_size(log_path, ec);
+        m_offset = ec ? 0 : log_size;
+
+        const auto index_path = LogIndexPath(log_path);
+        auto index_size = fs::file_size(index_path, ec);
+        if (ec || index_size < log_index::magic_k.size()) {
+            index_size = 0;
+        }
+
+        // the partial entry of an interrupted write is dropped
+        const auto entries_count = index_size == 0 ? 0 : (index_size - log_index::magic_k.size()) / log_index::entry_size_k;
+        const auto aligned_size = index_size == 0 ? 0 : log_index::magic_k.size() + entries_count * log_index::entry_size_k;
+
+        LogIndexEntry last_entry{0, 0, 0};
+        if (entries_count != 0) {
+            std::ifstream index_file(index_path, std::ios::binary);
+            char buffer[log_index::entry_size_k];
+            index_file.seekg(static_cast<std::streamoff>(aligned_size - log_index::entry_size_k));
+            if (index_file.read(buffer, sizeof(buffer))) {
+                last_entry = LoadLogIndexEntry(buffer);
+            }
+        }
+
+        std::size_t kept_size = aligned_size;
+        if (last_entry.offset > m_offset) {
+            // the index belongs to another log file that had the same path, start it again
+            kept_size = 0;
+            last_entry = {0, 0, 0};
+        }
+
+        if (kept_size != fs::file_size(index_path, ec) || ec) {
+            fs::resize_file(index_path, kept_size, ec);
+        }
+
+        m_sequence = last_entry.sequence + CountRecords(log_path, last_entry.offset);
+
+        m_index_file.open(index_path, std::ios::app | std::ios::binary);
+        if (!m_index_file.is_open()) {
+            return false;
+        }
+
+        if (kept_size == 0) {
+            m_index_file.write(log_index::magic_k.data(), static_cast<std::streamsize>(log_index::magic_k.size()));
+            m_index_file.flush();
+        }
+
+        return true;
+    }
+
+    /**
+     * @return - true if the next record must be indexed
+     */
+    [[nodiscard]]
+    inline bool IsEntryDue() const {
+        return m_is_entry_due
+               || m_records_since_entry >= m_records_interval
+               || m_bytes_since_entry >= m_bytes_interval;
+    }
+
+    /**
+     * Append the entry of the next record.
+     * @param time - time of the next record
+     */
+    void AddEntry(std::int64_t time) {
+        m_is_entry_due = false;
+        m_records_since_entry = 0;
+        m_bytes_since_entry = 0;
+
+        if (!m_index_file.is_open()) {
+            return;
+        }
+
+        std::string entry;
+        entry.reserve(log_index::entry_size_k);
+        AppendLe(entry, static_cast<std::uint64_t>(time), 8);
+        AppendLe(entry, m_sequence, 8);
+        AppendLe(entry, m_offset, 8);
+
+        m_index_file.write(entry.data(), static_cast<std::streamsize>(entry.size()));
+        m_index_file.flush();
+    }
+
+    /**
+     * Move the position to the next record.
+     * @param size - size of the written record
+     */
+    inline void OnWritten(std::size_t size) {
+        m_offset += size;
+        ++m_sequence;
+        ++m_records_since_entry;
+        m_bytes_since_entry += size;
+    }
+
+private:
+    /**
+     * @param log_path - path to a log file
+     * @param offset - offset of a record within the log file
+     * @return - count of the records (lines) from the offset to the end of the log file
+     */
+    static std::uint64_t CountRecords(const std::filesystem::path &log_path, std::uint64_t offset) {
+        std::ifstream log_file(log_path, std::ios::binary);
+        if (!log_file.is_open()) {
+            return 0;
+        }
+
+        log_file.seekg(static_cast<std::streamoff>(offset));
+
+        std::uint64_t count = 0;
+        char buffer[64 * 1024];
+        while (log_file.read(buffer, sizeof(buffer)) || log_file.gcount() > 0) {
+            count += static_cast<std::uint64_t>(std::count(buffer, buffer + log_file.gcount(), '\n'));
+        }
+
+        return count;
+    }
+
+    std::size_t m_records_interval;
+
+    std::size_t m_bytes_interval;
+
+    std::ofstream m_index_file;
+
+    /**
+     * Offset of the next record within the log file.
+     */
+    std::uint64_t m_offset = 0;
+
+    /**
+     * Number of the next record within the log file.
+     */
+    std::uint64_t m_sequence = 0;
+
+    /**
+     * The first record after the opening is always indexed.
+     */
+    bool m_is_entry_due = true;
+
+    std::size_t m_records_since_entry = 0;
+
+    std::size_t m_bytes_since_entry = 0;
+};
+
+} // end of scl::detail
@@ -0,0 +1,110 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#define SCL_HAS_MAPPED_FILE
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace scl::detail {
+
+/**
+ * Read-only memory mapping of a whole file.
+ * The mapping is a snapshot of the file size at the opening: the data appended later is not visible.
+ */
+class MappedFile {
+public:
+    /**
+     * Map the file.
+     * @param path - path to the file
+     * @return - pointer to the mapped file or nullptr if the file couldn't be opened or mapped
+     */
+    static std::unique_ptr<MappedFile> Open(const std::filesystem::path &path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        struct stat file_stat{};
+        if (::fstat(fd, &file_stat) != 0) {
+            ::close(fd);
+            return nullptr;
+        }
+
+        std::unique_ptr<MappedFile> file(new MappedFile());
+        const auto size = static_cast<std::size_t>(file_stat.st_size);
+        if (size != 0) {
+            // an empty file cannot be mapped, its data is an empty view
+            void *data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                return nullptr;
+            }
+
+            file->m_data = static_cast<const char *>(data);
+            file->m_size = size;
+        }
+
+        ::close(fd);
+        return file;
+    }
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+        if (m_data) {
+            ::munmap(const_cast<char *>(m_data), m_size);
+        }
+    }
+
+    /**
+     * Advise the kernel that the region is going to be read sequentially, so it is read ahead.
+     * @param offset - offset of the region
+     */
+    void AdviseSequential(std::size_t offset) const {
+        if (!m_data || offset >= m_size) {
+            return;
+        }
+
+        // the advised address must be page aligned
+        const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const auto aligned_offset = offset - offset % page_size;
+        ::madvise(const_cast<char *>(m_data) + aligned_offset, m_size - aligned_offset, MADV_SEQUENTIAL);
+    }
+
+    /**
+     * @return - data of the file
+     */
+    [[nodiscard]]
+    inline std::string_view Data() const {
+        return {m_data, m_size};
+    }
+
+private:
+    MappedFile() = default;
+
+    const char *m_data = nullptr;
+
+    std::size_t m_size = 0;
+};
+
+} // end of scl::detail
+
+#endif
@@ -8,7 +8,14 @@
 
 #pragma once
 
+#include <charconv>
+#include <cstdint>
 #include <ctime>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
 #include <scl/detail/format_defines.h>
 
 namespace scl {
@@ -32,4 +39,131 @@ inline std::string CurTimeStr() {
     return {mbstr};
 }
 
+/**
+ * Get current time as string in the CurTimeStr() format without allocation.
+ * The string is cached by the calling thread and is refreshed once per second.
+ * @return - view of the thread local buffer, valid until the next call on the same thread
+ */
+inline std::string_view CurTimeStrView() {
+    thread_local std::time_t cached_time = -1;
+    // len(buffer) = len(expected characters count) + '\0'
+    thread_local char buffer[detail::log_formatting::time_length_k + 1] = {0};
+    thread_local std::size_t size = 0;
+
+    const std::time_t t = std::time(nullptr);
+    if (t != cached_time) {
+        size = std::strftime(buffer, sizeof(buffer), detail::log_formatting::time_format_k, std::localtime(&t));
+        cached_time = t;
+    }
+
+    return {buffer, size};
+}
+
+/**
+ * Convert a time string in the CurTimeStr() format to the count of seconds
+ * since 1970-01-01-00-00-00 of the same clock (the time zone of the string is kept, it is not converted to UTC).
+ * @param time_str - time string
+ * @return - count of seconds or std::nullopt if the string has another format
+ */
+inline std::optional<std::int64_t> TimeStrToSeconds(std::string_view time_str) {
+    // %Y-%m-%d-%H-%M-%S
+    if (time_str.size() != detail::log_formatting::time_length_k) {
+        return std::nullopt;
+    }
+
+    const auto number = [&time_str](std::size_t pos, std::size_t length) -> std::int64_t {
+        std::int64_t value = 0;
+        for (std::size_t i = pos; i < pos + length; ++i) {
+            if (time_str[i] < '0' || time_str[i] > '9') {
+                return -1;
+            }
+
+            value = value * 10 + (time_str[i] - '0');
+        }
+
+        return value;
+    };
+
+    for (const std::size_t pos : {4, 7, 10, 13, 16}) {
+        if (time_str[pos] != '-') {
+            return std::nullopt;
+        }
+    }
+
+    const auto year = number(0, 4);
+    const auto month = number(5, 2);
+    const auto day = number(8, 2);
+    const auto hour = number(11, 2);
+    const auto minute = number(14, 2);
+    const auto second = number(17, 2);
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31
+        || hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return std::nullopt;
+    }
+
+    // days from the civil date (the year starts from March to put the leap day to the end)
+    const auto shifted_year = month <= 2 ? year - 1 : year;
+    const auto era = shifted_year / 400;
+    const auto year_of_era = shifted_year - era * 400;
+    const auto day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const auto day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    const auto days = era * 146097 + day_of_era - 719468;
+
+    return days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+/**
+ * Convert a count of seconds (see TimeStrToSeconds()) to a time string in the CurTimeStr() format.
+ * @param seconds - count of seconds since 1970-01-01-00-00-00
+ * @return - time string
+ */
+inline std::string SecondsToTimeStr(std::int64_t seconds) {
+    auto days = seconds / 86400;
+    auto day_seconds = seconds % 86400;
+    if (day_seconds < 0) {
+        day_seconds += 86400;
+        --days;
+    }
+
+    // civil date from the days (the year starts from March)
+    days += 719468;
+    const auto era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto day_of_era = days - era * 146097;
+    const auto year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const auto day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const auto shifted_month = (5 * day_of_year + 2) / 153;
+    const auto day = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+    const auto month = shifted_month < 10 ? shifted_month + 3 : shifted_month - 9;
+    const auto year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+
+    std::tm tm{};
+    tm.tm_year = static_cast<int>(year - 1900);
+    tm.tm_mon = static_cast<int>(month - 1);
+    tm.tm_mday = static_cast<int>(day);
+    tm.tm_hour = static_cast<int>(day_seconds / 3600);
+    tm.tm_min = static_cast<int>(day_seconds % 3600 / 60);
+    tm.tm_sec = static_cast<int>(day_seconds % 60);
+
+    char buffer[detail::log_formatting::time_length_k + 1] = {0};
+    std::strftime(buffer, sizeof(buffer), detail::log_formatting::time_format_k, &tm);
+    return {buffer};
+}
+
+/**
+ * Parse the whole string as a decimal number (eg a command line argument).
+ * @tparam T - integer type
+ * @param str - string
+ * @return - number or std::nullopt if the string is not a number or the number doesn't fit the type
+ */
+template<typename T>
+inline std::optional<T> ParseNumber(std::string_view str) {
+    T value{};
+    const auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (str.empty() || result.ec != std::errc() || result.ptr != str.data() + str.size()) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
 }
@@ -0,0 +1,246 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the functions that write the MessagePack records (see RecordFormat::MessagePack):
+ * a record is a map of the small integer keys (see RecordKey) to the integer or string values.
+ * The integers take the shortest MessagePack representation (1 byte for the levels, protocols and small numbers).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include <scl/detail/misc.h>
+
+namespace scl::detail {
+
+namespace msgpack {
+constexpr unsigned char positive_fixint_max_k = 0x7f;
+constexpr unsigned char fixmap_k = 0x80;
+constexpr unsigned char fixstr_k = 0xa0;
+constexpr unsigned char nil_k = 0xc0;
+constexpr unsigned char uint8_k = 0xcc;
+constexpr unsigned char uint16_k = 0xcd;
+constexpr unsigned char uint32_k = 0xce;
+constexpr unsigned char uint64_k = 0xcf;
+constexpr unsigned char int8_k = 0xd0;
+constexpr unsigned char int16_k = 0xd1;
+constexpr unsigned char int32_k = 0xd2;
+constexpr unsigned char int64_k = 0xd3;
+constexpr unsigned char str8_k = 0xd9;
+constexpr unsigned char str16_k = 0xda;
+constexpr unsigned char str32_k = 0xdb;
+constexpr unsigned char map16_k = 0xde;
+constexpr unsigned char negative_fixint_k = 0xe0;
+constexpr unsigned char ext8_k = 0xc7;
+constexpr unsigned char ext16_k = 0xc8;
+constexpr unsigned char ext32_k = 0xc9;
+constexpr unsigned char fixext1_k = 0xd4;
+constexpr unsigned char fixext2_k = 0xd5;
+constexpr unsigned char fixext4_k = 0xd6;
+
+/**
+ * Extension type of an interned string field: fixext1/2/4 of the big-endian string id.
+ */
+constexpr unsigned char interned_ext_k = 1;
+
+/**
+ * Extension type of an interned string definition that is written between the records:
+ * ext8/16/32 of the big-endian u32 string id followed by the string bytes.
+ */
+constexpr unsigned char intern_definition_ext_k = 2;
+
+constexpr std::size_t fixmap_max_size_k = 15;
+constexpr std::size_t fixstr_max_size_k = 31;
+} // end of msgpack
+
+/**
+ * Append the big-endian value of the size bytes.
+ * @param dst - destination string
+ * @param type - MessagePack type byte
+ * @param value - value
+ * @param size - count of the value bytes
+ */
+inline void AppendMsgPackBigEndian(std::string &dst, unsigned char type, std::uint64_t value, std::size_t size) {
+    char buffer[9];
+    buffer[0] = static_cast<char>(type);
+    for (std::size_t i = 0; i < size; ++i) {
+        buffer[size - i] = static_cast<char>(value >> (8 * i));
+    }
+
+    dst.append(buffer, size + 1);
+}
+
+/**
+ * Append the unsigned integer in the shortest representation.
+ * @param dst - destination string
+ * @param value - value
+ */
+inline void AppendMsgPackUint(std::string &dst, std::uint64_t value) {
+    namespace Mp = msgpack;
+
+    if (value <= Mp::positive_fixint_max_k) {
+        dst += static_cast<char>(value);
+    } else if (value <= std::numeric_limits<std::uint8_t>::max()) {
+        AppendMsgPackBigEndian(dst, Mp::uint8_k, value, 1);
+    } else if (value <= std::numeric_limits<std::uint16_t>::max()) {
+        AppendMsgPackBigEndian(dst, Mp::uint16_k, value, 2);
+    } else if (value <= std::numeric_limits<std::uint32_t>::max()) {
+        AppendMsgPackBigEndian(dst, Mp::uint32_k, value, 4);
+    } else {
+        AppendMsgPackBigEndian(dst, Mp::uint64_k, value, 8);
+    }
+}
+
+/**
+ * Append the signed integer in the shortest representation.
+ * @param dst - destination string
+ * @param value - value
+ */
+inline void AppendMsgPackInt(std::string &dst, std::int64_t value) {
+    namespace Mp = msgpack;
+
+    if (value >= 0) {
+        AppendMsgPackUint(dst, static_cast<std::uint64_t>(value));
+        return;
+    }
+
+    const auto bits = static_cast<std::uint64_t>(value);
+    if (value >= -32) {
+        dst += static_cast<char>(bits);
+    } else if (value >= std::numeric_limits<std::int8_t>::min()) {
+        AppendMsgPackBigEndian(dst, Mp::int8_k, bits, 1);
+    } else if (value >= std::numeric_limits<std::int16_t>::min()) {
+        AppendMsgPackBigEndian(dst, Mp::int16_k, bits, 2);
+    } else if (value >= std::numeric_limits<std::int32_t>::min()) {
+        AppendMsgPackBigEndian(dst, Mp::int32_k, bits, 4);
+    } else {
+        AppendMsgPackBigEndian(dst, Mp::int64_k, bits, 8);
+    }
+}
+
+/**
+ * Append the string.
+ * @param dst - destination string
+ * @param str - string
+ */
+inline void AppendMsgPackStr(std::string &dst, std::string_view str) {
+    namespace Mp = msgpack;
+
+    if (str.size() <= Mp::fixstr_max_size_k) {
+        dst += static_cast<char>(Mp::fixstr_k | str.size());
+    } else if (str.size() <= std::numeric_limits<std::uint8_t>::max()) {
+        AppendMsgPackBigEndian(dst, Mp::str8_k, str.size(), 1);
+    } else if (str.size() <= std::numeric_limits<std::uint16_t>::max()) {
+        AppendMsgPackBigEndian(dst, Mp::str16_k, str.size(), 2);
+    } else {
+        AppendMsgPackBigEndian(dst, Mp::str32_k, str.size(), 4);
+    }
+
+    dst += str;
+}
+
+/**
+ * Append the map header, the header must be followed by the size key-value pairs.
+ * @param dst - destination string
+ * @param size - count of the key-value pairs
+ */
+inline void AppendMsgPackMap(std::string &dst, std::size_t size) {
+    namespace Mp = msgpack;
+
+    if (size <= Mp::fixmap_max_size_k) {
+        dst += static_cast<char>(Mp::fixmap_k | size);
+    } else {
+        AppendMsgPackBigEndian(dst, Mp::map16_k, size, 2);
+    }
+}
+
+/**
+ * Append the record key (see RecordKey).
+ * @param dst - destination string
+ * @param key - key of the record field
+ */
+template<typename KeyT>
+inline void AppendMsgPackKey(std::string &dst, KeyT key) {
+    AppendMsgPackUint(dst, static_cast<std::uint64_t>(key));
+}
+
+/**
+ * Append the reference to an interned string (see msgpack::interned_ext_k).
+ * @param dst - destination string
+ * @param id - id of the interned string
+ */
+inline void AppendMsgPackInternedId(std::string &dst, std::uint32_t id) {
+    namespace Mp = msgpack;
+
+    const auto type = id <= std::numeric_limits<std::uint8_t>::max() ? Mp::fixext1_k
+                      : id <= std::numeric_limits<std::uint16_t>::max() ? Mp::fixext2_k
+                      : Mp::fixext4_k;
+    dst += static_cast<char>(type);
+    AppendMsgPackBigEndian(dst, Mp::interned_ext_k, id, std::size_t{1} << (type - Mp::fixext1_k));
+}
+
+/**
+ * Append the definition of an interned string (see msgpack::intern_definition_ext_k).
+ * @param dst - destination string
+ * @param id - id of the interned string
+ * @param value - interned string
+ */
+inline void AppendMsgPackInternDefinition(std::string &dst, std::uint32_t id, std::string_view value) {
+    namespace Mp = msgpack;
+
+    const auto size = 4 + value.size();
+    if (size <= std::numeric_limits<std::uint8_t>::max()) {
+        AppendMsgPackBigEndian(dst, Mp::ext8_k, size, 1);
+    } else if (size <= std::numeric_limits<std::uint16_t>::max()) {
+        AppendMsgPackBigEndian(dst, Mp::ext16_k, size, 2);
+    } else {
+        AppendMsgPackBigEndian(dst, Mp::ext32_k, size, 4);
+    }
+
+    AppendMsgPackBigEndian(dst, Mp::intern_definition_ext_k, id, 4);
+    dst += value;
+}
+
+/**
+ * Writer of the MessagePack string fields that may repeat (eg the session id or the action, but not the message).
+ * The base writer writes the strings as is, a derived writer may replace them (eg by the ids, see MsgPackInterner).
+ */
+class MsgPackStrWriter {
+public:
+    virtual ~MsgPackStrWriter() = default;
+
+    /**
+     * Append a string field that may repeat.
+     * @param dst - destination string
+     * @param value - string value
+     */
+    virtual void AppendStr(std::string &dst, std::string_view value) {
+        AppendMsgPackStr(dst, value);
+    }
+};
+
+/**
+ * Append the time as the count of seconds (see TimeStrToSeconds())
+ * or as the string if the time string has an unexpected format.
+ * @param dst - destination string
+ * @param time_str - time string in the CurTimeStr() format
+ */
+inline void AppendMsgPackTime(std::string &dst, std::string_view time_str) {
+    if (const auto seconds = TimeStrToSeconds(time_str)) {
+        AppendMsgPackInt(dst, *seconds);
+    } else {
+        AppendMsgPackStr(dst, time_str);
+    }
+}
+
+} // end of scl::detail
@@ -0,0 +1,103 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <scl/detail/intern_table.h>
+#include <scl/detail/msgpack_format.h>
+
+namespace scl::detail {
+
+/**
+ * Interner of the MessagePack records that replaces the repeated string fields (session id, action, handler etc.)
+ * by the ids of an InternTable while the records are serialized (see Writer). The message is never interned.
+ * A segment (eg a log file) contains the definition of an id before the first record that refers to it,
+ * so the interned strings are written once per segment. The ids are defined in order without gaps
+ * (the reader rejects an id beyond its dictionary), so a record may be preceded by the definitions of the lower ids too.
+ *
+ * The Writer is used by the producers without locks,
+ * AppendDefinitions() and ResetDefinitions() are called by the writer under its lock.
+ */
+class MsgPackInterner {
+public:
+    /**
+     * Writer of the string fields that replaces the strings by the interned ids (see IRecord::AppendMsgPack()).
+     */
+    class Writer final : public MsgPackStrWriter {
+    public:
+        /**
+         * @param interner - interner
+         * @param ids - ids of the interned fields of the record are appended to it
+         */
+        explicit Writer(MsgPackInterner &interner, std::vector<std::uint32_t> &ids)
+            : m_interner(interner),
+              m_ids(ids) {
+        }
+
+        /**
+         * @overload
+         * Note the string is written as is if the table is full
+         */
+        void AppendStr(std::string &dst, std::string_view value) final {
+            const auto id = m_interner.m_table.Intern(value);
+            if (id) {
+                AppendMsgPackInternedId(dst, *id);
+                m_ids.push_back(*id);
+            } else {
+                AppendMsgPackStr(dst, value);
+            }
+        }
+
+    private:
+        MsgPackInterner &m_interner;
+        std::vector<std::uint32_t> &m_ids;
+    };
+
+    /**
+     * @param capacity - max count of the interned strings, the other strings are written as is
+     */
+    explicit MsgPackInterner(std::size_t capacity)
+        : m_table(capacity) {
+    }
+
+    /**
+     * Append the definitions of the ids that are not defined within the current segment yet
+     * (with the lower ids that are not defined yet).
+     * @param ids - ids of the interned fields of a record
+     * @param dst - destination string
+     */
+    void AppendDefinitions(const std::vector<std::uint32_t> &ids, std::string &dst) {
+        for (const auto id : ids) {
+            for (; m_defined_count <= id; ++m_defined_count) {
+                AppendMsgPackInternDefinition(dst, m_defined_count, m_table.Value(m_defined_count));
+            }
+        }
+    }
+
+    /**
+     * Start a new segment: the interned strings will be defined again.
+     */
+    inline void ResetDefinitions() {
+        m_defined_count = 0;
+    }
+
+private:
+    InternTable m_table;
+
+    /**
+     * Count of the defined ids of the current segment (the ids below it are defined).
+     */
+    std::uint32_t m_defined_count = 0;
+};
+
+} // end of scl::detail
@@ -0,0 +1,64 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains helpers that select a policy of the specified category
+ * from the variadic policy list of a logger.
+ */
+
+#pragma once
+
+#include <type_traits>
+
+namespace scl::detail {
+
+/**
+ * Check if the policy T belongs to the category Tag.
+ * Every policy declares its category by the nested PolicyTag alias.
+ * @tparam Tag - policy category tag
+ * @tparam T - checking policy
+ */
+template<typename Tag, typename T, typename = void>
+struct IsPolicyOf : std::false_type {
+};
+
+template<typename Tag, typename T>
+struct IsPolicyOf<Tag, T, std::void_t<typename T::PolicyTag>>
+    : std::is_same<Tag, typename T::PolicyTag> {
+};
+
+/**
+ * Select the first policy of the Tag category from the Policies list.
+ * If there is no such policy, the Default is selected.
+ * @tparam Tag - policy category tag
+ * @tparam Default - default policy of the category
+ * @tparam Policies - policy list
+ */
+template<typename Tag, typename Default, typename ...Policies>
+struct SelectPolicy {
+    using type = Default;
+};
+
+template<typename Tag, typename Default, typename T, typename ...Policies>
+struct SelectPolicy<Tag, Default, T, Policies...> {
+    using type = std::conditional_t<IsPolicyOf<Tag, T>::value,
+                                    T,
+                                    typename SelectPolicy<Tag, Default, Policies...>::type>;
+};
+
+template<typename Tag, typename Default, typename ...Policies>
+using SelectPolicyT = typename SelectPolicy<Tag, Default, Policies...>::type;
+
+/**
+ * Count of the Tag category policies within the Policies list.
+ * The value is used to forbid ambiguous policy lists.
+ */
+template<typename Tag, typename ...Policies>
+constexpr std::size_t policies_count_k = (std::size_t{0} + ... + (IsPolicyOf<Tag, Policies>::value ? 1 : 0));
+
+} // end of scl::detail
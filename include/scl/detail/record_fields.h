@@ -0,0 +1,61 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the traits of the optional record fields:
+ * the recorders use the fields of the record types that have them (eg CoreRecord::session_id).
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace scl::detail {
+
+template<typename RecordT, typename = void>
+struct HasTimeStr : std::false_type {
+};
+
+template<typename RecordT>
+struct HasTimeStr<RecordT, std::void_t<decltype(std::declval<const RecordT &>().time_str)>> : std::true_type {
+};
+
+template<typename RecordT, typename = void>
+struct HasPid : std::false_type {
+};
+
+template<typename RecordT>
+struct HasPid<RecordT, std::void_t<decltype(std::declval<const RecordT &>().pid)>> : std::true_type {
+};
+
+template<typename RecordT, typename = void>
+struct HasSessionId : std::false_type {
+};
+
+template<typename RecordT>
+struct HasSessionId<RecordT, std::void_t<decltype(std::declval<const RecordT &>().session_id)>> : std::true_type {
+};
+
+template<typename RecordT, typename = void>
+struct HasAction : std::false_type {
+};
+
+template<typename RecordT>
+struct HasAction<RecordT, std::void_t<decltype(std::declval<const RecordT &>().action)>> : std::true_type {
+};
+
+template<typename RecordT, typename = void>
+struct HasHandler : std::false_type {
+};
+
+template<typename RecordT>
+struct HasHandler<RecordT, std::void_t<decltype(std::declval<const RecordT &>().handler)>> : std::true_type {
+};
+
+} // end of scl::detail
@@ -0,0 +1,153 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the functions that write record tokens in the plain and aligned text formats:
+ *   plain: "token | "
+ *   aligned: "<left indent>token | ", where the token is truncated to the align length
+ * and the optional sequence number token "#<sequence> | " that follows the time (see IRecord::Sequence())
+ */
+
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <scl/detail/format_defines.h>
+
+namespace scl::detail {
+
+namespace log_formatting {
+constexpr std::string_view separator_k = " | ";
+} // end of log_formatting
+
+/**
+ * Max size of a plain token.
+ * @param token_size - token size
+ * @return - size of the written token with the separator
+ */
+inline constexpr std::size_t PlainTokenSize(std::size_t token_size) {
+    return token_size + log_formatting::separator_k.size();
+}
+
+/**
+ * Size of an aligned token.
+ * @param align - align length
+ * @return - size of the written token with the separator
+ */
+inline constexpr std::size_t AlignedTokenSize(std::size_t align) {
+    return align + log_formatting::separator_k.size();
+}
+
+/**
+ * Write a plain token with the separator.
+ * @param dst - destination buffer, must contain at least PlainTokenSize(token.size()) bytes
+ * @param token - token
+ * @return - pointer to the end of the written data
+ */
+inline char *WriteToken(char *dst, std::string_view token) {
+    std::memcpy(dst, token.data(), token.size());
+    dst += token.size();
+    std::memcpy(dst, log_formatting::separator_k.data(), log_formatting::separator_k.size());
+    return dst + log_formatting::separator_k.size();
+}
+
+/**
+ * Write an aligned token with the separator.
+ * @param dst - destination buffer, must contain at least AlignedTokenSize(align) bytes
+ * @param token - token
+ * @param align - align length
+ * @return - pointer to the end of the written data
+ */
+inline char *WriteAlignedToken(char *dst, std::string_view token, std::size_t align) {
+    const auto token_length = align < token.size() ? align : token.size();
+    const auto difference = align - token_length;
+
+    std::memset(dst, ' ', difference);
+    dst += difference;
+    return WriteToken(dst, token.substr(0, token_length));
+}
+
+/**
+ * Append a plain token with the separator to the string.
+ */
+inline void AppendToken(std::string &dst, std::string_view token) {
+    const auto size = dst.size();
+    dst.resize(size + PlainTokenSize(token.size()));
+    WriteToken(dst.data() + size, token);
+}
+
+/**
+ * Append an aligned token with the separator to the string.
+ */
+inline void AppendAlignedToken(std::string &dst, std::string_view token, std::size_t align) {
+    const auto size = dst.size();
+    dst.resize(size + AlignedTokenSize(align));
+    WriteAlignedToken(dst.data() + size, token, align);
+}
+
+/**
+ * Append the sequence number token "#<sequence> | " to the string.
+ */
+inline void AppendSequenceToken(std::string &dst, std::uint64_t sequence) {
+    char buffer[NumberTrait<std::uint64_t>::max_digits_count + 2];
+    buffer[0] = log_formatting::sequence_mark_k;
+    const auto result = std::to_chars(buffer + 1, buffer + sizeof(buffer), sequence);
+    AppendToken(dst, {buffer, static_cast<std::size_t>(result.ptr - buffer)});
+}
+
+/**
+ * Append the sequence number token aligned to the log_formatting::sequence_length_k to the string,
+ * the longer number is not truncated.
+ */
+inline void AppendAlignedSequenceToken(std::string &dst, std::uint64_t sequence) {
+    char buffer[NumberTrait<std::uint64_t>::max_digits_count + 2];
+    buffer[0] = log_formatting::sequence_mark_k;
+    const auto result = std::to_chars(buffer + 1, buffer + sizeof(buffer), sequence);
+    const std::string_view token(buffer, static_cast<std::size_t>(result.ptr - buffer));
+    const std::size_t align = log_formatting::sequence_length_k;
+    AppendAlignedToken(dst, token, token.size() < align ? align : token.size());
+}
+
+/**
+ * Parse the sequence number token.
+ * @param token - token without the separator and the left indent
+ * @return - sequence number or std::nullopt if the token is not a sequence number token
+ */
+inline std::optional<std::uint64_t> ParseSequenceToken(std::string_view token) {
+    if (token.size() < 2 || token.front() != log_formatting::sequence_mark_k) {
+        return std::nullopt;
+    }
+
+    std::uint64_t sequence = 0;
+    const auto result = std::from_chars(token.data() + 1, token.data() + token.size(), sequence);
+    if (result.ec != std::errc() || result.ptr != token.data() + token.size()) {
+        return std::nullopt;
+    }
+
+    return sequence;
+}
+
+/**
+ * Convert an integer to chars without allocation.
+ * @tparam N - size of the destination buffer
+ * @param buffer - destination buffer
+ * @param value - integer value
+ * @return - view of the converted value within the buffer
+ */
+template<std::size_t N, typename T>
+inline std::string_view IntegerToChars(char (&buffer)[N], T value) {
+    const auto result = std::to_chars(buffer, buffer + N, value);
+    return {buffer, static_cast<std::size_t>(result.ptr - buffer)};
+}
+
+} // end of scl::detail
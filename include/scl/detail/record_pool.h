@@ -0,0 +1,315 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the per-thread pool of the record storage blocks.
+ * A detached record packs its variable-length fields to a single block (see PackViews()),
+ * the block is carved from a slab of the thread that detaches the record
+ * and is returned to the same pool after the recorders finish:
+ *   - the owner thread takes and returns the blocks without synchronization;
+ *   - other threads (eg the worker of an asynchronous logger) return the blocks
+ *     to the lock-free remote list that the owner thread takes at once when its local list is empty.
+ * So the memory usage is flat under a steady load and the logging threads don't contend in the heap allocator.
+ * If a memory resource is specified, the block is allocated from the resource instead of the pool.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+namespace scl::detail {
+
+class RecordPool;
+
+/**
+ * Header that precedes the data of a block.
+ */
+struct alignas(std::max_align_t) PoolBlockHeader {
+    /**
+     * Owner pool or nullptr if the block is allocated by the heap allocator or the memory resource.
+     */
+    RecordPool *pool = nullptr;
+
+    /**
+     * Memory resource of the block or nullptr.
+     */
+    std::pmr::memory_resource *resource = nullptr;
+
+    /**
+     * Next block of a free list.
+     */
+    PoolBlockHeader *next = nullptr;
+
+    /**
+     * Size class index of a pool block or the data size of a memory resource block.
+     */
+    std::size_t size_class = 0;
+};
+
+/**
+ * Pool of the record storage blocks of a thread.
+ * The pool is destroyed when the owner thread is finished and all the blocks are returned.
+ */
+class RecordPool {
+public:
+    /**
+     * Block data sizes of the size classes. Larger blocks are allocated by the heap allocator.
+     */
+    static constexpr std::array<std::size_t, 4> size_classes_k = {64, 256, 1024, 4096};
+
+    static constexpr std::size_t slab_size_k = 64 * 1024;
+
+    /**
+     * @return - pool of the calling thread
+     */
+    static RecordPool &Local() {
+        thread_local const LocalHolder holder;
+        return *holder.pool;
+    }
+
+    /**
+     * Allocate a block.
+     * @param size - size of the block data
+     * @param resource - memory resource or nullptr to allocate from the pool
+     * @return - block data
+     */
+    static char *Allocate(std::size_t size, std::pmr::memory_resource *resource = nullptr) {
+        if (resource != nullptr) {
+            void *memory = resource->allocate(sizeof(PoolBlockHeader) + size, alignof(PoolBlockHeader));
+            auto *header = new(memory) PoolBlockHeader;
+            header->resource = resource;
+            header->size_class = size;
+            return Data(header);
+        }
+
+        const auto size_class = SizeClass(size);
+        if (size_class == size_classes_k.size()) {
+            auto *header = new(::operator new(sizeof(PoolBlockHeader) + size)) PoolBlockHeader;
+            return Data(header);
+        }
+
+        return Data(Local().AllocateBlock(size_class));
+    }
+
+    /**
+     * Return a block to its pool. The function may be called on any thread.
+     * @param data - block data
+     */
+    static void Release(char *data) {
+        auto *header = Header(data);
+        if (auto *resource = header->resource) {
+            const auto size = header->size_class;
+            header->~PoolBlockHeader();
+            resource->deallocate(header, sizeof(PoolBlockHeader) + size, alignof(PoolBlockHeader));
+            return;
+        }
+
+        if (header->pool == nullptr) {
+            header->~PoolBlockHeader();
+            ::operator delete(header);
+            return;
+        }
+
+        header->pool->ReleaseBlock(header);
+    }
+
+    RecordPool(const RecordPool &) = delete;
+
+    RecordPool &operator=(const RecordPool &) = delete;
+
+private:
+    /**
+     * Holder of the thread pool reference.
+     */
+    struct LocalHolder {
+        LocalHolder()
+            : pool(new RecordPool) {
+            owner_pool = pool;
+        }
+
+        ~LocalHolder() {
+            owner_pool = nullptr;
+            pool->Unref();
+        }
+
+        RecordPool *pool;
+    };
+
+    RecordPool() = default;
+
+    ~RecordPool() = default;
+
+    static inline std::size_t SizeClass(std::size_t size) {
+        std::size_t size_class = 0;
+        while (size_class < size_classes_k.size() && size_classes_k[size_class] < size) {
+            ++size_class;
+        }
+
+        return size_class;
+    }
+
+    static inline char *Data(PoolBlockHeader *header) {
+        return reinterpret_cast<char *>(header + 1);
+    }
+
+    static inline PoolBlockHeader *Header(char *data) {
+        return reinterpret_cast<PoolBlockHeader *>(data) - 1;
+    }
+
+    PoolBlockHeader *AllocateBlock(std::size_t size_class) {
+        // the reference of an outstanding block keeps the pool alive after the owner thread is finished
+        m_refs.fetch_add(1, std::memory_order_relaxed);
+
+        auto *header = m_local[size_class];
+        if (header == nullptr) {
+            // take all the blocks returned by other threads
+            header = m_remote[size_class].exchange(nullptr, std::memory_order_acquire);
+        }
+
+        if (header == nullptr) {
+            header = Carve(size_class);
+        }
+
+        m_local[size_class] = header->next;
+        header->next = nullptr;
+        return header;
+    }
+
+    void ReleaseBlock(PoolBlockHeader *header) {
+        const auto size_class = header->size_class;
+        if (owner_pool == this) {
+            header->next = m_local[size_class];
+            m_local[size_class] = header;
+        } else {
+            auto &remote = m_remote[size_class];
+            header->next = remote.load(std::memory_order_relaxed);
+            while (!remote.compare_exchange_weak(header->next, header,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+            }
+        }
+
+        Unref();
+    }
+
+    /**
+     * Carve a new block from the current slab.
+     * @param size_class - size class index of the block
+     * @return - header of the block
+     */
+    PoolBlockHeader *Carve(std::size_t size_class) {
+        const auto block_size = sizeof(PoolBlockHeader) + size_classes_k[size_class];
+        if (m_slabs.empty() || m_slab_used + block_size > slab_size_k) {
+            m_slabs.emplace_back(new char[slab_size_k]);
+            m_slab_used = 0;
+        }
+
+        auto *header = new(m_slabs.back().get() + m_slab_used) PoolBlockHeader;
+        header->pool = this;
+        header->size_class = size_class;
+        m_slab_used += block_size;
+        return header;
+    }
+
+    void Unref() {
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    /**
+     * Pool of the calling thread, it is used to detect the owner thread on the block release.
+     */
+    static inline thread_local RecordPool *owner_pool = nullptr;
+
+    /**
+     * Free blocks that are available to the owner thread without synchronization.
+     */
+    std::array<PoolBlockHeader *, size_classes_k.size()> m_local{};
+
+    /**
+     * Free blocks returned by other threads.
+     */
+    std::array<std::atomic<PoolBlockHeader *>, size_classes_k.size()> m_remote{};
+
+    std::vector<std::unique_ptr<char[]>> m_slabs;
+
+    std::size_t m_slab_used = 0;
+
+    /**
+     * Count of the outstanding blocks plus the reference of the owner thread.
+     */
+    std::atomic<std::size_t> m_refs{1};
+};
+
+/**
+ * Owning handle of a pool block.
+ */
+class PoolBlock {
+public:
+    PoolBlock() = default;
+
+    /**
+     * Allocate a block.
+     * @param size - size of the block data
+     * @param resource - memory resource or nullptr to allocate from the pool
+     */
+    explicit PoolBlock(std::size_t size, std::pmr::memory_resource *resource = nullptr)
+        : m_data(RecordPool::Allocate(size, resource)) {
+    }
+
+    PoolBlock(const PoolBlock &) = delete;
+
+    PoolBlock(PoolBlock &&other) noexcept
+        : m_data(other.m_data) {
+        other.m_data = nullptr;
+    }
+
+    PoolBlock &operator=(const PoolBlock &) = delete;
+
+    PoolBlock &operator=(PoolBlock &&other) noexcept {
+        if (this != &other) {
+            Reset();
+            m_data = other.m_data;
+            other.m_data = nullptr;
+        }
+
+        return *this;
+    }
+
+    ~PoolBlock() {
+        Reset();
+    }
+
+    [[nodiscard]]
+    inline char *Data() const {
+        return m_data;
+    }
+
+    explicit operator bool() const {
+        return m_data != nullptr;
+    }
+
+private:
+    void Reset() {
+        if (m_data != nullptr) {
+            RecordPool::Release(m_data);
+            m_data = nullptr;
+        }
+    }
+
+    char *m_data = nullptr;
+};
+
+} // end of scl::detail
@@ -0,0 +1,94 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains helpers of the records that refer to their variable-length fields by views.
+ * A view record doesn't allocate on construction. If the record must outlive the referred data,
+ * the fields are copied to a single owned block and the views are re-pointed to it.
+ * The blocks are taken from the pool of the calling thread (see RecordPool) or from a memory resource.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include <scl/detail/record_pool.h>
+
+namespace scl::detail {
+
+inline std::size_t ViewSize(std::string_view view) {
+    return view.size();
+}
+
+inline std::size_t ViewSize(const std::optional<std::string_view> &view) {
+    return view ? view->size() : 0;
+}
+
+/**
+ * Copy the viewed data to the destination buffer and re-point the view to the copy.
+ * @param dst - destination buffer, must contain at least ViewSize(view) bytes
+ * @param view - view to copy
+ * @return - pointer to the end of the copied data
+ */
+inline char *RelocateView(char *dst, std::string_view &view) {
+    if (!view.empty()) {
+        std::memcpy(dst, view.data(), view.size());
+    }
+
+    view = std::string_view(dst, view.size());
+    return dst + view.size();
+}
+
+inline char *RelocateView(char *dst, std::optional<std::string_view> &view) {
+    return view ? RelocateView(dst, *view) : dst;
+}
+
+/**
+ * Copy the viewed data of the all views to a single block and re-point the views to it.
+ * @tparam Views - std::string_view or std::optional<std::string_view>
+ * @param resource - memory resource of the block or nullptr to use the pool of the calling thread
+ * @param views - views to copy
+ * @return - block that owns the copied data, it is never empty
+ */
+template<typename ...Views>
+PoolBlock PackViews(std::pmr::memory_resource *resource, Views &...views) {
+    const std::size_t size = (std::size_t{0} + ... + ViewSize(views));
+    PoolBlock storage(size, resource);
+
+    char *dst = storage.Data();
+    ((dst = RelocateView(dst, views)), ...);
+    return storage;
+}
+
+/**
+ * Check if the record may be detached from the data of the caller (see CoreRecord::Detach()).
+ */
+template<typename RecordT, typename = void>
+struct IsDetachable : std::false_type {
+};
+
+template<typename RecordT>
+struct IsDetachable<RecordT, std::void_t<decltype(std::declval<RecordT &>().Detach())>> : std::true_type {
+};
+
+/**
+ * Make the record own its data if the record supports that.
+ * @param record - record
+ */
+template<typename RecordT>
+inline void DetachRecord(RecordT &record) {
+    if constexpr (IsDetachable<RecordT>::value) {
+        record.Detach();
+    }
+}
+
+} // end of scl::detail
@@ -0,0 +1,109 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the functions that escape the control characters of a serialized text record,
+ * so a record always takes a single line: "\n" -> "\\n", "\r" -> "\\r", "\t" -> "\\t", other -> "\\xHH".
+ * The backslash is escaped too ("\\" -> "\\\\"), so an escaped record can be unescaped unambiguously.
+ * The text is scanned for such characters by 32 (AVX2) or 16 (SSE2) bytes at once (see char_scan.h),
+ * so a clean record (the most of the records) is not copied.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <scl/detail/char_scan.h>
+
+namespace scl::detail {
+
+/**
+ * The extra characters of the control characters scan (see IsSpecialChar()).
+ */
+constexpr char del_char_k = 0x7f;
+constexpr char backslash_char_k = '\\';
+
+/**
+ * @param ch - character
+ * @return - true if the character must be escaped: a control character (0x00-0x1f or 0x7f) or the backslash
+ */
+inline constexpr bool IsControlChar(unsigned char ch) {
+    return IsSpecialChar(ch, del_char_k, backslash_char_k);
+}
+
+/**
+ * Find the first character that must be escaped (see IsControlChar()).
+ * @param data - text data
+ * @param size - text size
+ * @return - index of the character or the size if there is no such character
+ */
+inline std::size_t FindControlChar(const char *data, std::size_t size) {
+    return FindSpecialChar(data, size, del_char_k, backslash_char_k);
+}
+
+/**
+ * Append the escaped control character.
+ * @param dst - destination string
+ * @param ch - control character or the backslash (see IsControlChar())
+ */
+inline void AppendControlCharEscape(std::string &dst, unsigned char ch) {
+    switch (ch) {
+        case '\\':
+            dst += "\\\\";
+            return;
+        case '\n':
+            dst += "\\n";
+            return;
+        case '\r':
+            dst += "\\r";
+            return;
+        case '\t':
+            dst += "\\t";
+            return;
+        default: {
+            constexpr char hex_k[] = "0123456789abcdef";
+            const char escape[] = {'\\', 'x', hex_k[ch >> 4], hex_k[ch & 0xf]};
+            dst.append(escape, sizeof(escape));
+        }
+    }
+}
+
+/**
+ * Escape the control characters of the text in place.
+ * @param text - text
+ * @param pos - position of the first character to sanitize (eg the beginning of an appended record)
+ */
+inline void SanitizeControlChars(std::string &text, std::size_t pos = 0) {
+    const auto first_control_pos = pos + FindControlChar(text.data() + pos, text.size() - pos);
+    if (first_control_pos == text.size()) {
+        return;
+    }
+
+    // the buffer is reused by the records of the thread
+    thread_local std::string sanitized;
+    sanitized.clear();
+
+    auto control_pos = first_control_pos;
+    while (true) {
+        AppendControlCharEscape(sanitized, static_cast<unsigned char>(text[control_pos]));
+        const auto clean_begin = control_pos + 1;
+        const auto clean_size = FindControlChar(text.data() + clean_begin, text.size() - clean_begin);
+        sanitized.append(text, clean_begin, clean_size);
+
+        control_pos = clean_begin + clean_size;
+        if (control_pos == text.size()) {
+            break;
+        }
+    }
+
+    text.resize(first_control_pos);
+    text += sanitized;
+}
+
+} // end of scl::detail
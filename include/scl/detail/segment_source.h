@@ -0,0 +1,116 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#ifdef SCL_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace scl::detail {
+
+/**
+ * Sequential reader of a plain or gzip-compressed log file.
+ * The compression is detected by the gzip magic, the compressed files are supported
+ * if the SCL_HAS_ZLIB macro is defined and the zlib is linked.
+ */
+class SegmentSource {
+public:
+    /**
+     * Result of the Open() method.
+     */
+    enum class OpenResult {
+        Ok = 0,
+        CantOpenFile,
+        CompressionNotSupported,
+    };
+
+    /**
+     * Open the file.
+     * @param path - path to the file
+     * @param source - destination of the opened source
+     * @return - result of the opening
+     */
+    static OpenResult Open(const std::filesystem::path &path, std::unique_ptr<SegmentSource> &source) {
+        std::unique_ptr<SegmentSource> instance(new SegmentSource());
+        instance->m_file.open(path, std::ios::binary);
+        if (!instance->m_file.is_open()) {
+            return OpenResult::CantOpenFile;
+        }
+
+        char magic[2] = {0, 0};
+        instance->m_file.read(magic, sizeof(magic));
+        const bool is_compressed = instance->m_file.gcount() == 2
+                                   && static_cast<unsigned char>(magic[0]) == 0x1f
+                                   && static_cast<unsigned char>(magic[1]) == 0x8b;
+        instance->m_file.clear();
+        instance->m_file.seekg(0);
+
+        if (is_compressed) {
+#ifdef SCL_HAS_ZLIB
+            instance->m_file.close();
+            instance->m_gz_file = ::gzopen(path.string().c_str(), "rb");
+            if (!instance->m_gz_file) {
+                return OpenResult::CantOpenFile;
+            }
+
+            ::gzbuffer(instance->m_gz_file, 128 * 1024);
+#else
+            return OpenResult::CompressionNotSupported;
+#endif
+        }
+
+        source = std::move(instance);
+        return OpenResult::Ok;
+    }
+
+    SegmentSource(const SegmentSource &) = delete;
+
+    SegmentSource &operator=(const SegmentSource &) = delete;
+
+    ~SegmentSource() {
+#ifdef SCL_HAS_ZLIB
+        if (m_gz_file) {
+            ::gzclose(m_gz_file);
+        }
+#endif
+    }
+
+    /**
+     * Read the next data of the file.
+     * @param dst - destination buffer
+     * @param size - size of the buffer
+     * @return - count of the read bytes, 0 at the end of the file or on a read error
+     */
+    std::size_t Read(char *dst, std::size_t size) {
+#ifdef SCL_HAS_ZLIB
+        if (m_gz_file) {
+            const int read = ::gzread(m_gz_file, dst, static_cast<unsigned>(size));
+            return read > 0 ? static_cast<std::size_t>(read) : 0;
+        }
+#endif
+
+        m_file.read(dst, static_cast<std::streamsize>(size));
+        return static_cast<std::size_t>(m_file.gcount());
+    }
+
+private:
+    SegmentSource() = default;
+
+    std::ifstream m_file;
+
+#ifdef SCL_HAS_ZLIB
+    gzFile m_gz_file = nullptr;
+#endif
+};
+
+} // end of scl::detail
@@ -0,0 +1,47 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace scl::detail {
+
+/**
+ * @return - process-wide counter of the taken sequence numbers
+ */
+inline std::atomic<std::uint64_t> &SequenceCounter() {
+    static std::atomic<std::uint64_t> counter{0};
+    return counter;
+}
+
+/**
+ * Take the next record sequence number (see IRecord::SetSequence()).
+ * A thread takes the numbers by blocks from the process-wide counter, so the producers touch the shared counter
+ * once per block only. The numbers are unique within the process and increase within a thread.
+ * Only the block size 1 orders the numbers of different threads: a thread assigns the numbers of its block
+ * for an unbounded time (eg until it logs the block size records), so its numbers may be far below the numbers
+ * taken by the other threads meanwhile.
+ * @param block_size - count of the numbers taken by a thread at once (at least one)
+ * @return - sequence number
+ */
+inline std::uint64_t NextSequence(std::uint64_t block_size) {
+    thread_local std::uint64_t next = 0;
+    thread_local std::uint64_t end = 0;
+
+    if (next == end) {
+        block_size = block_size == 0 ? 1 : block_size;
+        next = SequenceCounter().fetch_add(block_size, std::memory_order_relaxed);
+        end = next + block_size;
+    }
+
+    return next++;
+}
+
+} // end of scl::detail
@@ -0,0 +1,404 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the log file shared by several processes (see FileRecorder::Options::multi_process).
+ * The processes coordinate through a lock file that contains a memory-mapped header:
+ *   - the header state packs the file generation and the reserved file size into one atomic value,
+ *     so a process reserves the space of a record by a CAS and detects that the file overflows;
+ *   - the process that detects the overflow rotates the file under the exclusive file lock (flock)
+ *     to an empty file (the size of a used file may miss the reserved records that are being written)
+ *     and publishes the new file path and the next generation;
+ *   - other processes see the generation change and reopen the published file.
+ * Every record is appended by a single write() to a file opened with O_APPEND,
+ * so the records of the processes never interleave within a line.
+ */
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#define SCL_HAS_SHARED_FILE
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace scl::detail {
+
+/**
+ * Log file shared by several processes.
+ */
+class SharedFile {
+public:
+    /**
+     * Function that selects the path of a new log file (or std::nullopt if there is no available file).
+     * It is called under the exclusive file lock on the initialization and rotation.
+     */
+    using SelectPathFn = std::function<std::optional<std::filesystem::path>()>;
+
+    /**
+     * Open the shared file.
+     * @param lock_path - path to the lock file (it is created if it doesn't exist)
+     * @param size_limit - optional file size limit, the file is rotated when the limit is reached
+     * @param select_path - function that selects the path of a new log file
+     * @return - pointer to the opened shared file or nullptr if the lock file or the log file couldn't be opened
+     */
+    static std::unique_ptr<SharedFile> Open(const std::filesystem::path &lock_path,
+                                            std::optional<std::size_t> size_limit,
+                                            SelectPathFn select_path) {
+        std::unique_ptr<SharedFile> file(new SharedFile(size_limit, std::move(select_path)));
+
+        file->m_lock_fd = ::open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (file->m_lock_fd < 0) {
+            return nullptr;
+        }
+
+        const FileLock lock(file->m_lock_fd, LOCK_EX);
+
+        struct stat lock_stat{};
+        if (::fstat(file->m_lock_fd, &lock_stat) != 0) {
+            return nullptr;
+        }
+
+        if (static_cast<std::size_t>(lock_stat.st_size) < sizeof(Header)
+            && ::ftruncate(file->m_lock_fd, sizeof(Header)) != 0) {
+            return nullptr;
+        }
+
+        void *header = ::mmap(nullptr, sizeof(Header), PROT_READ | PROT_WRITE, MAP_SHARED, file->m_lock_fd, 0);
+        if (header == MAP_FAILED) {
+            return nullptr;
+        }
+
+        file->m_header = static_cast<Header *>(header);
+
+        // continue the file of the running processes if it is still available
+        if (file->m_header->magic == magic_k && file->OpenPublished()) {
+            return file;
+        }
+
+        const auto state = file->m_header->state.load(std::memory_order_acquire);
+        if (!file->RotateLocked(file->m_header->magic == magic_k ? Generation(state) : 0, false)) {
+            return nullptr;
+        }
+
+        file->m_header->magic = magic_k;
+        return file;
+    }
+
+    SharedFile(const SharedFile &) = delete;
+
+    SharedFile &operator=(const SharedFile &) = delete;
+
+    ~SharedFile() {
+        if (m_header != nullptr) {
+            ::munmap(m_header, sizeof(Header));
+        }
+
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+
+        if (m_lock_fd >= 0) {
+            ::close(m_lock_fd);
+        }
+    }
+
+    /**
+     * Append the data to the current file by a single write, rotate the file if it overflows.
+     * Note the method is not thread-safe, the calls of a process must be synchronized.
+     * @param data - data to write (a whole record with the line break)
+     * @return - true if the data is written
+     */
+    bool Write(std::string_view data) {
+        auto state = m_header->state.load(std::memory_order_acquire);
+        while (true) {
+            if (Generation(state) != m_generation) {
+                // another process has rotated the file
+                if (!Reopen()) {
+                    return false;
+                }
+
+                state = m_header->state.load(std::memory_order_acquire);
+                continue;
+            }
+
+            const auto size = Size(state);
+            const auto new_size = size + data.size();
+            // an empty file takes the record even if it is larger than the limit
+            if (m_size_limit && *m_size_limit <= new_size && size != 0) {
+                if (!Rotate(state)) {
+                    return false;
+                }
+
+                state = m_header->state.load(std::memory_order_acquire);
+                continue;
+            }
+
+            if (m_header->state.compare_exchange_weak(state,
+                                                      MakeState(m_generation, new_size),
+                                                      std::memory_order_acq_rel,
+                                                      std::memory_order_acquire)) {
+                break;
+            }
+        }
+
+        return WriteAll(data);
+    }
+
+    /**
+     * @return - path to the current file of the process
+     */
+    [[nodiscard]]
+    inline const std::filesystem::path &Path() const {
+        return m_path;
+    }
+
+private:
+    static constexpr std::uint64_t magic_k = 0x53434c5348415245; // "SCLSHARE"
+
+    static constexpr unsigned size_bits_k = 48;
+
+    static constexpr std::uint64_t size_mask_k = (std::uint64_t{1} << size_bits_k) - 1;
+
+    static constexpr std::uint64_t generation_mask_k = (std::uint64_t{1} << (64 - size_bits_k)) - 1;
+
+    static constexpr std::size_t path_capacity_k = 4000;
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "the shared header requires the lock-free 64-bit atomics");
+
+    /**
+     * Header of the lock file mapped to the memory of every process.
+     */
+    struct Header {
+        std::uint64_t magic;
+
+        /**
+         * Generation of the current file (high 16 bits) and its reserved size (low 48 bits).
+         */
+        std::atomic<std::uint64_t> state;
+
+        std::uint32_t path_size;
+
+        char path[path_capacity_k];
+    };
+
+    /**
+     * RAII holder of the flock() lock.
+     */
+    class FileLock {
+    public:
+        FileLock(int fd, int operation)
+            : m_fd(fd) {
+            while (::flock(m_fd, operation) != 0 && errno == EINTR) {
+            }
+        }
+
+        ~FileLock() {
+            ::flock(m_fd, LOCK_UN);
+        }
+
+    private:
+        int m_fd;
+    };
+
+    static inline std::uint64_t MakeState(std::uint64_t generation, std::uint64_t size) {
+        return (generation << size_bits_k) | (size & size_mask_k);
+    }
+
+    static inline std::uint64_t Generation(std::uint64_t state) {
+        return state >> size_bits_k;
+    }
+
+    static inline std::uint64_t Size(std::uint64_t state) {
+        return state & size_mask_k;
+    }
+
+    SharedFile(std::optional<std::size_t> size_limit, SelectPathFn select_path)
+        : m_size_limit(size_limit),
+          m_select_path(std::move(select_path)) {
+    }
+
+    /**
+     * @return - path of the file published in the header
+     * Note the method must be called under the file lock.
+     */
+    inline std::string_view PublishedPath() const {
+        return {m_header->path, std::min<std::size_t>(m_header->path_size, path_capacity_k)};
+    }
+
+    /**
+     * @return - true if the file doesn't exist or is empty
+     */
+    static bool IsEmptyFile(const std::filesystem::path &path) {
+        struct stat file_stat{};
+        return ::stat(path.c_str(), &file_stat) != 0 || file_stat.st_size == 0;
+    }
+
+    /**
+     * Open the file published in the header.
+     * Note the method must be called under the file lock.
+     * @return - true if the file is opened
+     */
+    bool OpenPublished() {
+        const auto state = m_header->state.load(std::memory_order_acquire);
+        if (!OpenFile(PublishedPath())) {
+            return false;
+        }
+
+        m_generation = Generation(state);
+        return true;
+    }
+
+    /**
+     * Reopen the file published by another process.
+     * @return - true if the file is opened
+     */
+    bool Reopen() {
+        const FileLock lock(m_lock_fd, LOCK_SH);
+        return OpenPublished();
+    }
+
+    /**
+     * Rotate the file if no other process has done that after the state was read.
+     * @param state - read state of the header
+     * @return - true if the file is rotated by this or another process
+     */
+    bool Rotate(std::uint64_t state) {
+        const FileLock lock(m_lock_fd, LOCK_EX);
+        if (Generation(m_header->state.load(std::memory_order_acquire)) != Generation(state)) {
+            // the file is rotated by another process already
+            return true;
+        }
+
+        return RotateLocked(Generation(state), true);
+    }
+
+    /**
+     * Select and open a new file and publish it with the next generation.
+     * Note the method must be called under the exclusive file lock.
+     * @param generation - current generation
+     * @param is_overflowed - true if the published file is overflowed
+     * @return - true if the file is opened
+     */
+    bool RotateLocked(std::uint64_t generation, bool is_overflowed) {
+        auto path = m_select_path();
+        if (is_overflowed) {
+            // the size of a used file doesn't include the records that are reserved but are not written yet
+            // (eg by a descheduled process), so the rotation continues with an empty file only
+            std::optional<std::filesystem::path> previous_path;
+            while (path && !IsEmptyFile(*path)) {
+                if (path == previous_path) {
+                    // the path can't be rotated
+                    return false;
+                }
+
+                previous_path = std::move(path);
+                path = m_select_path();
+            }
+        }
+
+        if (!path || path->native().size() > path_capacity_k || !OpenFile(path->native())) {
+            return false;
+        }
+
+        struct stat file_stat{};
+        if (::fstat(m_fd, &file_stat) != 0) {
+            return false;
+        }
+
+        const auto &native = path->native();
+        std::memcpy(m_header->path, native.data(), native.size());
+        m_header->path_size = static_cast<std::uint32_t>(native.size());
+
+        // the generation 0 is reserved for the uninitialized header
+        m_generation = (generation + 1) & generation_mask_k;
+        if (m_generation == 0) {
+            m_generation = 1;
+        }
+
+        m_header->state.store(MakeState(m_generation, static_cast<std::uint64_t>(file_stat.st_size)),
+                              std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Open the file for appending and replace the current one.
+     * @param path - path to the file
+     * @return - true if the file is opened
+     */
+    bool OpenFile(std::string_view path) {
+        const std::string path_str(path);
+        const int fd = ::open(path_str.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+
+        m_fd = fd;
+        m_path = path_str;
+        return true;
+    }
+
+    bool WriteAll(std::string_view data) {
+        while (!data.empty()) {
+            const auto written = ::write(m_fd, data.data(), data.size());
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return false;
+            }
+
+            data.remove_prefix(static_cast<std::size_t>(written));
+        }
+
+        return true;
+    }
+
+    std::optional<std::size_t> m_size_limit;
+
+    SelectPathFn m_select_path;
+
+    int m_lock_fd = -1;
+
+    int m_fd = -1;
+
+    Header *m_header = nullptr;
+
+    /**
+     * Generation of the file opened by the process.
+     */
+    std::uint64_t m_generation = 0;
+
+    std::filesystem::path m_path;
+};
+
+} // end of scl::detail
+
+#endif
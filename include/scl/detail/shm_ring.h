@@ -0,0 +1,494 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the multi-producer single-consumer ring buffer of serialized records
+ * within the POSIX shared memory (see ShmRecorder and the shm_collector tool).
+ * The ring is a bounded queue with the per-slot sequence numbers:
+ *   - a producer reserves a position by a CAS on the shared tail, claims the slot by a CAS of its sequence number
+ *     to the claimed one, stores its pid to the slot, copies the record and publishes the slot
+ *     by a CAS of the claimed sequence number to the published one;
+ *   - the consumer takes the published slots in order and releases them for the next lap;
+ *   - the consumer recovers an abandoned slot by a CAS of its sequence number to the next lap,
+ *     so a crashed producer doesn't stall the ring: a claimed slot is recovered only if its producer is dead,
+ *     a reserved slot that is not claimed is recovered after the stale timeout. A producer that resumes
+ *     after the recovery of its unclaimed slot fails to claim it and its record is dropped, so a live producer
+ *     never writes the data, the level or the size of a slot that the consumer may read on another lap.
+ * Note a claimed slot whose producer pid is reused (or whose producer crashes between the claim and the pid storing)
+ * is not recovered until that process exits.
+ * A full ring doesn't block the producers: the record is dropped and counted.
+ */
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#define SCL_HAS_SHM_RING
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace scl::detail {
+
+/**
+ * Ring buffer of serialized records within the POSIX shared memory.
+ */
+class ShmRing {
+public:
+    /**
+     * Reserved slot of a producer.
+     */
+    struct Reservation {
+        std::uint64_t position;
+        char *data;
+        std::size_t capacity;
+    };
+
+    /**
+     * Counters of the ring.
+     */
+    struct Stats {
+        /**
+         * Count of the records dropped because the ring was full.
+         */
+        std::uint64_t dropped = 0;
+
+        /**
+         * Count of the slots recovered after the crashed producers (or the producers stalled before the claim).
+         */
+        std::uint64_t recovered = 0;
+
+        /**
+         * Count of the records truncated to the slot size.
+         */
+        std::uint64_t truncated = 0;
+    };
+
+    /**
+     * Create the ring or attach to the existing one with the same geometry (eg after the consumer restart).
+     * The ring is created by the consumer.
+     * @param name - shared memory object name (eg "/cis1_log")
+     * @param slots_count - count of the slots, must be a power of two
+     * @param slot_size - max size of a record
+     * @return - pointer to the ring or nullptr on an error
+     */
+    static std::unique_ptr<ShmRing> Create(const std::string &name, std::uint32_t slots_count, std::uint32_t slot_size) {
+        if (slots_count == 0 || (slots_count & (slots_count - 1)) != 0 || slot_size == 0) {
+            return nullptr;
+        }
+
+        const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT, 0600);
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        const auto size = MappingSize(slots_count, slot_size);
+        struct stat shm_stat{};
+        if (::fstat(fd, &shm_stat) != 0
+            || (static_cast<std::size_t>(shm_stat.st_size) != size && ::ftruncate(fd, size) != 0)) {
+            ::close(fd);
+            return nullptr;
+        }
+
+        std::unique_ptr<ShmRing> ring(Map(fd, size));
+        if (!ring) {
+            return nullptr;
+        }
+
+        auto *header = ring->m_header;
+        const bool is_attached = header->magic.load(std::memory_order_acquire) == magic_k
+                                 && header->slots_count == slots_count
+                                 && header->slot_size == slot_size;
+        if (!is_attached) {
+            header->magic.store(0, std::memory_order_relaxed);
+            header->slots_count = slots_count;
+            header->slot_size = slot_size;
+            header->tail.store(0, std::memory_order_relaxed);
+            header->head.store(0, std::memory_order_relaxed);
+            header->dropped.store(0, std::memory_order_relaxed);
+            header->recovered.store(0, std::memory_order_relaxed);
+            header->truncated.store(0, std::memory_order_relaxed);
+
+            ring->InitGeometry();
+            for (std::uint64_t i = 0; i < slots_count; ++i) {
+                auto *slot = ring->SlotAt(i);
+                slot->writer_pid.store(0, std::memory_order_relaxed);
+                slot->sequence.store(i, std::memory_order_relaxed);
+            }
+
+            header->magic.store(magic_k, std::memory_order_release);
+        } else {
+            ring->InitGeometry();
+        }
+
+        return ring;
+    }
+
+    /**
+     * Attach to the ring created by the consumer.
+     * @param name - shared memory object name
+     * @return - pointer to the ring or nullptr if the ring doesn't exist
+     */
+    static std::unique_ptr<ShmRing> Open(const std::string &name) {
+        const int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        struct stat shm_stat{};
+        if (::fstat(fd, &shm_stat) != 0 || static_cast<std::size_t>(shm_stat.st_size) < sizeof(Header)) {
+            ::close(fd);
+            return nullptr;
+        }
+
+        std::unique_ptr<ShmRing> ring(Map(fd, static_cast<std::size_t>(shm_stat.st_size)));
+        if (!ring) {
+            return nullptr;
+        }
+
+        const auto *header = ring->m_header;
+        if (header->magic.load(std::memory_order_acquire) != magic_k
+            || MappingSize(header->slots_count, header->slot_size) > ring->m_size) {
+            return nullptr;
+        }
+
+        ring->InitGeometry();
+        return ring;
+    }
+
+    /**
+     * Remove the shared memory object name, the attached processes keep their mappings.
+     * @param name - shared memory object name
+     */
+    static void Unlink(const std::string &name) {
+        ::shm_unlink(name.c_str());
+    }
+
+    ShmRing(const ShmRing &) = delete;
+
+    ShmRing &operator=(const ShmRing &) = delete;
+
+    ~ShmRing() {
+        ::munmap(m_header, m_size);
+    }
+
+    /**
+     * Reserve a slot for a record.
+     * @return - reserved slot or std::nullopt if the ring is full or the slot has been recovered
+     *           before the claim (the record is counted as dropped)
+     */
+    std::optional<Reservation> Reserve() {
+        auto &tail = m_header->tail;
+        auto position = tail.load(std::memory_order_relaxed);
+        while (true) {
+            auto *slot = SlotAt(position);
+            const auto sequence = slot->sequence.load(std::memory_order_acquire);
+            // the claimed slot is compared by the position of its lap
+            const auto difference = static_cast<std::int64_t>((sequence & ~claimed_bit_k) - position);
+
+            if (difference == 0 && (sequence & claimed_bit_k) == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    return Claim(slot, position);
+                }
+            } else if (difference < 0) {
+                // the consumer hasn't released the slot of the previous lap
+                m_header->dropped.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Publish the reserved slot.
+     * @param reservation - reserved slot
+     * @param level - level of the record
+     * @param size - size of the record written to the reservation data
+     * @return - false if the slot has been recovered by the consumer (the record is counted as dropped),
+     *           which is possible only if the producer pid is not visible to the consumer (eg a pid namespace)
+     */
+    bool Commit(const Reservation &reservation, int level, std::size_t size) {
+        auto *slot = SlotAt(reservation.position);
+        slot->level = level;
+        slot->size = static_cast<std::uint32_t>(size < m_slot_size ? size : m_slot_size);
+
+        auto expected = reservation.position | claimed_bit_k;
+        if (!slot->sequence.compare_exchange_strong(expected, reservation.position + 1,
+                                                    std::memory_order_release, std::memory_order_relaxed)) {
+            m_header->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Push a record to the ring (the record is truncated to the slot size and counted).
+     * @param level - level of the record
+     * @param record - serialized record
+     * @return - false if the ring is full and the record is dropped
+     */
+    bool Push(int level, std::string_view record) {
+        const auto reservation = Reserve();
+        if (!reservation) {
+            return false;
+        }
+
+        auto size = record.size();
+        if (size > reservation->capacity) {
+            size = reservation->capacity;
+            m_header->truncated.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::memcpy(reservation->data, record.data(), size);
+        return Commit(*reservation, level, size);
+    }
+
+    /**
+     * Handle the published records in order. The method must be called by the single consumer.
+     * @param fn - function that is called as fn(level, record) for every record
+     * @param stale_timeout - timeout after which a reserved slot that is not claimed is recovered
+     * @return - count of the handled records
+     */
+    template<typename Fn>
+    std::size_t Drain(Fn &&fn, std::chrono::milliseconds stale_timeout = std::chrono::milliseconds(1000)) {
+        std::size_t handled = 0;
+        auto &head = m_header->head;
+        auto position = head.load(std::memory_order_relaxed);
+
+        while (true) {
+            auto *slot = SlotAt(position);
+            const auto sequence = slot->sequence.load(std::memory_order_acquire);
+
+            if (sequence == position + 1) {
+                const auto size = slot->size < m_slot_size ? slot->size : m_slot_size;
+                fn(slot->level, std::string_view(Data(slot), size));
+                ++handled;
+                Release(slot, position);
+            } else if (m_header->tail.load(std::memory_order_acquire) <= position) {
+                // the ring is empty
+                break;
+            } else if (!IsAbandoned(slot, position, sequence, stale_timeout)) {
+                // the slot is being written
+                break;
+            } else if (!Recover(slot, position, sequence)) {
+                // the slot has been claimed or published meanwhile
+                continue;
+            }
+
+            ++position;
+            head.store(position, std::memory_order_release);
+        }
+
+        return handled;
+    }
+
+    /**
+     * @return - counters of the ring
+     */
+    [[nodiscard]]
+    Stats GetStats() const {
+        return {m_header->dropped.load(std::memory_order_relaxed),
+                m_header->recovered.load(std::memory_order_relaxed),
+                m_header->truncated.load(std::memory_order_relaxed)};
+    }
+
+private:
+    static constexpr std::uint64_t magic_k = 0x53434c52494e4732; // "SCLRING2"
+
+    /**
+     * Bit of the sequence number of a slot claimed by a producer, the other bits are the position of the slot.
+     */
+    static constexpr std::uint64_t claimed_bit_k = std::uint64_t(1) << 63;
+
+    static constexpr std::size_t cache_line_k = 64;
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free
+                  && std::atomic<std::int32_t>::is_always_lock_free,
+                  "the shared ring requires the lock-free atomics");
+
+    struct Header {
+        std::atomic<std::uint64_t> magic;
+        std::uint32_t slots_count;
+        std::uint32_t slot_size;
+        alignas(cache_line_k) std::atomic<std::uint64_t> tail;
+        alignas(cache_line_k) std::atomic<std::uint64_t> head;
+        alignas(cache_line_k) std::atomic<std::uint64_t> dropped;
+        std::atomic<std::uint64_t> recovered;
+        std::atomic<std::uint64_t> truncated;
+    };
+
+    /**
+     * Slot header, the record data follows the header.
+     */
+    struct alignas(cache_line_k) Slot {
+        std::atomic<std::uint64_t> sequence;
+        std::atomic<std::int32_t> writer_pid;
+        std::int32_t level;
+        std::uint32_t size;
+    };
+
+    static inline std::size_t SlotStride(std::uint32_t slot_size) {
+        return (sizeof(Slot) + slot_size + cache_line_k - 1) / cache_line_k * cache_line_k;
+    }
+
+    static inline std::size_t MappingSize(std::uint32_t slots_count, std::uint32_t slot_size) {
+        return sizeof(Header) + SlotStride(slot_size) * slots_count;
+    }
+
+    static inline char *Data(Slot *slot) {
+        return reinterpret_cast<char *>(slot + 1);
+    }
+
+    /**
+     * Map the shared memory object, the descriptor is closed.
+     */
+    static ShmRing *Map(int fd, std::size_t size) {
+        void *memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            return nullptr;
+        }
+
+        return new ShmRing(static_cast<Header *>(memory), size);
+    }
+
+    ShmRing(Header *header, std::size_t size)
+        : m_header(header),
+          m_size(size) {
+    }
+
+    void InitGeometry() {
+        m_mask = m_header->slots_count - 1;
+        m_slot_size = m_header->slot_size;
+        m_slot_stride = SlotStride(m_slot_size);
+        m_slots = reinterpret_cast<char *>(m_header) + sizeof(Header);
+    }
+
+    inline Slot *SlotAt(std::uint64_t position) const {
+        return reinterpret_cast<Slot *>(m_slots + (position & m_mask) * m_slot_stride);
+    }
+
+    /**
+     * Claim the reserved slot, so the consumer can't recover it without the producer pid check.
+     * @return - reserved slot or std::nullopt if the consumer has recovered the slot before the claim
+     */
+    std::optional<Reservation> Claim(Slot *slot, std::uint64_t position) {
+        auto expected = position;
+        if (!slot->sequence.compare_exchange_strong(expected, position | claimed_bit_k,
+                                                    std::memory_order_acquire, std::memory_order_relaxed)) {
+            m_header->dropped.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        // the pid allows the consumer to recover the slot if the producer crashes
+        slot->writer_pid.store(static_cast<std::int32_t>(::getpid()), std::memory_order_release);
+        return Reservation{position, Data(slot), m_slot_size};
+    }
+
+    /**
+     * Release the published slot for the next lap.
+     */
+    void Release(Slot *slot, std::uint64_t position) {
+        slot->writer_pid.store(0, std::memory_order_relaxed);
+        slot->sequence.store(position + m_mask + 1, std::memory_order_release);
+        m_stale_position.reset();
+    }
+
+    /**
+     * Release the abandoned slot for the next lap unless it has been claimed or published meanwhile.
+     * @param slot - abandoned slot
+     * @param position - slot position
+     * @param sequence - sequence number of the slot checked by IsAbandoned()
+     * @return - true if the slot is recovered
+     */
+    bool Recover(Slot *slot, std::uint64_t position, std::uint64_t sequence) {
+        // the dead pid is cleared before the slot is released, so the next lap doesn't inherit it
+        // (the pid of an unclaimed slot is not cleared, since the producer may claim the slot and store its pid)
+        if ((sequence & claimed_bit_k) != 0) {
+            slot->writer_pid.store(0, std::memory_order_relaxed);
+        }
+
+        if (!slot->sequence.compare_exchange_strong(sequence, position + m_mask + 1,
+                                                    std::memory_order_acq_rel, std::memory_order_acquire)) {
+            // the producer has claimed the slot meanwhile, the stale timeout is restarted
+            m_stale_position.reset();
+            return false;
+        }
+
+        m_header->recovered.fetch_add(1, std::memory_order_relaxed);
+        m_stale_position.reset();
+        return true;
+    }
+
+    /**
+     * Check if the reserved slot will never be published.
+     * A claimed slot is never abandoned while its producer is alive, since the producer writes the slot
+     * until the Commit(). A producer that is stalled before the claim loses the slot, its late claim fails.
+     * @param slot - reserved slot
+     * @param position - slot position
+     * @param sequence - sequence number of the slot
+     * @param stale_timeout - timeout after which a slot that is not claimed is abandoned
+     * @return - true if the producer of the claimed slot is dead or the slot is not claimed for the stale_timeout
+     */
+    bool IsAbandoned(Slot *slot, std::uint64_t position, std::uint64_t sequence,
+                     std::chrono::milliseconds stale_timeout) {
+        if (sequence == (position | claimed_bit_k)) {
+            const auto pid = slot->writer_pid.load(std::memory_order_acquire);
+            // the pid is not stored yet if the producer has just claimed the slot
+            return pid != 0 && ::kill(pid, 0) != 0 && errno == ESRCH;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (m_stale_position != position) {
+            m_stale_position = position;
+            m_stale_since = now;
+            return false;
+        }
+
+        // the producer may crash between the reservation and the claim
+        return now - m_stale_since >= stale_timeout;
+    }
+
+    Header *m_header;
+
+    std::size_t m_size;
+
+    std::uint64_t m_mask = 0;
+
+    std::size_t m_slot_size = 0;
+
+    std::size_t m_slot_stride = 0;
+
+    char *m_slots = nullptr;
+
+    /**
+     * Position of the reserved slot that the consumer waits for and the waiting start time.
+     */
+    std::optional<std::uint64_t> m_stale_position;
+
+    std::chrono::steady_clock::time_point m_stale_since;
+};
+
+} // end of scl::detail
+
+#endif
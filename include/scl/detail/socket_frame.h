@@ -0,0 +1,71 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the record frames of the socket recorder and the socket collector:
+ * the level digit, the serialized record and the line break.
+ * The control characters of the record are escaped (see sanitize.h), so a frame always takes a single line.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <scl/levels.h>
+#include <scl/detail/sanitize.h>
+
+namespace scl::detail {
+
+/**
+ * Record of a frame.
+ */
+struct SocketFrame {
+    Level level;
+    std::string_view text;
+};
+
+/**
+ * Append the frame of a record.
+ * @tparam RecordT - type of record
+ * @param dst - destination string
+ * @param record - record
+ * @param align - align the record attributes
+ */
+template<typename RecordT>
+void AppendSocketFrame(std::string &dst, const RecordT &record, bool align) {
+    dst += static_cast<char>('0' + static_cast<int>(record.level));
+
+    const auto record_begin = dst.size();
+    if (align) {
+        record.AppendAlignedString(dst);
+    } else {
+        record.AppendString(dst);
+    }
+
+    SanitizeControlChars(dst, record_begin);
+    dst += '\n';
+}
+
+/**
+ * Parse a frame.
+ * @param frame - frame without the line break
+ * @return - record of the frame or nullopt if the frame doesn't start with a level digit (Action..Debug)
+ */
+inline std::optional<SocketFrame> ParseSocketFrame(std::string_view frame) {
+    if (frame.empty()
+        || frame.front() < '0' + static_cast<int>(Level::Action)
+        || frame.front() > '0' + static_cast<int>(Level::Debug)) {
+        return std::nullopt;
+    }
+
+    return SocketFrame{static_cast<Level>(frame.front() - '0'), frame.substr(1)};
+}
+
+} // end of scl::detail
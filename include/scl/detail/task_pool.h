@@ -0,0 +1,102 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace scl::detail {
+
+/**
+ * Fixed pool of the worker threads that run the posted tasks in the posting order.
+ */
+class TaskPool {
+public:
+    /**
+     * @param threads_count - count of the worker threads (at least one)
+     */
+    explicit TaskPool(std::size_t threads_count) {
+        threads_count = threads_count == 0 ? 1 : threads_count;
+        for (std::size_t i = 0; i < threads_count; ++i) {
+            m_threads.emplace_back([this] { Work(); });
+        }
+    }
+
+    TaskPool(const TaskPool &) = delete;
+
+    TaskPool &operator=(const TaskPool &) = delete;
+
+    /**
+     * The dtor waits for the posted tasks.
+     */
+    ~TaskPool() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_is_stopped = true;
+        }
+
+        m_cv.notify_all();
+        for (auto &thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * Post the task.
+     * @param task - task
+     * @return - future that is ready when the task is done
+     */
+    std::future<void> Post(std::function<void()> task) {
+        std::packaged_task<void()> packaged_task(std::move(task));
+        auto future = packaged_task.get_future();
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.push_back(std::move(packaged_task));
+        }
+
+        m_cv.notify_one();
+        return future;
+    }
+
+private:
+    void Work() {
+        while (true) {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock lock(m_mutex);
+                m_cv.wait(lock, [this] { return m_is_stopped || !m_tasks.empty(); });
+                if (m_tasks.empty()) {
+                    return;
+                }
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    std::mutex m_mutex;
+
+    std::condition_variable m_cv;
+
+    std::deque<std::packaged_task<void()>> m_tasks;
+
+    bool m_is_stopped = false;
+
+    std::vector<std::thread> m_threads;
+};
+
+} // end of scl::detail
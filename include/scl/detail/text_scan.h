@@ -0,0 +1,132 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the functions that find the structural characters of the plain and aligned text records:
+ * the line breaks and the '|' characters of the " | " separators.
+ * A 64-byte block is compared by 32 (AVX2) or 16 (SSE2) bytes at once and the results are packed to the bitmasks,
+ * so the caller visits the structural characters only and never looks at the other bytes.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace scl::detail {
+
+namespace text_scan {
+constexpr std::size_t block_size_k = 64;
+} // end of text_scan
+
+/**
+ * Structural characters of a block: the bit i is set if the byte i of the block is the character.
+ */
+struct StructuralMasks {
+    std::uint64_t line_breaks;
+    std::uint64_t separators;
+};
+
+/**
+ * @param mask - non-zero mask
+ * @return - index of the lowest set bit
+ */
+inline std::size_t LowestBit(std::uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return index;
+#else
+    return static_cast<std::size_t>(__builtin_ctzll(mask));
+#endif
+}
+
+#if defined(__AVX2__)
+/**
+ * @param data - data of the text_scan::block_size_k bytes
+ * @return - structural characters of the block
+ */
+inline StructuralMasks FindStructural64(const char *data) {
+    const __m256i line_break = _mm256_set1_epi8('\n');
+    const __m256i separator = _mm256_set1_epi8('|');
+
+    const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 32));
+
+    const auto pack = [](__m256i low_result, __m256i high_result) {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(low_result)))
+               | (static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(high_result))) << 32);
+    };
+
+    return {pack(_mm256_cmpeq_epi8(low, line_break), _mm256_cmpeq_epi8(high, line_break)),
+            pack(_mm256_cmpeq_epi8(low, separator), _mm256_cmpeq_epi8(high, separator))};
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+/**
+ * @param data - data of the text_scan::block_size_k bytes
+ * @return - structural characters of the block
+ */
+inline StructuralMasks FindStructural64(const char *data) {
+    const __m128i line_break = _mm_set1_epi8('\n');
+    const __m128i separator = _mm_set1_epi8('|');
+
+    StructuralMasks masks{0, 0};
+    for (std::size_t i = 0; i < 4; ++i) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 16));
+        const auto shift = 16 * i;
+        masks.line_breaks |= static_cast<std::uint64_t>(
+                                 static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, line_break)))) << shift;
+        masks.separators |= static_cast<std::uint64_t>(
+                                static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, separator)))) << shift;
+    }
+
+    return masks;
+}
+#else
+/**
+ * @param data - data of the text_scan::block_size_k bytes
+ * @return - structural characters of the block
+ */
+inline StructuralMasks FindStructural64(const char *data) {
+    StructuralMasks masks{0, 0};
+    for (std::size_t i = 0; i < text_scan::block_size_k; ++i) {
+        masks.line_breaks |= static_cast<std::uint64_t>(data[i] == '\n') << i;
+        masks.separators |= static_cast<std::uint64_t>(data[i] == '|') << i;
+    }
+
+    return masks;
+}
+#endif
+
+/**
+ * Find the structural characters of a block that may be shorter than text_scan::block_size_k bytes
+ * (the tail of the data), the bytes after the size are not read.
+ * @param data - block data
+ * @param size - block size
+ * @return - structural characters of the block
+ */
+inline StructuralMasks FindStructuralTail(const char *data, std::size_t size) {
+    if (size >= text_scan::block_size_k) {
+        return FindStructural64(data);
+    }
+
+    char block[text_scan::block_size_k] = {0};
+    std::memcpy(block, data, size);
+    return FindStructural64(block);
+}
+
+} // end of scl::detail
@@ -0,0 +1,146 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains the client Unix domain socket of the socket recorders.
+ */
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#define SCL_HAS_UNIX_SOCKET
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+// SIGPIPE is disabled by the SO_NOSIGPIPE option on the platforms without MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace scl::detail {
+
+/**
+ * Check if the path fits the sockaddr_un address.
+ * @param path - socket path
+ * @return - true if the path is not empty and fits the address
+ */
+inline bool IsUnixSocketPathCorrect(const std::string &path) {
+    return !path.empty() && path.size() < sizeof(sockaddr_un::sun_path);
+}
+
+/**
+ * Fill the address of the Unix domain socket.
+ * @param path - socket path, must be correct (see IsUnixSocketPathCorrect())
+ * @return - socket address
+ */
+inline sockaddr_un MakeUnixSocketAddress(const std::string &path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+/**
+ * Connected client Unix domain socket.
+ */
+class UnixSocket {
+public:
+    UnixSocket() = default;
+
+    UnixSocket(const UnixSocket &) = delete;
+
+    UnixSocket &operator=(const UnixSocket &) = delete;
+
+    ~UnixSocket() {
+        Close();
+    }
+
+    /**
+     * Connect to the socket, the current connection is closed.
+     * @param path - socket path
+     * @param type - SOCK_STREAM or SOCK_SEQPACKET
+     * @param send_timeout - timeout of the sending, a timed out socket is considered as disconnected
+     * @return - true if the socket is connected
+     */
+    bool Connect(const std::string &path, int type, std::chrono::milliseconds send_timeout) {
+        Close();
+
+        m_fd = ::socket(AF_UNIX, type, 0);
+        if (m_fd < 0) {
+            return false;
+        }
+
+        ::fcntl(m_fd, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+        const int no_sigpipe = 1;
+        ::setsockopt(m_fd, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+
+        timeval timeout{};
+        timeout.tv_sec = static_cast<decltype(timeout.tv_sec)>(send_timeout.count() / 1000);
+        timeout.tv_usec = static_cast<decltype(timeout.tv_usec)>(send_timeout.count() % 1000 * 1000);
+        ::setsockopt(m_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        const auto address = MakeUnixSocketAddress(path);
+        if (::connect(m_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Send the buffers by a single sendmsg().
+     * @param buffers - buffers to send
+     * @param count - count of the buffers
+     * @return - count of the sent bytes or -1 on an error (errno is set)
+     */
+    inline ssize_t Send(const iovec *buffers, std::size_t count) {
+        msghdr message{};
+        message.msg_iov = const_cast<iovec *>(buffers);
+        message.msg_iovlen = static_cast<decltype(message.msg_iovlen)>(count);
+
+        ssize_t sent;
+        do {
+            sent = ::sendmsg(m_fd, &message, MSG_NOSIGNAL);
+        } while (sent < 0 && errno == EINTR);
+
+        return sent;
+    }
+
+    void Close() {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    [[nodiscard]]
+    inline bool IsConnected() const {
+        return m_fd >= 0;
+    }
+
+private:
+    int m_fd = -1;
+};
+
+} // end of scl::detail
+
+#endif
@@ -8,22 +8,33 @@
 
 #pragma once
 
+#include <array>
 #include <fstream>
 #include <map>
 #include <set>
 #include <mutex>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
 #include <variant>
+#include <vector>
 
 #include <scl/levels.h>
 #include <scl/recorder.h>
 #include <scl/record.h>
+#include <scl/sync.h>
 #include <scf/detail/type_matching.h>
+#include <scl/detail/bloom_filter.h>
+#include <scl/detail/log_index.h>
 #include <scl/detail/misc.h>
+#include <scl/detail/msgpack_interner.h>
+#include <scl/detail/sanitize.h>
+#include <scl/detail/shared_file.h>
 
 namespace scl {
 
-template<typename RecordT>
+template<typename RecordT, typename SyncT>
 class FileRecorder;
 
 namespace fs = std::filesystem;
@@ -31,15 +42,18 @@ namespace fs = std::filesystem;
 /**
  * Non-moving file recorder pointer alias.
  */
-template<typename RecordT>
-using FileRecorderPtr = std::unique_ptr<FileRecorder<RecordT>>;
+template<typename RecordT, typename SyncT = sync::Mutex>
+using FileRecorderPtr = std::unique_ptr<FileRecorder<RecordT, SyncT>>;
 
 /**
  * File recorder that implement the IRecorder interface.
  * The recorder is used to write records to a file
  * and allows automatic rotation (by substituting values instead of filename template specifiers).
+ * @tparam RecordT - type of record
+ * @tparam SyncT - synchronization strategy of the writing (sync::Mutex by default,
+ *                 sync::None for single-threaded applications or sync::SpinLock)
  */
-template<typename RecordT>
+template<typename RecordT, typename SyncT = sync::Mutex>
 class FileRecorder : public IRecorder<RecordT> {
 public:
     /**
@@ -50,12 +64,16 @@ public:
         PathIsNotDirectory,
         IncorrectFileNameTemplate,
         CantOpenFile,
+        MultiProcessNotSupported,
+        IncorrectInternOptions,
+        IncorrectIndexOptions,
+        IncorrectBloomFilterOptions,
     };
 
     /**
      * Initialization result: ether pointer to an initialized file recorder or an error info.
      */
-    using InitResult = std::variant<FileRecorderPtr<RecordT>, InitError>;
+    using InitResult = std::variant<FileRecorderPtr<RecordT, SyncT>, InitError>;
 
     /**
      * File recorder options.
@@ -84,8 +102,68 @@ public:
 
         /**
          * Allow to align entry attributes, if the values is true.
+         * The option is equivalent to the RecordFormat::Aligned format.
          */
         bool align = false;
+
+        /**
+         * Serialization format of the records.
+         * The binary records (see IsBinaryFormat()) are not separated by line breaks.
+         */
+        RecordFormat format = RecordFormat::Plain;
+
+        /**
+         * Escape the control characters and the backslash of the plain and aligned records ("\n" -> "\\n" etc.),
+         * so a multi-line message takes a single line. The option doesn't affect the JSON Lines and MessagePack records.
+         */
+        bool sanitize = false;
+
+        /**
+         * Share the log file with other processes that use the same log_directory and file_name_template.
+         * Every record is appended by a single write(), so the records of the processes never interleave,
+         * and the rotation is coordinated by the ".<file_name_template>.lock" file within the log_directory:
+         * a process that detects the overflow rotates the file and other processes follow it.
+         * Note the mode is supported on POSIX systems only.
+         */
+        bool multi_process = false;
+
+        /**
+         * Max count of the interned strings of the MessagePack records, the interning is disabled if it is not set.
+         * The repeated string fields (session id, action, handler etc.) are written to a log file once
+         * and the records refer to them by the small ids (see MsgPackReader).
+         * Note the option requires the RecordFormat::MessagePack format and is not supported in the multi_process mode.
+         */
+        std::optional<std::size_t> intern_capacity = std::nullopt;
+
+        /**
+         * Write the sparse index of every log file to the "<log file>.idx" sidecar (see LogIndexReader).
+         * An index entry maps the time and the sequence number of a record to its offset within the log file
+         * and is appended every index_records_interval records or index_bytes_interval bytes.
+         * Note the option is supported for the text formats only and is not supported in the multi_process mode.
+         * The plain and aligned records must be sanitized (see the sanitize option),
+         * since the records of a reopened file are counted by the line breaks.
+         */
+        bool index = false;
+
+        /**
+         * Max count of the records between the index entries.
+         */
+        std::size_t index_records_interval = 4096;
+
+        /**
+         * Max count of the bytes between the index entries.
+         */
+        std::size_t index_bytes_interval = 1024 * 1024;
+
+        /**
+         * Size (in bytes) of the Bloom filter of every log file, the filter is disabled if the value is not set.
+         * The filter of the session id, action and handler values (if the records have such fields)
+         * is built while the file is written and is saved to the "<log file>.bloom" sidecar when the file is closed,
+         * so a search skips the files that cannot contain a value (see the log_search tool).
+         * About 10 bits per distinct value keep the false positives near 1%.
+         * Note the option is not supported in the multi_process mode.
+         */
+        std::optional<std::size_t> bloom_filter_size = std::nullopt;
     };
 
     static std::string ToStr(InitError err) {
@@ -98,6 +176,14 @@ public:
                 return "IncorrectFileNameTemplate";
             case InitError::CantOpenFile:
                 return "CantOpenFile";
+            case InitError::MultiProcessNotSupported:
+                return "MultiProcessNotSupported";
+            case InitError::IncorrectInternOptions:
+                return "IncorrectInternOptions";
+            case InitError::IncorrectIndexOptions:
+                return "IncorrectIndexOptions";
+            case InitError::IncorrectBloomFilterOptions:
+                return "IncorrectBloomFilterOptions";
             default:
                 return "Unknown";
         }
@@ -137,12 +223,41 @@ public:
             return Error::IncorrectFileNameTemplate;
         }
 
-        std::unique_ptr<FileRecorder<RecordT>> instance;
-        instance.reset(new FileRecorder<RecordT>(options,
+        if (options.intern_capacity
+            && (options.format != RecordFormat::MessagePack || options.multi_process || *options.intern_capacity == 0)) {
+            return Error::IncorrectInternOptions;
+        }
+
+        // the index reader counts the records by the line breaks, so a plain record must take a single line
+        const bool is_single_line = options.format == RecordFormat::JsonLines || options.sanitize;
+        if (options.index
+            && (IsBinaryFormat(options.format) || !is_single_line || options.multi_process
+                || options.index_records_interval == 0 || options.index_bytes_interval == 0)) {
+            return Error::IncorrectIndexOptions;
+        }
+
+        if (options.bloom_filter_size && (options.multi_process || *options.bloom_filter_size == 0)) {
+            return Error::IncorrectBloomFilterOptions;
+        }
+
+        FileRecorderPtr<RecordT, SyncT> instance;
+        instance.reset(new FileRecorder(options,
                                                  std::move(specifier_positions),
                                                  std::move(specifiers)));
 
-        // there is no need to lock a mutex,
+        if (options.multi_process) {
+#ifdef SCL_HAS_SHARED_FILE
+            if (!instance->OpenSharedFile()) {
+                return Error::CantOpenFile;
+            }
+
+            return instance;
+#else
+            return Error::MultiProcessNotSupported;
+#endif
+        }
+
+        // there is no need to lock,
         // because the function should be called once on an application start
         const auto open_file_result = instance->OpenFile();
         if (open_file_result != OpenFileResult::Ok) {
@@ -153,14 +268,25 @@ public:
     }
 
     /**
-     * Default derived dtor.
+     * Derived dtor that saves the Bloom filter of the opened file.
      */
-    ~FileRecorder() final = default;
+    ~FileRecorder() final {
+        if (m_bloom_filter && m_log_file.is_open()) {
+            SaveBloomFilter();
+        }
+    }
 
     /**
      * @overload
      */
     void OnRecord(const RecordT &record) final {
+#ifdef SCL_HAS_SHARED_FILE
+        if (m_shared_file) {
+            WriteShared(record);
+            return;
+        }
+#endif
+
         // if last time we couldn't open a file, don't try to do it again
         if (!m_log_file.is_open()) {
             // there is no need to check, open and write to file
@@ -169,13 +295,28 @@ public:
 
         // a log file is opened already
 
-        const auto record_str
-            = m_options.align
-              ? record.ToAlignedString()
-              : record.ToString();
+        // the buffers are reused by the records of the thread
+        thread_local std::string interned_str;
+        thread_local std::vector<std::uint32_t> interned_ids;
+        interned_ids.clear();
+
+        std::string record_str;
+        if (m_interner) {
+            // the repeated string fields are interned while the record is serialized
+            detail::MsgPackInterner::Writer writer(*m_interner, interned_ids);
+            record.AppendMsgPack(record_str, writer);
+        } else {
+            record.AppendFormatted(record_str, m_format);
+            if (m_sanitize) {
+                detail::SanitizeControlChars(record_str);
+            }
+        }
+
+        std::array<std::uint64_t, 3> bloom_hashes{};
+        const std::size_t bloom_hashes_count = m_bloom_filter ? detail::RecordBloomHashes(record, bloom_hashes) : 0;
 
-        // lock the mutex here, before the OpenFile() will be called
-        const auto lock = LockMutex();
+        // lock here, before the OpenFile() will be called
+        std::lock_guard lock(m_sync);
         const CheckFileSizeResult size_result = CheckFileSize(m_log_file_path, record_str.size());
         if (size_result != CheckFileSizeResult::Allowed
             // the file could be deleted or overflowed, try to open file again
@@ -185,7 +326,30 @@ public:
             return;
         }
 
-        m_log_file << record_str << std::endl;
+        for (std::size_t i = 0; i < bloom_hashes_count; ++i) {
+            m_bloom_filter->Add(bloom_hashes[i]);
+        }
+
+        if (IsBinaryFormat(m_format)) {
+            if (!interned_ids.empty()) {
+                // the definitions of the strings that are new for the file precede the record
+                interned_str.clear();
+                m_interner->AppendDefinitions(interned_ids, interned_str);
+                m_log_file.write(interned_str.data(), static_cast<std::streamsize>(interned_str.size()));
+            }
+
+            m_log_file.write(record_str.data(), static_cast<std::streamsize>(record_str.size()));
+            m_log_file.flush();
+        } else {
+            if (m_index && m_index->IsEntryDue()) {
+                m_index->AddEntry(detail::RecordTimeSeconds(record));
+            }
+
+            m_log_file << record_str << std::endl;
+            if (m_index) {
+                m_index->OnWritten(record_str.size() + 1);
+            }
+        }
     }
 
 private:
@@ -312,18 +476,139 @@ private:
                           SpecifierPositions &&file_name_specifier_positions,
                           SpecifierSet &&file_name_specifiers)
         : m_options(std::move(options)),
+          m_format(m_options.align && m_options.format == RecordFormat::Plain ? RecordFormat::Aligned
+                                                                              : m_options.format),
+          m_sanitize(m_options.sanitize
+                     && (m_format == RecordFormat::Plain || m_format == RecordFormat::Aligned)),
           m_file_name_specifier_positions(std::move(file_name_specifier_positions)),
           m_file_name_specifiers(std::move(file_name_specifiers)) {
+        if (m_options.intern_capacity) {
+            m_interner = std::make_unique<detail::MsgPackInterner>(*m_options.intern_capacity);
+        }
+
+        if (m_options.index) {
+            m_index = std::make_unique<detail::LogIndexWriter>(m_options.index_records_interval,
+                                                               m_options.index_bytes_interval);
+        }
+
+        if (m_options.bloom_filter_size) {
+            m_bloom_filter.emplace(*m_options.bloom_filter_size);
+        }
     }
 
     /**
      * Try to open the log file at the specified path with the name corresponding to the specified template.
-     * Note: the method should be called before the mutex will be locked.
+     * Note: the method should be called after the m_sync will be locked.
      * @return - true if the file has been opened successfully, else false.
      */
     OpenFileResult OpenFile() {
         using Result = OpenFileResult;
-        // if the method was called, the path_info should be set
+
+        if (m_bloom_filter && m_log_file.is_open()) {
+            SaveBloomFilter();
+        }
+
+        m_log_file.close();
+        m_log_file_path.clear();
+
+        if (m_interner) {
+            // a new file is a new segment of the interned strings
+            m_interner->ResetDefinitions();
+        }
+
+        const auto log_file_path = SelectFilePath();
+        if (!log_file_path) {
+            return Result::CantOpenFile;
+        }
+
+        // the indexed file is opened in the binary mode too, so the offsets of the records are exact
+        const auto mode = IsBinaryFormat(m_format) || m_index ? std::ios::app | std::ios::binary : std::ios::app;
+        m_log_file.open(*log_file_path, mode);
+        if (!m_log_file.is_open()) {
+            return Result::CantOpenFile;
+        }
+
+        if (m_index) {
+            // the logging goes on without the index if the sidecar couldn't be opened
+            m_index->Open(*log_file_path);
+        }
+
+        if (m_bloom_filter) {
+            ReopenBloomFilter(*log_file_path);
+        }
+
+        m_log_file_path = *log_file_path;
+        return Result::Ok;
+    }
+
+    /**
+     * Continue the Bloom filter of the opened log file.
+     * The sidecar is removed while the file is written, so a search never skips the file by an incomplete filter.
+     * @param log_file_path - path to the opened log file
+     */
+    void ReopenBloomFilter(const fs::path &log_file_path) {
+        m_bloom_filter->Clear();
+
+        const auto filter_path = detail::BloomFilterPath(log_file_path);
+        const auto filter = detail::BloomFilter::Load(filter_path);
+
+        // the records of a non-empty file without the filter (or with a filter of another size) are unknown,
+        // so the filter of the file is not saved
+        std::error_code ec{};
+        const auto log_file_size = fs::file_size(log_file_path, ec);
+        m_is_bloom_filter_complete = (!ec && log_file_size == 0) || (filter && m_bloom_filter->Merge(*filter));
+
+        fs::remove(filter_path, ec);
+    }
+
+    /**
+     * Save the Bloom filter of the log file that is going to be closed.
+     */
+    void SaveBloomFilter() {
+        if (m_is_bloom_filter_complete) {
+            m_bloom_filter->Save(detail::BloomFilterPath(m_log_file_path));
+        }
+    }
+
+#ifdef SCL_HAS_SHARED_FILE
+    /**
+     * Open the log file shared with other processes.
+     * @return - true if the file has been opened successfully, else false.
+     */
+    bool OpenSharedFile() {
+        const auto lock_path = m_options.log_directory / ("." + m_options.file_name_template + ".lock");
+        m_shared_file = detail::SharedFile::Open(lock_path, m_options.size_limit, [this] { return SelectFilePath(); });
+        return static_cast<bool>(m_shared_file);
+    }
+
+    /**
+     * Append the record to the shared log file by a single write.
+     * @param record - record
+     */
+    void WriteShared(const RecordT &record) {
+        // the buffer is reused by the records of the thread
+        thread_local std::string record_str;
+        record_str.clear();
+
+        record.AppendFormatted(record_str, m_format);
+        if (m_sanitize) {
+            detail::SanitizeControlChars(record_str);
+        }
+        if (!IsBinaryFormat(m_format)) {
+            record_str += '\n';
+        }
+
+        std::lock_guard lock(m_sync);
+        m_shared_file->Write(record_str);
+    }
+#endif
+
+    /**
+     * Select the path of the log file with the name corresponding to the specified template:
+     * the rotation iteration is increased until a file that is not overflowed is found.
+     * @return - path to the log file or std::nullopt if the file name template cannot be rotated
+     */
+    std::optional<fs::path> SelectFilePath() {
         fs::path log_file_path;
 
         // true if the file name template contains a '%n' specifier
@@ -344,9 +629,6 @@ private:
 
         m_last_file_open_time = current_time;
 
-        m_log_file.close();
-        m_log_file_path.clear();
-
         CheckFileSizeResult file_size_result;
         do {
             // number of rotation iteration should start with '1'
@@ -360,16 +642,10 @@ private:
         if (file_size_result == CheckFileSizeResult::IsOverflowed) {
             // file name template doesn't contain the "%n" specifier,
             // therefore we cannot change a file name by increasing the m_rotation_iteration
-            return Result::CantOpenFile;
+            return std::nullopt;
         }
 
-        m_log_file.open(log_file_path, std::ios::app);
-        if (!m_log_file.is_open()) {
-            return Result::CantOpenFile;
-        }
-
-        m_log_file_path = log_file_path;
-        return Result::Ok;
+        return log_file_path;
     }
 
     /**
@@ -431,21 +707,39 @@ private:
     }
 
     /**
-     * If the SCL_MULTITHREADED is defined, lock the m_mutex, else do nothing.
-     * @return mutex guard or std::nullopt
+     * File recorder's options.
      */
-    std::optional<std::lock_guard<std::mutex>> LockMutex() {
-#ifdef SCL_MULTITHREADED
-        return std::make_optional<std::lock_guard<std::mutex>>(m_record_mutex);
-#else
-        return std::nullopt;
-#endif
-    }
+    Options m_options;
 
     /**
-     * File recorder's options.
+     * Serialization format that takes the align option into account.
      */
-    Options m_options;
+    RecordFormat m_format;
+
+    /**
+     * Interner of the MessagePack records or nullptr if the interning is disabled.
+     */
+    std::unique_ptr<detail::MsgPackInterner> m_interner;
+
+    /**
+     * Writer of the index sidecar or nullptr if the index is disabled.
+     */
+    std::unique_ptr<detail::LogIndexWriter> m_index;
+
+    /**
+     * Bloom filter of the opened log file (if options.bloom_filter_size is set).
+     */
+    std::optional<detail::BloomFilter> m_bloom_filter;
+
+    /**
+     * The filter contains all the values of the opened log file.
+     */
+    bool m_is_bloom_filter_complete = false;
+
+    /**
+     * Escape the control characters of the serialized records.
+     */
+    bool m_sanitize;
 
     /**
      * Specifiers and corresponding positions that are in filename template.
@@ -477,8 +771,16 @@ private:
      */
     std::time_t m_last_file_open_time = 0;
 
-#ifdef SCL_MULTITHREADED
-    std::mutex m_record_mutex;
+    /**
+     * Synchronization of the writing.
+     */
+    SyncT m_sync;
+
+#ifdef SCL_HAS_SHARED_FILE
+    /**
+     * Log file shared with other processes (if options.multi_process is set).
+     */
+    std::unique_ptr<detail::SharedFile> m_shared_file;
 #endif
 };
 
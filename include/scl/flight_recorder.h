@@ -0,0 +1,327 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <scl/levels.h>
+#include <scl/raw_record.h>
+#include <scl/recorder.h>
+
+namespace scl {
+
+template<typename RecordT>
+class FlightRecorder;
+
+/**
+ * Non-moving flight recorder pointer alias.
+ */
+template<typename RecordT>
+using FlightRecorderPtr = std::unique_ptr<FlightRecorder<RecordT>>;
+
+/**
+ * Flight recorder that implement the IRecorder interface.
+ * The recorder keeps the last records within a preallocated in-memory ring without writing them out.
+ * When a record at or above the trigger level arrives, the kept records are dumped to the target recorder
+ * followed by the trigger record, so an error is logged with its preceding (eg debug) context.
+ * The records at or above the pass level are passed to the target immediately and are not kept.
+ *
+ * Note the logger level must allow the context records (eg Level::Debug),
+ * the pass level takes the role of the file log level then:
+ *
+ *     logger level Debug -> FlightRecorder{pass_level = Info, trigger_level = Error} -> FileRecorder<RawRecord>
+ *
+ * The records are serialized to the ring slots (a record longer than the slot is truncated),
+ * a slot is claimed by a CAS on its sequence number, so the recorder is lock-free on the logging threads.
+ * The target must be thread-safe if the recorder is used on several threads.
+ * @tparam RecordT - type of record
+ */
+template<typename RecordT>
+class FlightRecorder : public IRecorder<RecordT> {
+public:
+    /**
+     * Initialization error info.
+     */
+    enum class InitError {
+        TargetIsNull = 1,
+        IncorrectRingSize,
+    };
+
+    /**
+     * Initialization result: ether pointer to an initialized recorder or an error info.
+     */
+    using InitResult = std::variant<FlightRecorderPtr<RecordT>, InitError>;
+
+    /**
+     * Flight recorder options.
+     */
+    struct Options {
+        /**
+         * Count of the ring slots: the max count of the kept records.
+         */
+        std::size_t records_count = 1024;
+
+        /**
+         * Size of a ring slot: the max size of a kept record.
+         */
+        std::size_t record_size = 512;
+
+        /**
+         * Optional max size of the dumped records, the newest records are dumped if the limit is set.
+         */
+        std::optional<std::size_t> dump_size_limit = std::nullopt;
+
+        /**
+         * The records at or above the level trigger the dump.
+         */
+        Level trigger_level = Level::Error;
+
+        /**
+         * The records at or above the level are passed to the target immediately.
+         */
+        std::optional<Level> pass_level = std::nullopt;
+
+        /**
+         * Allow to align entry attributes, if the values is true.
+         */
+        bool align = false;
+    };
+
+    static std::string ToStr(InitError err) {
+        switch (err) {
+            case InitError::TargetIsNull:
+                return "TargetIsNull";
+            case InitError::IncorrectRingSize:
+                return "IncorrectRingSize";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /**
+     * Init a FlightRecorder instance.
+     * @param options - flight recorder options
+     * @param target - recorder of the dumped and passed records
+     * @return - ether pointer to an initialized recorder or an error info
+     */
+    static InitResult Init(const Options &options, RecorderPtr<RawRecord> target) {
+        if (!target) {
+            return InitError::TargetIsNull;
+        }
+
+        if (options.records_count == 0 || options.record_size == 0) {
+            return InitError::IncorrectRingSize;
+        }
+
+        return FlightRecorderPtr<RecordT>(new FlightRecorder(options, std::move(target)));
+    }
+
+    /**
+     * Default derived dtor.
+     */
+    ~FlightRecorder() final = default;
+
+    /**
+     * @overload
+     */
+    void OnRecord(const RecordT &record) final {
+        // the buffer is reused by the records of the thread
+        thread_local std::string record_str;
+        record_str.clear();
+
+        if (m_options.align) {
+            record.AppendAlignedString(record_str);
+        } else {
+            record.AppendString(record_str);
+        }
+
+        // the lower level value is the more important record
+        if (record.level <= m_options.trigger_level) {
+            Dump();
+            m_target->OnRecord(RawRecord(record.level, record_str));
+            return;
+        }
+
+        if (m_options.pass_level && record.level <= *m_options.pass_level) {
+            m_target->OnRecord(RawRecord(record.level, record_str));
+            return;
+        }
+
+        Keep(record.level, record_str);
+    }
+
+    /**
+     * Dump the kept records that are not dumped yet to the target.
+     */
+    void Dump() {
+        std::lock_guard lock(m_dump_mutex);
+
+        const auto head = m_head.load(std::memory_order_acquire);
+        const auto ring_begin = head > m_options.records_count ? head - m_options.records_count : 0;
+        const auto begin = std::max(ring_begin, m_dumped_until);
+        m_dumped_until = head;
+
+        m_dump_levels.clear();
+        m_dump_ends.clear();
+        m_dump_buffer.clear();
+
+        for (auto position = begin; position < head; ++position) {
+            const auto &slot = m_slots[position % m_options.records_count];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != Published(position)) {
+                // the slot is being written or is overwritten by the next lap
+                continue;
+            }
+
+            const auto size = slot.size.load(std::memory_order_relaxed);
+            const auto level = slot.level.load(std::memory_order_relaxed);
+            const auto offset = m_dump_buffer.size();
+            m_dump_buffer.resize(offset + size);
+            std::memcpy(m_dump_buffer.data() + offset, SlotData(position), size);
+
+            // the copy is valid if the slot hasn't been overwritten during the copying
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+                m_dump_buffer.resize(offset);
+                continue;
+            }
+
+            m_dump_levels.push_back(level);
+            m_dump_ends.push_back(m_dump_buffer.size());
+        }
+
+        // the newest records fit the dump size limit
+        std::size_t first = 0;
+        if (m_options.dump_size_limit) {
+            while (first < m_dump_ends.size()
+                   && m_dump_buffer.size() - RecordBegin(first) > *m_options.dump_size_limit) {
+                ++first;
+            }
+        }
+
+        for (auto i = first; i < m_dump_ends.size(); ++i) {
+            const auto record_begin = RecordBegin(i);
+            m_target->OnRecord(RawRecord(m_dump_levels[i],
+                                         std::string_view(m_dump_buffer.data() + record_begin,
+                                                          m_dump_ends[i] - record_begin)));
+        }
+    }
+
+    /**
+     * @return - count of the records that were not kept because their slot was being written by another thread
+     */
+    [[nodiscard]]
+    inline std::uint64_t Skipped() const {
+        return m_skipped.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * Ring slot header, the slot data is stored separately in m_data.
+     * The sequence is 2 * position + 1 while the slot is being written and 2 * position + 2 after the writing.
+     */
+    struct Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<std::size_t> size{0};
+        std::atomic<Level> level{Level::Debug};
+    };
+
+    /**
+     * Private ctor.
+     * @param options - flight recorder options
+     * @param target - recorder of the dumped and passed records
+     */
+    FlightRecorder(const Options &options, RecorderPtr<RawRecord> target)
+        : m_options(options),
+          m_target(std::move(target)),
+          m_slots(new Slot[options.records_count]),
+          m_data(new char[options.records_count * options.record_size]) {
+    }
+
+    static inline std::uint64_t Writing(std::uint64_t position) {
+        return 2 * position + 1;
+    }
+
+    static inline std::uint64_t Published(std::uint64_t position) {
+        return 2 * position + 2;
+    }
+
+    inline char *SlotData(std::uint64_t position) const {
+        return m_data.get() + position % m_options.records_count * m_options.record_size;
+    }
+
+    inline std::size_t RecordBegin(std::size_t index) const {
+        return index == 0 ? 0 : m_dump_ends[index - 1];
+    }
+
+    /**
+     * Copy the serialized record to the next ring slot.
+     */
+    void Keep(Level level, std::string_view record_str) {
+        const auto position = m_head.fetch_add(1, std::memory_order_acq_rel);
+        auto &slot = m_slots[position % m_options.records_count];
+
+        auto sequence = slot.sequence.load(std::memory_order_relaxed);
+        // the slot is being written by another thread or is written by a newer lap already
+        if ((sequence & 1) != 0 || sequence >= Writing(position)
+            || !slot.sequence.compare_exchange_strong(sequence, Writing(position), std::memory_order_acquire)) {
+            m_skipped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const auto size = std::min(record_str.size(), m_options.record_size);
+        std::memcpy(SlotData(position), record_str.data(), size);
+        slot.size.store(size, std::memory_order_relaxed);
+        slot.level.store(level, std::memory_order_relaxed);
+        slot.sequence.store(Published(position), std::memory_order_release);
+    }
+
+    /**
+     * Flight recorder options.
+     */
+    Options m_options;
+
+    RecorderPtr<RawRecord> m_target;
+
+    std::unique_ptr<Slot[]> m_slots;
+
+    std::unique_ptr<char[]> m_data;
+
+    /**
+     * Position of the next kept record.
+     */
+    std::atomic<std::uint64_t> m_head{0};
+
+    std::atomic<std::uint64_t> m_skipped{0};
+
+    /**
+     * The dumps are serialized, the members below are accessed under the lock.
+     */
+    std::mutex m_dump_mutex;
+
+    /**
+     * Position of the first record that is not dumped yet.
+     */
+    std::uint64_t m_dumped_until = 0;
+
+    std::vector<Level> m_dump_levels;
+    std::vector<std::size_t> m_dump_ends;
+    std::string m_dump_buffer;
+};
+
+} // end of scl
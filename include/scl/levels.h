@@ -9,6 +9,8 @@
 #pragma once
 
 #include <optional>
+#include <string>
+#include <string_view>
 
 namespace scl {
 /**
@@ -33,7 +35,7 @@ inline std::optional<Level> LevelFromStr(std::string str) {
     return std::nullopt;
 }
 
-inline std::string LevelToString(Level level) {
+inline std::string_view LevelToStringView(Level level) {
     switch(level) {
         case Level::Action:    return "Action";
         case Level::Error:     return "Error";
@@ -43,6 +45,10 @@ inline std::string LevelToString(Level level) {
     }
 }
 
+inline std::string LevelToString(Level level) {
+    return std::string(LevelToStringView(level));
+}
+
 namespace detail {
 /**
  * Check if a level is correct.
@@ -0,0 +1,204 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <scl/detail/mapped_file.h>
+
+#ifdef SCL_HAS_MAPPED_FILE
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <scl/detail/log_index.h>
+
+namespace scl {
+
+class LogIndexReader;
+
+/**
+ * Non-moving log index reader pointer alias.
+ */
+using LogIndexReaderPtr = std::unique_ptr<LogIndexReader>;
+
+/**
+ * Index entry: position of a record within the log file.
+ */
+using LogIndexEntry = detail::LogIndexEntry;
+
+/**
+ * Reader of the log files indexed by the FileRecorder (see FileRecorder::Options::index).
+ * The log file is memory-mapped and the reader binary-searches the index sidecar,
+ * so the records around a time are found without reading the file from the start.
+ * Note the reader sees the records that were written before the initialization.
+ */
+class LogIndexReader {
+public:
+    /**
+     * Initialization error info.
+     */
+    enum class InitError {
+        CantOpenFile = 1,
+        CantOpenIndex,
+        NotIndexFile,
+    };
+
+    /**
+     * Initialization result: ether pointer to an initialized reader or an error info.
+     */
+    using InitResult = std::variant<LogIndexReaderPtr, InitError>;
+
+    static std::string ToStr(InitError err) {
+        switch (err) {
+            case InitError::CantOpenFile:
+                return "CantOpenFile";
+            case InitError::CantOpenIndex:
+                return "CantOpenIndex";
+            case InitError::NotIndexFile:
+                return "NotIndexFile";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /**
+     * Init a LogIndexReader instance.
+     * @param log_path - path to the log file, its index is read from the "<log file>.idx" sidecar
+     * @return - ether pointer to an initialized reader or an error info
+     */
+    static InitResult Init(const std::filesystem::path &log_path) {
+        namespace Idx = detail::log_index;
+
+        LogIndexReaderPtr instance(new LogIndexReader());
+
+        // the log is mapped before the index is read, so the index entries beyond the mapped data are dropped below
+        instance->m_log_file = detail::MappedFile::Open(log_path);
+        if (!instance->m_log_file) {
+            return InitError::CantOpenFile;
+        }
+
+        const auto index_file = detail::MappedFile::Open(detail::LogIndexPath(log_path));
+        if (!index_file) {
+            return InitError::CantOpenIndex;
+        }
+
+        const auto index_data = index_file->Data();
+        if (index_data.substr(0, Idx::magic_k.size()) != Idx::magic_k) {
+            return InitError::NotIndexFile;
+        }
+
+        const auto log_size = instance->Data().size();
+        const auto entries_count = (index_data.size() - Idx::magic_k.size()) / Idx::entry_size_k;
+        instance->m_entries.reserve(entries_count);
+        for (std::size_t i = 0; i < entries_count; ++i) {
+            const auto entry = detail::LoadLogIndexEntry(index_data.data() + Idx::magic_k.size() + i * Idx::entry_size_k);
+            if (entry.offset >= log_size) {
+                break;
+            }
+
+            instance->m_entries.push_back(entry);
+        }
+
+        return instance;
+    }
+
+    /**
+     * @return - data of the log file
+     */
+    [[nodiscard]]
+    inline std::string_view Data() const {
+        return m_log_file->Data();
+    }
+
+    /**
+     * @return - index entries ordered by the sequence numbers
+     */
+    [[nodiscard]]
+    inline const std::vector<LogIndexEntry> &Entries() const {
+        return m_entries;
+    }
+
+    /**
+     * Find the region that contains all the records at or after the time.
+     * The region starts at most one index interval before the first of the records,
+     * the records are expected to be written in the order of their time.
+     * @param time - time (see TimeStrToSeconds())
+     * @return - region of the log file
+     */
+    [[nodiscard]]
+    std::string_view FromTime(std::int64_t time) const {
+        const auto it = std::lower_bound(m_entries.begin(), m_entries.end(), time,
+                                         [](const LogIndexEntry &entry, std::int64_t value) {
+                                             return entry.time < value;
+                                         });
+
+        // the records between the previous entry and the found one may have the time too
+        const std::size_t offset = it == m_entries.begin() ? 0 : static_cast<std::size_t>(std::prev(it)->offset);
+        return Region(offset);
+    }
+
+    /**
+     * Find the region that starts with the record of the sequence number.
+     * The lines after the closest index entry are skipped to get the record.
+     * @param sequence - number of the record within the log file (starts with 0)
+     * @return - region of the log file or an empty view if the file has fewer records
+     */
+    [[nodiscard]]
+    std::string_view FromSequence(std::uint64_t sequence) const {
+        const auto it = std::upper_bound(m_entries.begin(), m_entries.end(), sequence,
+                                         [](std::uint64_t value, const LogIndexEntry &entry) {
+                                             return value < entry.sequence;
+                                         });
+
+        std::uint64_t current = 0;
+        std::size_t offset = 0;
+        if (it != m_entries.begin()) {
+            current = std::prev(it)->sequence;
+            offset = static_cast<std::size_t>(std::prev(it)->offset);
+        }
+
+        const auto data = Data();
+        for (; current < sequence; ++current) {
+            if (offset >= data.size()) {
+                return {};
+            }
+
+            const void *line_end = std::memchr(data.data() + offset, '\n', data.size() - offset);
+            if (!line_end) {
+                return {};
+            }
+
+            offset = static_cast<std::size_t>(static_cast<const char *>(line_end) - data.data()) + 1;
+        }
+
+        return Region(offset);
+    }
+
+private:
+    LogIndexReader() = default;
+
+    std::string_view Region(std::size_t offset) const {
+        m_log_file->AdviseSequential(offset);
+        return Data().substr(std::min(offset, Data().size()));
+    }
+
+    std::unique_ptr<detail::MappedFile> m_log_file;
+
+    std::vector<LogIndexEntry> m_entries;
+};
+
+} // end of scl
+
+#endif
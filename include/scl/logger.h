@@ -0,0 +1,243 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+#include <scl/levels.h>
+#include <scl/record.h>
+#include <scl/recorder.h>
+#include <scl/static_recorders.h>
+#include <scl/threading.h>
+#include <scl/detail/misc.h>
+#include <scl/detail/policy.h>
+#include <scl/detail/sequence.h>
+
+namespace scl {
+
+/**
+ * Logger initialization error info.
+ */
+enum class LoggerInitError : int {
+    IncorrectLogLevel = 1,
+    NoRecorders,
+    UnallocatedRecorder,
+};
+
+inline std::string ToStr(LoggerInitError err) {
+    switch (err) {
+        case LoggerInitError::IncorrectLogLevel :
+            return "IncorrectLogLevel";
+        case LoggerInitError::NoRecorders :
+            return "NoRecorders";
+        case LoggerInitError::UnallocatedRecorder :
+            return "UnallocatedRecorder";
+        default:
+            return "Unknown";
+    }
+}
+
+/**
+ * Common logger options.
+ */
+struct LoggerOptions {
+    /**
+     * Logging messages which are less severe than level will be ignored.
+     */
+    Level level = Level::Action;
+
+    /**
+     * Memory resource of the record allocations (see IRecord::SetMemoryResource()) or nullptr to use the default ones.
+     * Note the resource must be thread-safe (eg std::pmr::synchronized_pool_resource)
+     * if the logger is used on several threads or is asynchronous.
+     */
+    std::pmr::memory_resource *memory_resource = nullptr;
+
+    /**
+     * Count of the sequence numbers that a producer thread takes from the process-wide counter at once
+     * (see IRecord::SetSequence() and detail::NextSequence()) or 0 to not number the records.
+     * The greater blocks reduce the contention of the producers but order the records within a thread only,
+     * just the block size 1 orders the records of all the threads.
+     */
+    std::uint64_t sequence_block_size = 0;
+};
+
+/**
+ * Generic logger pipeline.
+ * The logger filters records by level, timestamps them
+ * and delivers them to the recorders according to the threading policy.
+ * The RecordT must be constructible from (Level, time string, Args...),
+ * where Args are the arguments of the Record() method.
+ * If the RecordT is constructible from (ViewTag, Level, std::string_view, Args...),
+ * the record refers to the arguments and the cached time string without copying them.
+ *
+ * @tparam RecordT - type of record
+ * @tparam Policies - optional policies:
+ *                    threading policy (threading::Sync by default, threading::Locked or threading::Async<QueueT>);
+ *                    recorder set policy (DynamicRecorders<RecordT> by default or StaticRecorders<Recorders...>)
+ */
+template<typename RecordT, typename ...Policies>
+class Logger {
+public:
+    static_assert(detail::policies_count_k<ThreadingPolicyTag, Policies...> <= 1,
+                  "there must be at most one threading policy");
+
+    static_assert(detail::policies_count_k<RecordersPolicyTag, Policies...> <= 1,
+                  "there must be at most one recorder set policy");
+
+    /**
+     * Selected threading policy.
+     */
+    using Threading = detail::SelectPolicyT<ThreadingPolicyTag, threading::Sync, Policies...>;
+
+    /**
+     * Selected recorder set policy.
+     */
+    using Recorders = detail::SelectPolicyT<RecordersPolicyTag, DynamicRecorders<RecordT>, Policies...>;
+
+    using Options = LoggerOptions;
+
+    using InitError = LoggerInitError;
+
+    /**
+     * Non-moving logger pointer alias.
+     */
+    using Ptr = std::unique_ptr<Logger>;
+
+    /**
+     * Initialization result: ether pointer to an initialized logger or an error info.
+     */
+    using InitResult = std::variant<Ptr, InitError>;
+
+    /**
+     * Init a Logger instance.
+     * @param options - logger options
+     * @param recorders - recorders that will handle log records
+     * @return - ether pointer to an initialized logger or an error info
+     */
+    static InitResult Init(const Options &options, Recorders &&recorders) {
+        using Error = InitError;
+
+        if (!detail::IsLevelCorrect(options.level)) {
+            return Error::IncorrectLogLevel;
+        }
+
+        if (recorders.Empty()) {
+            return Error::NoRecorders;
+        }
+
+        if (!recorders.Allocated()) {
+            return Error::UnallocatedRecorder;
+        }
+
+        return Ptr(new Logger(options, std::move(recorders)));
+    }
+
+    /**
+     * Default dtor. The queued records (if any) are handled before the recorders are destroyed.
+     */
+    ~Logger() = default;
+
+    /**
+     * Check if a record with the level will be handled.
+     * @param level - level of the record
+     * @return - true if the level is not greater than an options.level
+     */
+    [[nodiscard]]
+    inline bool IsEnabled(Level level) const {
+        return level <= m_options.level;
+    }
+
+    /**
+     * Record a message.
+     * @tparam Args - types of the record fields following the level and time
+     * @param level - level of the record
+     *                (if the value greater than an options.level, then the message will be skipped)
+     * @param args - record fields following the level and time
+     */
+    template<typename ...Args>
+    inline void Record(Level level, Args &&...args) {
+        if (!IsEnabled(level)) {
+            // the level is not supported by settings
+            return;
+        }
+
+        auto record = MakeRecord(level, std::forward<Args>(args)...);
+        if constexpr (std::is_base_of_v<IRecord, RecordT>) {
+            if (m_options.memory_resource != nullptr) {
+                record.SetMemoryResource(m_options.memory_resource);
+            }
+
+            if (m_options.sequence_block_size != 0) {
+                record.SetSequence(detail::NextSequence(m_options.sequence_block_size));
+            }
+        }
+
+        m_delivery.Deliver(std::move(record));
+    }
+
+    /**
+     * Wait until all the records are handled by the recorders.
+     */
+    inline void Flush() {
+        m_delivery.Flush();
+    }
+
+private:
+    using Delivery = typename Threading::template Delivery<RecordT, Recorders>;
+
+    /**
+     * Construct a record that refers to the arguments if the RecordT supports that.
+     * @param level - level of the record
+     * @param args - record fields following the level and time
+     * @return - record
+     */
+    template<typename ...Args>
+    static inline RecordT MakeRecord(Level level, Args &&...args) {
+        if constexpr (std::is_constructible_v<RecordT, ViewTag, Level, std::string_view, Args &&...>) {
+            return RecordT(view_k, level, CurTimeStrView(), std::forward<Args>(args)...);
+        } else {
+            return RecordT(level, CurTimeStr(), std::forward<Args>(args)...);
+        }
+    }
+
+    /**
+     * Private constructor.
+     * @param options - logger options.
+     * @param recorders - recorders that will handle log records
+     */
+    explicit Logger(const Options &options, Recorders &&recorders)
+        : m_options(options),
+          m_recorders(std::move(recorders)),
+          m_delivery(m_recorders) {
+    }
+
+    /**
+     * Logger options.
+     */
+    Options m_options;
+
+    /**
+     * Recorders that process log records (eg FileRecorder, ConsoleRecorder and other custom recorders)
+     */
+    Recorders m_recorders;
+
+    /**
+     * Delivery of the records to the recorders, must be destroyed before the recorders.
+     */
+    Delivery m_delivery;
+};
+
+} // end of scl
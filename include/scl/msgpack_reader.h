@@ -0,0 +1,494 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <scl/record.h>
+#include <scl/detail/msgpack_format.h>
+
+namespace scl {
+
+/**
+ * Value of a MessagePack record field.
+ */
+struct MsgPackValue {
+    enum class Type {
+        Absent = 0,
+        Nil,
+        Integer,
+        String,
+    };
+
+    Type type = Type::Absent;
+    std::int64_t integer = 0;
+    std::string_view string;
+};
+
+/**
+ * Decoded MessagePack record (see RecordFormat::MessagePack).
+ * The record doesn't own the strings: they refer to the decoded data.
+ */
+class MsgPackRecord {
+public:
+    /**
+     * The fields with the greater keys are skipped.
+     */
+    static constexpr std::size_t max_keys_k = 16;
+
+    /**
+     * @param key - field key (eg RecordKey or cis1::core_logger::CoreRecordKey)
+     * @return - field value, the value type is Absent if there is no such field
+     */
+    template<typename KeyT>
+    [[nodiscard]]
+    inline const MsgPackValue &Get(KeyT key) const {
+        static const MsgPackValue absent{};
+        const auto index = static_cast<std::size_t>(key);
+        return index < max_keys_k ? m_values[index] : absent;
+    }
+
+    /**
+     * @param key - field key
+     * @return - integer value or std::nullopt if the field is absent or isn't an integer
+     */
+    template<typename KeyT>
+    [[nodiscard]]
+    inline std::optional<std::int64_t> Integer(KeyT key) const {
+        const auto &value = Get(key);
+        if (value.type != MsgPackValue::Type::Integer) {
+            return std::nullopt;
+        }
+
+        return value.integer;
+    }
+
+    /**
+     * @param key - field key
+     * @return - string value or std::nullopt if the field is absent or isn't a string
+     */
+    template<typename KeyT>
+    [[nodiscard]]
+    inline std::optional<std::string_view> String(KeyT key) const {
+        const auto &value = Get(key);
+        if (value.type != MsgPackValue::Type::String) {
+            return std::nullopt;
+        }
+
+        return value.string;
+    }
+
+private:
+    friend class MsgPackReader;
+
+    std::array<MsgPackValue, max_keys_k> m_values{};
+};
+
+/**
+ * Streaming reader of the MessagePack records written by a FileRecorder with the RecordFormat::MessagePack format.
+ * The records are decoded from a reusable buffer that is refilled from the stream,
+ * so the reading doesn't allocate per record: the strings of a record refer to the buffer until the next Next() call.
+ * The interned string fields (see FileRecorder::Options::intern_capacity) are resolved by the definitions
+ * that precede the records within the stream, the reader keeps the definitions of the stream.
+ */
+class MsgPackReader {
+public:
+    /**
+     * Result of the record parsing.
+     */
+    enum class ParseResult {
+        Ok = 0,
+        Incomplete,
+        Malformed,
+    };
+
+    /**
+     * @param stream - input stream (eg std::ifstream opened with std::ios::binary)
+     * @param buffer_size - initial size of the buffer, it is increased if a record doesn't fit in
+     */
+    explicit MsgPackReader(std::istream &stream, std::size_t buffer_size = 64 * 1024)
+        : m_stream(stream),
+          m_buffer(buffer_size != 0 ? buffer_size : 1) {
+    }
+
+    /**
+     * Parse a record at the beginning of the data.
+     * @param data - data
+     * @param record - decoded record
+     * @param size - size of the parsed record
+     * @param dictionary - interned strings by their ids (see msgpack::interned_ext_k),
+     *                     a reference to an absent string is malformed
+     * @return - one of the ParseResult values
+     */
+    static ParseResult Parse(std::string_view data,
+                             MsgPackRecord &record,
+                             std::size_t &size,
+                             const std::vector<std::string> &dictionary = {}) {
+        namespace Mp = detail::msgpack;
+
+        record.m_values.fill(MsgPackValue{});
+
+        Cursor cursor{data, 0};
+        std::uint64_t fields_count = 0;
+        unsigned char type = 0;
+        if (!cursor.Byte(type)) {
+            return ParseResult::Incomplete;
+        }
+
+        if ((type & 0xf0) == Mp::fixmap_k) {
+            fields_count = type & 0x0f;
+        } else if (type == Mp::map16_k) {
+            if (!cursor.BigEndian(2, fields_count)) {
+                return ParseResult::Incomplete;
+            }
+        } else if (type == map32_k) {
+            if (!cursor.BigEndian(4, fields_count)) {
+                return ParseResult::Incomplete;
+            }
+        } else {
+            return ParseResult::Malformed;
+        }
+
+        for (std::uint64_t i = 0; i < fields_count; ++i) {
+            MsgPackValue key;
+            auto result = ParseValue(cursor, key, dictionary);
+            if (result != ParseResult::Ok) {
+                return result;
+            }
+
+            if (key.type != MsgPackValue::Type::Integer || key.integer < 0) {
+                return ParseResult::Malformed;
+            }
+
+            MsgPackValue value;
+            result = ParseValue(cursor, value, dictionary);
+            if (result != ParseResult::Ok) {
+                return result;
+            }
+
+            if (static_cast<std::uint64_t>(key.integer) < MsgPackRecord::max_keys_k) {
+                record.m_values[static_cast<std::size_t>(key.integer)] = value;
+            }
+        }
+
+        size = cursor.pos;
+        return ParseResult::Ok;
+    }
+
+    /**
+     * Read the next record.
+     * @param record - decoded record, its strings are valid until the next call
+     * @return - false if there are no more records or the stream is malformed (see IsMalformed())
+     */
+    bool Next(MsgPackRecord &record) {
+        if (m_malformed) {
+            return false;
+        }
+
+        while (true) {
+            const std::string_view data(m_buffer.data() + m_begin, m_end - m_begin);
+            std::size_t size = 0;
+            auto result = ParseDefinition(data, m_dictionary, size);
+            if (result == ParseResult::Ok) {
+                // the definition of an interned string precedes the records that refer to it
+                m_begin += size;
+                continue;
+            }
+
+            if (result == ParseResult::Malformed) {
+                result = Parse(data, record, size, m_dictionary);
+            }
+
+            if (result == ParseResult::Ok) {
+                m_begin += size;
+                return true;
+            }
+
+            if (result == ParseResult::Malformed) {
+                m_malformed = true;
+                return false;
+            }
+
+            if (!Refill()) {
+                // the stream ends within a record
+                m_malformed = m_begin != m_end;
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @return - interned strings defined by the read part of the stream
+     */
+    [[nodiscard]]
+    inline const std::vector<std::string> &Dictionary() const {
+        return m_dictionary;
+    }
+
+    /**
+     * @return - true if the stream contains an unexpected value or ends within a record
+     */
+    [[nodiscard]]
+    inline bool IsMalformed() const {
+        return m_malformed;
+    }
+
+private:
+    static constexpr unsigned char true_k = 0xc3;
+    static constexpr unsigned char false_k = 0xc2;
+    static constexpr unsigned char bin8_k = 0xc4;
+    static constexpr unsigned char bin16_k = 0xc5;
+    static constexpr unsigned char bin32_k = 0xc6;
+    static constexpr unsigned char map32_k = 0xdf;
+
+    /**
+     * Position within the parsed data.
+     */
+    struct Cursor {
+        std::string_view data;
+        std::size_t pos;
+
+        inline bool Byte(unsigned char &byte) {
+            if (pos >= data.size()) {
+                return false;
+            }
+
+            byte = static_cast<unsigned char>(data[pos++]);
+            return true;
+        }
+
+        inline bool BigEndian(std::size_t size, std::uint64_t &value) {
+            if (data.size() - pos < size) {
+                return false;
+            }
+
+            value = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                value = (value << 8) | static_cast<unsigned char>(data[pos++]);
+            }
+
+            return true;
+        }
+
+        inline bool String(std::uint64_t size, std::string_view &str) {
+            if (data.size() - pos < size) {
+                return false;
+            }
+
+            str = data.substr(pos, static_cast<std::size_t>(size));
+            pos += static_cast<std::size_t>(size);
+            return true;
+        }
+    };
+
+    /**
+     * Parse the definition of an interned string (see msgpack::intern_definition_ext_k).
+     * The ids are defined in order: an id may redefine a known id or follow the last one.
+     * @return - Malformed if the data doesn't start with a definition or the id is beyond the dictionary
+     */
+    static ParseResult ParseDefinition(std::string_view data, std::vector<std::string> &dictionary, std::size_t &size) {
+        namespace Mp = detail::msgpack;
+
+        Cursor cursor{data, 0};
+        unsigned char type = 0;
+        if (!cursor.Byte(type)) {
+            return ParseResult::Incomplete;
+        }
+
+        if (type != Mp::ext8_k && type != Mp::ext16_k && type != Mp::ext32_k) {
+            return ParseResult::Malformed;
+        }
+
+        std::uint64_t length = 0;
+        unsigned char ext_type = 0;
+        std::uint64_t id = 0;
+        std::string_view value;
+        if (!cursor.BigEndian(std::size_t{1} << (type - Mp::ext8_k), length) || !cursor.Byte(ext_type)) {
+            return ParseResult::Incomplete;
+        }
+
+        if (ext_type != Mp::intern_definition_ext_k || length < 4) {
+            return ParseResult::Malformed;
+        }
+
+        if (!cursor.BigEndian(4, id) || !cursor.String(length - 4, value)) {
+            return ParseResult::Incomplete;
+        }
+
+        if (id > dictionary.size()) {
+            // the ids are defined in order, a gap means a corrupted id
+            return ParseResult::Malformed;
+        }
+
+        if (id == dictionary.size()) {
+            dictionary.emplace_back(value);
+        } else {
+            dictionary[static_cast<std::size_t>(id)].assign(value);
+        }
+        size = cursor.pos;
+        return ParseResult::Ok;
+    }
+
+    /**
+     * Parse a scalar value: nil, boolean (as integer), integer, string (bin is decoded as string)
+     * or interned string.
+     */
+    static ParseResult ParseValue(Cursor &cursor, MsgPackValue &value, const std::vector<std::string> &dictionary) {
+        namespace Mp = detail::msgpack;
+        using Type = MsgPackValue::Type;
+
+        unsigned char type = 0;
+        if (!cursor.Byte(type)) {
+            return ParseResult::Incomplete;
+        }
+
+        std::uint64_t raw = 0;
+        std::size_t length_size = 0;
+        if (type <= Mp::positive_fixint_max_k) {
+            value.type = Type::Integer;
+            value.integer = type;
+            return ParseResult::Ok;
+        }
+
+        if (type >= Mp::negative_fixint_k) {
+            value.type = Type::Integer;
+            value.integer = static_cast<std::int8_t>(type);
+            return ParseResult::Ok;
+        }
+
+        if ((type & 0xe0) == Mp::fixstr_k) {
+            value.type = Type::String;
+            return cursor.String(type & 0x1f, value.string) ? ParseResult::Ok : ParseResult::Incomplete;
+        }
+
+        switch (type) {
+            case Mp::nil_k:
+                value.type = Type::Nil;
+                return ParseResult::Ok;
+            case false_k:
+            case true_k:
+                value.type = Type::Integer;
+                value.integer = type == true_k ? 1 : 0;
+                return ParseResult::Ok;
+            case Mp::uint8_k:
+            case Mp::uint16_k:
+            case Mp::uint32_k:
+            case Mp::uint64_k:
+                if (!cursor.BigEndian(std::size_t{1} << (type - Mp::uint8_k), raw)) {
+                    return ParseResult::Incomplete;
+                }
+
+                value.type = Type::Integer;
+                value.integer = static_cast<std::int64_t>(raw);
+                return ParseResult::Ok;
+            case Mp::int8_k:
+            case Mp::int16_k:
+            case Mp::int32_k:
+            case Mp::int64_k: {
+                const auto size = std::size_t{1} << (type - Mp::int8_k);
+                if (!cursor.BigEndian(size, raw)) {
+                    return ParseResult::Incomplete;
+                }
+
+                // sign extension of the size bytes
+                const auto shift = 64 - 8 * size;
+                value.type = Type::Integer;
+                value.integer = static_cast<std::int64_t>(raw << shift) >> shift;
+                return ParseResult::Ok;
+            }
+            case Mp::fixext1_k:
+            case Mp::fixext2_k:
+            case Mp::fixext4_k: {
+                unsigned char ext_type = 0;
+                if (!cursor.Byte(ext_type) || !cursor.BigEndian(std::size_t{1} << (type - Mp::fixext1_k), raw)) {
+                    return ParseResult::Incomplete;
+                }
+
+                if (ext_type != Mp::interned_ext_k || raw >= dictionary.size()) {
+                    return ParseResult::Malformed;
+                }
+
+                value.type = Type::String;
+                value.string = dictionary[static_cast<std::size_t>(raw)];
+                return ParseResult::Ok;
+            }
+            case Mp::str8_k:
+            case bin8_k:
+                length_size = 1;
+                break;
+            case Mp::str16_k:
+            case bin16_k:
+                length_size = 2;
+                break;
+            case Mp::str32_k:
+            case bin32_k:
+                length_size = 4;
+                break;
+            default:
+                // the records don't contain floats, arrays, nested maps and other extensions
+                return ParseResult::Malformed;
+        }
+
+        std::uint64_t length = 0;
+        if (!cursor.BigEndian(length_size, length)) {
+            return ParseResult::Incomplete;
+        }
+
+        value.type = Type::String;
+        return cursor.String(length, value.string) ? ParseResult::Ok : ParseResult::Incomplete;
+    }
+
+    /**
+     * Move the unparsed data to the buffer beginning and read the stream to the rest of the buffer.
+     * @return - false if there is no more data
+     */
+    bool Refill() {
+        if (m_begin != 0) {
+            std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+            m_end -= m_begin;
+            m_begin = 0;
+        }
+
+        if (m_end == m_buffer.size()) {
+            // the record doesn't fit in the buffer
+            m_buffer.resize(m_buffer.size() * 2);
+        }
+
+        m_stream.read(m_buffer.data() + m_end, static_cast<std::streamsize>(m_buffer.size() - m_end));
+        const auto read_size = static_cast<std::size_t>(m_stream.gcount());
+        m_end += read_size;
+        return read_size != 0;
+    }
+
+    std::istream &m_stream;
+
+    std::vector<char> m_buffer;
+
+    /**
+     * Unparsed data within the buffer: [m_begin, m_end).
+     */
+    std::size_t m_begin = 0;
+    std::size_t m_end = 0;
+
+    /**
+     * Interned strings by their ids.
+     */
+    std::vector<std::string> m_dictionary;
+
+    bool m_malformed = false;
+};
+
+} // end of scl
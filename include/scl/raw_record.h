@@ -0,0 +1,124 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <scl/levels.h>
+#include <scl/record.h>
+#include <scl/detail/msgpack_format.h>
+#include <scl/detail/record_storage.h>
+
+namespace scl {
+
+/**
+ * Record that contains an already serialized record (eg a record received from another process,
+ * see ShmRecorder and the shm_collector tool). The text is written by the recorders as is.
+ * Note the record refers to the text until it is detached (see Detach()).
+ */
+class RawRecord : public IRecord {
+public:
+    /**
+     * Create a record that refers to the serialized text.
+     * @param level_ - level of the serialized record
+     * @param text_ - serialized record without the line break
+     */
+    RawRecord(Level level_, std::string_view text_)
+        : level(level_),
+          text(text_) {
+    }
+
+    /**
+     * Deep copy, the copy owns the text.
+     */
+    RawRecord(const RawRecord &other)
+        : IRecord(other),
+          level(other.level),
+          text(other.text) {
+        Detach();
+    }
+
+    RawRecord(RawRecord &&other) noexcept = default;
+
+    RawRecord &operator=(const RawRecord &other) {
+        if (this != &other) {
+            *this = RawRecord(other);
+        }
+
+        return *this;
+    }
+
+    RawRecord &operator=(RawRecord &&other) noexcept = default;
+
+    ~RawRecord() = default;
+
+    /**
+     * Copy the text to the record own storage.
+     */
+    inline void Detach() {
+        if (!m_storage) {
+            m_storage = detail::PackViews(m_memory_resource, text);
+        }
+    }
+
+    /**
+     * @return - true if the record owns the text
+     */
+    [[nodiscard]]
+    inline bool IsDetached() const {
+        return static_cast<bool>(m_storage);
+    }
+
+    Level level;
+    std::string_view text;
+
+protected:
+    inline void WriteString(std::string &dst) const final {
+        dst += text;
+    }
+
+    inline void WriteAlignedString(std::string &dst) const final {
+        dst += text;
+    }
+
+    inline void WriteJsonString(std::string &dst) const final {
+        dst += text;
+    }
+
+    /**
+     * @overload
+     * Note the text is written as the message of the level
+     */
+    inline void WriteMsgPack(std::string &dst, detail::MsgPackStrWriter &) const final {
+        detail::AppendMsgPackMap(dst, 2);
+        detail::AppendMsgPackKey(dst, RecordKey::Level);
+        detail::AppendMsgPackUint(dst, static_cast<std::uint64_t>(level));
+        detail::AppendMsgPackKey(dst, RecordKey::Message);
+        detail::AppendMsgPackStr(dst, text);
+    }
+
+    inline AlignedTokenCont AsAlignedTokens() const final {
+        return AlignedTokenCont(MemoryResource());
+    }
+
+    inline TokenCont AsTokens() const final {
+        return TokenCont(MemoryResource());
+    }
+
+    inline std::string Message() const final {
+        return std::string(text);
+    }
+
+private:
+    detail::PoolBlock m_storage;
+};
+
+} // end of scl
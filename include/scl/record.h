@@ -8,27 +8,150 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <scl/levels.h>
+#include <scl/detail/msgpack_format.h>
 
 namespace scl {
 
+/**
+ * Tag of the record constructors that refer to the variable-length fields instead of copying them.
+ * Such a record is valid until the referred data is destroyed,
+ * so the logger uses it only for the synchronous delivery
+ * and detaches the record from the caller data before the queueing (see detail::DetachRecord()).
+ */
+struct ViewTag {
+};
+
+inline constexpr ViewTag view_k{};
+
+/**
+ * Serialization format of the records.
+ */
+enum class RecordFormat {
+    /**
+     * "token | token | message"
+     */
+    Plain = 0,
+
+    /**
+     * Plain format with the tokens aligned to the fixed widths.
+     */
+    Aligned,
+
+    /**
+     * JSON object per record: {"time":"...","level":"Info",...,"message":"..."}
+     */
+    JsonLines,
+
+    /**
+     * Binary MessagePack map per record: {RecordKey: value, ...}, the records are not separated by line breaks
+     * (see MsgPackReader).
+     */
+    MessagePack,
+};
+
+/**
+ * @param format - serialization format
+ * @return - true if the records of the format are binary and must not be separated by line breaks
+ */
+inline constexpr bool IsBinaryFormat(RecordFormat format) {
+    return format == RecordFormat::MessagePack;
+}
+
+/**
+ * MessagePack keys of the fields that are common for the records (see RecordFormat::MessagePack).
+ * The time is written as the count of seconds (see TimeStrToSeconds()) and the level as its integer value.
+ * The keys of the record specific fields follow the common ones (eg cis1::core_logger::CoreRecordKey).
+ */
+enum class RecordKey : std::uint8_t {
+    Time = 0,
+    Level,
+    Message,
+
+    /**
+     * Optional sequence number (see IRecord::Sequence()), the last key doesn't collide with the specific ones.
+     */
+    Sequence = 15,
+};
+
 /**
  * Log record info. The structure is set by logger and is handled by a recorder.
  */
 class IRecord {
 public:
+    /**
+     * Aligned token. The token is allocator-aware,
+     * so it is allocated from the memory resource of the AlignedTokenCont container.
+     */
     struct AlignToken {
-        AlignToken(const std::string &_token, std::size_t _align) : token(_token), align(_align) {}
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        AlignToken(std::string_view _token, std::size_t _align, const allocator_type &alloc = {})
+            : token(_token, alloc), align(_align) {}
 
-        std::string token{};
+        AlignToken(const AlignToken &other, const allocator_type &alloc)
+            : token(other.token, alloc), align(other.align) {}
+
+        AlignToken(AlignToken &&other, const allocator_type &alloc)
+            : token(std::move(other.token), alloc), align(other.align) {}
+
+        AlignToken(const AlignToken &other) = default;
+
+        AlignToken(AlignToken &&other) noexcept = default;
+
+        AlignToken &operator=(const AlignToken &other) = default;
+
+        AlignToken &operator=(AlignToken &&other) = default;
+
+        std::pmr::string token{};
         std::size_t align = 0;
     };
 
-    using AlignedTokenCont = std::vector<AlignToken>;
-    using TokenCont = std::vector<std::string>;
+    using AlignedTokenCont = std::pmr::vector<AlignToken>;
+    using TokenCont = std::pmr::vector<std::pmr::string>;
+
+    /**
+     * Set the memory resource of the record allocations:
+     * token containers and the storage of a detached record.
+     * Note the resource must be thread-safe if the record is queued by an asynchronous logger.
+     * @param resource - memory resource or nullptr to use the default ones
+     */
+    inline void SetMemoryResource(std::pmr::memory_resource *resource) {
+        m_memory_resource = resource;
+    }
+
+    /**
+     * @return - memory resource of the record allocations (std::pmr::get_default_resource() if it is not set)
+     */
+    [[nodiscard]]
+    inline std::pmr::memory_resource *MemoryResource() const {
+        return m_memory_resource != nullptr ? m_memory_resource : std::pmr::get_default_resource();
+    }
+
+    /**
+     * Set the sequence number of the record, the number is serialized after the time:
+     * "#<sequence>" token of the text formats, "seq" JSON key and RecordKey::Sequence MessagePack key.
+     * The logger sets the numbers if the LoggerOptions::sequence_block_size is set (see detail::NextSequence()).
+     * @param sequence - sequence number
+     */
+    inline void SetSequence(std::uint64_t sequence) {
+        m_sequence = sequence;
+    }
+
+    /**
+     * @return - sequence number of the record or std::nullopt if it is not set
+     */
+    [[nodiscard]]
+    inline std::optional<std::uint64_t> Sequence() const {
+        return m_sequence;
+    }
 
     /**
      * Serialize a record to an non-aligned string.
@@ -42,7 +165,106 @@ public:
      */
     std::string ToAlignedString() const;
 
+    /**
+     * Append a non-aligned serialized record to the string.
+     * @param dst - destination string
+     */
+    inline void AppendString(std::string &dst) const {
+        WriteString(dst);
+    }
+
+    /**
+     * Append an aligned serialized record to the string.
+     * @param dst - destination string
+     */
+    inline void AppendAlignedString(std::string &dst) const {
+        WriteAlignedString(dst);
+    }
+
+    /**
+     * Append a JSON serialized record (without the line break) to the string.
+     * @param dst - destination string
+     */
+    inline void AppendJsonString(std::string &dst) const {
+        WriteJsonString(dst);
+    }
+
+    /**
+     * Append a MessagePack serialized record to the string.
+     * @param dst - destination string
+     */
+    inline void AppendMsgPack(std::string &dst) const {
+        detail::MsgPackStrWriter writer;
+        WriteMsgPack(dst, writer);
+    }
+
+    /**
+     * Append a MessagePack serialized record to the string, the string fields that may repeat are written by the writer.
+     * @param dst - destination string
+     * @param writer - writer of the string fields (eg MsgPackInterner::Writer that interns them)
+     */
+    inline void AppendMsgPack(std::string &dst, detail::MsgPackStrWriter &writer) const {
+        WriteMsgPack(dst, writer);
+    }
+
+    /**
+     * Append a serialized record in the format to the string.
+     * @param dst - destination string
+     * @param format - serialization format
+     */
+    inline void AppendFormatted(std::string &dst, RecordFormat format) const {
+        switch (format) {
+            case RecordFormat::Aligned:
+                WriteAlignedString(dst);
+                return;
+            case RecordFormat::JsonLines:
+                WriteJsonString(dst);
+                return;
+            case RecordFormat::MessagePack:
+                AppendMsgPack(dst);
+                return;
+            default:
+                WriteString(dst);
+        }
+    }
+
 protected:
+    /**
+     * Append a non-aligned serialized record to the string.
+     * By default the record is compiled from the AsTokens() and Message() values,
+     * the sequence number token follows the first token (the time),
+     * a derived record may override the method to avoid the intermediate tokens.
+     * @param dst - destination string
+     */
+    virtual void WriteString(std::string &dst) const;
+
+    /**
+     * Append an aligned serialized record to the string.
+     * By default the record is compiled from the AsAlignedTokens() and Message() values,
+     * the sequence number token follows the first token (the time),
+     * a derived record may override the method to avoid the intermediate tokens.
+     * @param dst - destination string
+     */
+    virtual void WriteAlignedString(std::string &dst) const;
+
+    /**
+     * Append a JSON serialized record to the string.
+     * By default the record is written as {["seq":<sequence>,]"message":"<non-aligned serialized record>"},
+     * a derived record should override the method to write its fields.
+     * @param dst - destination string
+     */
+    virtual void WriteJsonString(std::string &dst) const;
+
+    /**
+     * Append a MessagePack serialized record to the string.
+     * By default the record is written as
+     * {[RecordKey::Sequence: <sequence>, ]RecordKey::Message: "<non-aligned serialized record>"},
+     * a derived record should override the method to write its fields.
+     * @param dst - destination string
+     * @param writer - writer of the string fields that may repeat (the message is written as is)
+     */
+    virtual void WriteMsgPack(std::string &dst, detail::MsgPackStrWriter &writer) const;
+
     static std::string CompileRecord(const AlignedTokenCont &aligned_tokens);
 
     static std::string CompileRecord(const TokenCont &tokens);
@@ -52,6 +274,16 @@ protected:
     virtual TokenCont AsTokens() const = 0;
 
     virtual std::string Message() const = 0;
+
+    /**
+     * Memory resource set by SetMemoryResource() or nullptr.
+     */
+    std::pmr::memory_resource *m_memory_resource = nullptr;
+
+    /**
+     * Sequence number set by SetSequence() or std::nullopt.
+     */
+    std::optional<std::uint64_t> m_sequence = std::nullopt;
 };
 
 } // end of scl
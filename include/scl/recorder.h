@@ -9,6 +9,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <scl/record.h>
 
 namespace scl {
@@ -44,4 +45,66 @@ using RecorderPtr = std::unique_ptr<IRecorder<RecordT>>;
 template<typename RecordT>
 using RecordersCont = std::vector<RecorderPtr<RecordT>>;
 
+/**
+ * Category tag of the recorder set policies.
+ */
+struct RecordersPolicyTag {
+};
+
+/**
+ * Recorder set policy: the recorders are stored in the RecordersCont container
+ * and every record is passed to them via the IRecorder virtual interface.
+ * The set is chosen at runtime (eg recorders loaded by plugins) but is fixed once the logger is initialized,
+ * the records are passed without a synchronization.
+ * @tparam RecordT - type of record
+ */
+template<typename RecordT>
+class DynamicRecorders {
+public:
+    using PolicyTag = RecordersPolicyTag;
+
+    /**
+     * Implicit ctor, so a logger can be initialized by the RecordersCont container.
+     * @param recorders - recorders that will handle log records
+     */
+    DynamicRecorders(RecordersCont<RecordT> &&recorders)
+        : m_recorders(std::move(recorders)) {
+    }
+
+    /**
+     * @return - true if there are no recorders
+     */
+    [[nodiscard]]
+    inline bool Empty() const {
+        return m_recorders.empty();
+    }
+
+    /**
+     * @return - true if every recorder is allocated
+     */
+    [[nodiscard]]
+    inline bool Allocated() const {
+        for (const auto &recorder : m_recorders) {
+            if (!recorder) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Pass the record to every recorder.
+     * @param record - record info that should be handled.
+     */
+    inline void Dispatch(const RecordT &record) {
+        for (auto &recorder : m_recorders) {
+            recorder->OnRecord(record);
+        }
+    }
+
+private:
+    RecordersCont<RecordT> m_recorders;
+};
+
 } // end of scl
@@ -0,0 +1,456 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include <scl/detail/format_defines.h>
+#include <scl/detail/misc.h>
+#include <scl/detail/record_format.h>
+#include <scl/detail/segment_source.h>
+#include <scl/detail/task_pool.h>
+
+namespace scl {
+
+class SegmentMerger;
+
+/**
+ * Non-moving segment merger pointer alias.
+ */
+using SegmentMergerPtr = std::unique_ptr<SegmentMerger>;
+
+/**
+ * Record of the merged stream.
+ */
+struct MergedRecord {
+    /**
+     * Line of the record without the line break, the view is valid within the callback call only.
+     */
+    std::string_view line;
+
+    /**
+     * Time of the record (see TimeStrToSeconds()).
+     */
+    std::int64_t time;
+
+    /**
+     * Index of the record file within the Options::files.
+     */
+    std::size_t file_index;
+
+    /**
+     * Number of the record within its file (starts with 0).
+     */
+    std::uint64_t sequence;
+
+    /**
+     * Sequence number of the record (see IRecord::Sequence()) or std::nullopt if the record is not numbered,
+     * a line without the time has the number of the previous record of its file.
+     */
+    std::optional<std::uint64_t> record_sequence;
+};
+
+/**
+ * Merger of the text log files (eg the rotated files of several processes) to a single stream ordered by time.
+ * The files are read and parsed by the worker threads by batches: a worker prepares the next batch of a file
+ * while the current one is merged, so the memory is bounded by two batches per file.
+ * The current records of the files are merged by a heap ordered by (time, file index, sequence),
+ * so the records of the same time keep the order of the Options::files and the order within a file.
+ * The plain, aligned and JSON Lines records are supported, a line without the time (eg the continuation
+ * of a multi-line message) follows the previous record of its file.
+ * If the Options::order_by_sequence is set, the records of the same time are ordered by their sequence numbers
+ * (see IRecord::Sequence()) before the file order.
+ */
+class SegmentMerger {
+public:
+    /**
+     * Initialization error info.
+     */
+    enum class InitError {
+        NoFiles = 1,
+        CantOpenFile,
+        CompressionNotSupported,
+    };
+
+    /**
+     * Initialization result: ether pointer to an initialized merger or an error info.
+     */
+    using InitResult = std::variant<SegmentMergerPtr, InitError>;
+
+    /**
+     * Segment merger options.
+     */
+    struct Options {
+        /**
+         * Plain or gzip-compressed log files (the compressed files require the SCL_HAS_ZLIB macro).
+         * The records of the same time are ordered by the file order, so the rotated files of a process
+         * should be listed in the rotation order.
+         */
+        std::vector<std::filesystem::path> files;
+
+        /**
+         * Count of the worker threads that read and parse the files.
+         */
+        std::size_t workers_count = std::max(1u, std::thread::hardware_concurrency());
+
+        /**
+         * Size of the file data that is parsed at once.
+         */
+        std::size_t batch_size = 256 * 1024;
+
+        /**
+         * Order the records of the same time by their sequence numbers (the records that are not numbered go first).
+         * The numbers are taken from a process-wide counter, so the option suits the files of a single process
+         * (eg the files of several recorders), the numbers of different processes are not related.
+         * The records of different threads are ordered only if the logger numbers them by the block size 1
+         * (see LoggerOptions::sequence_block_size), otherwise the order is kept within a thread only.
+         */
+        bool order_by_sequence = false;
+    };
+
+    /**
+     * Merge statistics.
+     */
+    struct MergeStats {
+        std::size_t records_count = 0;
+        std::size_t bytes_count = 0;
+    };
+
+    static std::string ToStr(InitError err) {
+        switch (err) {
+            case InitError::NoFiles:
+                return "NoFiles";
+            case InitError::CantOpenFile:
+                return "CantOpenFile";
+            case InitError::CompressionNotSupported:
+                return "CompressionNotSupported";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /**
+     * Init a SegmentMerger instance, all the files are opened.
+     * @param options - segment merger options
+     * @return - ether pointer to an initialized merger or an error info
+     */
+    static InitResult Init(const Options &options) {
+        using Result = detail::SegmentSource::OpenResult;
+
+        if (options.files.empty()) {
+            return InitError::NoFiles;
+        }
+
+        SegmentMergerPtr instance(new SegmentMerger(options));
+        for (const auto &path : options.files) {
+            auto &segment = instance->m_segments.emplace_back(std::make_unique<Segment>());
+            switch (detail::SegmentSource::Open(path, segment->source)) {
+                case Result::Ok:
+                    break;
+                case Result::CompressionNotSupported:
+                    return InitError::CompressionNotSupported;
+                default:
+                    return InitError::CantOpenFile;
+            }
+        }
+
+        return instance;
+    }
+
+    /**
+     * Merge the files, the method may be called once.
+     * @param fn - function that is called with every record in the time order (const MergedRecord &)
+     * @return - merge statistics
+     */
+    template<typename FnT>
+    MergeStats Merge(FnT &&fn) {
+        // (time, record sequence, file index, sequence) of the current record of every file that is not finished
+        using Key = std::tuple<std::int64_t, std::uint64_t, std::size_t, std::uint64_t>;
+        std::priority_queue<Key, std::vector<Key>, std::greater<>> heap;
+
+        for (std::size_t i = 0; i < m_segments.size(); ++i) {
+            RequestBatch(i);
+        }
+
+        for (std::size_t i = 0; i < m_segments.size(); ++i) {
+            if (NextBatch(i)) {
+                const auto &entry = m_segments[i]->current.entries.front();
+                heap.emplace(entry.time, OrderSequence(entry), i, entry.sequence);
+            }
+        }
+
+        MergeStats stats;
+        while (!heap.empty()) {
+            const auto file_index = std::get<2>(heap.top());
+            heap.pop();
+
+            auto &segment = *m_segments[file_index];
+            const auto &entry = segment.current.entries[segment.position];
+            const MergedRecord record{std::string_view(segment.current.data).substr(entry.offset, entry.size),
+                                      entry.time, file_index, entry.sequence, entry.record_sequence};
+            fn(static_cast<const MergedRecord &>(record));
+            ++stats.records_count;
+            stats.bytes_count += entry.size + 1;
+
+            if (++segment.position == segment.current.entries.size() && !NextBatch(file_index)) {
+                continue;
+            }
+
+            const auto &next = segment.current.entries[segment.position];
+            heap.emplace(next.time, OrderSequence(next), file_index, next.sequence);
+        }
+
+        return stats;
+    }
+
+private:
+    /**
+     * Parsed record of a batch.
+     */
+    struct Entry {
+        std::int64_t time;
+        std::uint64_t sequence;
+        std::optional<std::uint64_t> record_sequence;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    /**
+     * Whole lines of a file and their records.
+     */
+    struct Batch {
+        std::string data;
+        std::vector<Entry> entries;
+    };
+
+    /**
+     * State of a file. The source and the parsing state are used by one worker task at once.
+     */
+    struct Segment {
+        std::unique_ptr<detail::SegmentSource> source;
+
+        /**
+         * Incomplete line at the end of the last read data.
+         */
+        std::string carry;
+
+        bool is_finished = false;
+
+        std::int64_t last_time = std::numeric_limits<std::int64_t>::min();
+
+        /**
+         * Last parsed time string, the time of the same string is not parsed again.
+         */
+        std::string last_time_str;
+
+        std::optional<std::uint64_t> last_record_sequence;
+
+        std::uint64_t sequence = 0;
+
+        /**
+         * Merged batch and the index of its current record.
+         */
+        Batch current;
+        std::size_t position = 0;
+
+        /**
+         * Batch that is prepared by a worker.
+         */
+        Batch next;
+        std::future<void> next_ready;
+    };
+
+    explicit SegmentMerger(const Options &options)
+        : m_batch_size(options.batch_size == 0 ? 1 : options.batch_size),
+          m_order_by_sequence(options.order_by_sequence),
+          m_pool(options.workers_count) {
+    }
+
+    /**
+     * Post the parsing of the next batch of the file.
+     */
+    void RequestBatch(std::size_t file_index) {
+        auto *segment = m_segments[file_index].get();
+        segment->next_ready = m_pool.Post([this, segment] { ParseBatch(*segment, segment->next); });
+    }
+
+    /**
+     * Make the prepared batch current and request the following one.
+     * @return - false if the file is finished
+     */
+    bool NextBatch(std::size_t file_index) {
+        auto &segment = *m_segments[file_index];
+        while (true) {
+            if (!segment.next_ready.valid()) {
+                // the last batch has been merged
+                return false;
+            }
+
+            segment.next_ready.get();
+            std::swap(segment.current, segment.next);
+            segment.position = 0;
+
+            if (!segment.is_finished) {
+                RequestBatch(file_index);
+            }
+
+            if (!segment.current.entries.empty()) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * Read the whole lines of the next batch_size bytes (at least one line if the file is not finished)
+     * and parse their times.
+     */
+    void ParseBatch(Segment &segment, Batch &batch) const {
+        batch.entries.clear();
+        batch.data.clear();
+        batch.data.swap(segment.carry);
+
+        std::size_t last_line_end = std::string::npos;
+        while (!segment.is_finished) {
+            const auto size = batch.data.size();
+            batch.data.resize(size + m_batch_size);
+            const auto read = segment.source->Read(batch.data.data() + size, m_batch_size);
+            batch.data.resize(size + read);
+            if (read == 0) {
+                segment.is_finished = true;
+                break;
+            }
+
+            // the carried line has no line breaks, so a found one ends a whole line
+            last_line_end = batch.data.rfind('\n');
+            if (last_line_end != std::string::npos) {
+                break;
+            }
+        }
+
+        if (segment.is_finished) {
+            // the last line of a finished file is complete
+            if (!batch.data.empty() && batch.data.back() != '\n') {
+                batch.data += '\n';
+            }
+        } else {
+            segment.carry.assign(batch.data, last_line_end + 1, std::string::npos);
+            batch.data.resize(last_line_end + 1);
+        }
+
+        const char *data = batch.data.data();
+        std::size_t begin = 0;
+        while (begin < batch.data.size()) {
+            const auto *end = static_cast<const char *>(std::memchr(data + begin, '\n', batch.data.size() - begin));
+            const auto size = static_cast<std::size_t>(end - data) - begin;
+            const std::string_view line(data + begin, size);
+
+            const auto time_str = LineTimeStr(line);
+            if (!time_str.empty()) {
+                if (time_str != segment.last_time_str) {
+                    if (const auto time = TimeStrToSeconds(time_str)) {
+                        segment.last_time = *time;
+                        segment.last_time_str.assign(time_str);
+                    }
+                }
+
+                segment.last_record_sequence = LineSequence(line);
+            }
+
+            batch.entries.push_back({segment.last_time, segment.sequence++, segment.last_record_sequence, begin, size});
+            begin += size + 1;
+        }
+    }
+
+    /**
+     * @param line - plain, aligned or JSON Lines record
+     * @return - time string of the record or an empty view if the line has no time
+     */
+    static std::string_view LineTimeStr(std::string_view line) {
+        namespace Fmt = detail::log_formatting;
+        constexpr std::string_view json_time_key_k = "\"time\":\"";
+
+        if (!line.empty() && line.front() == '{') {
+            const auto pos = line.find(json_time_key_k);
+            if (pos == std::string_view::npos) {
+                return {};
+            }
+
+            return line.substr(pos + json_time_key_k.size(), Fmt::time_length_k);
+        }
+
+        if (line.size() < Fmt::time_length_k || (line.size() > Fmt::time_length_k && line[Fmt::time_length_k] != ' ')) {
+            return {};
+        }
+
+        return line.substr(0, Fmt::time_length_k);
+    }
+
+    /**
+     * @param line - plain, aligned or JSON Lines record that has the time
+     * @return - sequence number of the record or std::nullopt if the record is not numbered
+     */
+    static std::optional<std::uint64_t> LineSequence(std::string_view line) {
+        namespace Fmt = detail::log_formatting;
+        constexpr std::string_view json_sequence_key_k = ",\"seq\":";
+
+        if (line.front() == '{') {
+            // the sequence number follows the time
+            const auto pos = line.find(json_sequence_key_k);
+            if (pos == std::string_view::npos) {
+                return std::nullopt;
+            }
+
+            const char *begin = line.data() + pos + json_sequence_key_k.size();
+            std::uint64_t sequence = 0;
+            const auto result = std::from_chars(begin, line.data() + line.size(), sequence);
+            return result.ec == std::errc() ? std::optional<std::uint64_t>(sequence) : std::nullopt;
+        }
+
+        // skip the time separator and the left indent of an aligned token
+        auto token = line.substr(std::min(line.size(), Fmt::time_length_k + Fmt::separator_k.size()));
+        token.remove_prefix(std::min(token.size(), token.find_first_not_of(' ')));
+        return detail::ParseSequenceToken(token.substr(0, token.find(' ')));
+    }
+
+    /**
+     * @return - sequence number of the entry within the heap key
+     */
+    inline std::uint64_t OrderSequence(const Entry &entry) const {
+        return m_order_by_sequence ? entry.record_sequence.value_or(0) : 0;
+    }
+
+    std::size_t m_batch_size;
+
+    bool m_order_by_sequence;
+
+    std::vector<std::unique_ptr<Segment>> m_segments;
+
+    /**
+     * The pool is destroyed first, so the tasks don't outlive the segments.
+     */
+    detail::TaskPool m_pool;
+};
+
+} // end of scl
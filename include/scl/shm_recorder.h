@@ -0,0 +1,155 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <variant>
+
+#include <scl/recorder.h>
+#include <scl/record.h>
+#include <scl/detail/shm_ring.h>
+
+namespace scl {
+
+template<typename RecordT>
+class ShmRecorder;
+
+/**
+ * Non-moving shared memory recorder pointer alias.
+ */
+template<typename RecordT>
+using ShmRecorderPtr = std::unique_ptr<ShmRecorder<RecordT>>;
+
+/**
+ * Shared memory recorder that implement the IRecorder interface.
+ * The recorder serializes records to the ring buffer within the POSIX shared memory,
+ * the ring is drained by a single collector process (see the shm_collector tool) that writes the log files.
+ * So a producer pays only the serialization and a memcpy, and the file I/O of many processes is done by one writer.
+ * The recorder is lock-free and may be used by several threads without synchronization.
+ * If the ring is full, the record is dropped and counted within the ring.
+ * Note the recorder is supported on POSIX systems only.
+ * @tparam RecordT - type of record
+ */
+template<typename RecordT>
+class ShmRecorder : public IRecorder<RecordT> {
+public:
+    /**
+     * Initialization error info.
+     */
+    enum class InitError {
+        CantOpenSharedMemory = 1,
+        SharedMemoryNotSupported,
+    };
+
+    /**
+     * Initialization result: ether pointer to an initialized recorder or an error info.
+     */
+    using InitResult = std::variant<ShmRecorderPtr<RecordT>, InitError>;
+
+    /**
+     * Shared memory recorder options.
+     */
+    struct Options {
+        /**
+         * Name of the shared memory object created by the collector (eg "/cis1_log").
+         */
+        std::string name;
+
+        /**
+         * Allow to align entry attributes, if the values is true.
+         */
+        bool align = false;
+    };
+
+    static std::string ToStr(InitError err) {
+        switch (err) {
+            case InitError::CantOpenSharedMemory:
+                return "CantOpenSharedMemory";
+            case InitError::SharedMemoryNotSupported:
+                return "SharedMemoryNotSupported";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /**
+     * Init a ShmRecorder instance. The ring must be created by the collector already.
+     * @param options - shared memory recorder options
+     * @return - ether pointer to an initialized recorder or an error info
+     */
+    static InitResult Init(const Options &options) {
+#ifdef SCL_HAS_SHM_RING
+        auto ring = detail::ShmRing::Open(options.name);
+        if (!ring) {
+            return InitError::CantOpenSharedMemory;
+        }
+
+        return ShmRecorderPtr<RecordT>(new ShmRecorder(options, std::move(ring)));
+#else
+        return InitError::SharedMemoryNotSupported;
+#endif
+    }
+
+    /**
+     * Default derived dtor.
+     */
+    ~ShmRecorder() final = default;
+
+    /**
+     * @overload
+     */
+    void OnRecord(const RecordT &record) final {
+#ifdef SCL_HAS_SHM_RING
+        // the buffer is reused by the records of the thread
+        thread_local std::string record_str;
+        record_str.clear();
+
+        if (m_options.align) {
+            record.AppendAlignedString(record_str);
+        } else {
+            record.AppendString(record_str);
+        }
+
+        m_ring->Push(static_cast<int>(record.level), record_str);
+#endif
+    }
+
+#ifdef SCL_HAS_SHM_RING
+    /**
+     * @return - counters of the ring (the records dropped because the ring was full and others)
+     */
+    [[nodiscard]]
+    inline detail::ShmRing::Stats GetStats() const {
+        return m_ring->GetStats();
+    }
+#endif
+
+private:
+#ifdef SCL_HAS_SHM_RING
+    /**
+     * Private ctor.
+     * @param options - shared memory recorder options
+     * @param ring - attached ring
+     */
+    ShmRecorder(Options options, std::unique_ptr<detail::ShmRing> ring)
+        : m_options(std::move(options)),
+          m_ring(std::move(ring)) {
+    }
+
+    /**
+     * Shared memory recorder options.
+     */
+    Options m_options;
+
+    std::unique_ptr<detail::ShmRing> m_ring;
+#endif
+};
+
+} // end of scl
@@ -0,0 +1,429 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <scl/recorder.h>
+#include <scl/record.h>
+#include <scl/detail/socket_frame.h>
+#include <scl/detail/unix_socket.h>
+
+namespace scl {
+
+template<typename RecordT>
+class SocketRecorder;
+
+/**
+ * Non-moving socket recorder pointer alias.
+ */
+template<typename RecordT>
+using SocketRecorderPtr = std::unique_ptr<SocketRecorder<RecordT>>;
+
+/**
+ * Socket recorder that implement the IRecorder interface.
+ * The recorder streams records over a Unix domain socket to a local collector (see the socket_collector tool),
+ * so the log files of a host are written by a single process without network dependencies.
+ * A record is sent as a frame: the level digit, the serialized record and the line break.
+ * The control characters and the backslash of the record are escaped, so a multi-line message is a single frame
+ * (see socket_frame.h).
+ *
+ * The records are buffered and sent by the recorder thread, many records per sendmsg().
+ * While the collector is unavailable the recorder reconnects with an exponential backoff
+ * and keeps the records within a bounded spill buffer, the records that don't fit the buffer are dropped and counted.
+ * While the recorder is connected the unsent records are bounded by the greater in-flight limit,
+ * so a burst that outpaces the recorder thread is not dropped. So the logging thread never waits for the socket.
+ * Note the recorder is supported on POSIX systems only.
+ * @tparam RecordT - type of record
+ */
+template<typename RecordT>
+class SocketRecorder : public IRecorder<RecordT> {
+public:
+    /**
+     * Initialization error info.
+     */
+    enum class InitError {
+        IncorrectSocketPath = 1,
+        UnixSocketNotSupported,
+    };
+
+    /**
+     * Initialization result: ether pointer to an initialized recorder or an error info.
+     */
+    using InitResult = std::variant<SocketRecorderPtr<RecordT>, InitError>;
+
+    /**
+     * Type of the Unix domain socket.
+     */
+    enum class SocketType {
+        /**
+         * SOCK_STREAM, a record partially sent before a disconnection is sent again after the reconnection.
+         */
+        Stream,
+
+        /**
+         * SOCK_SEQPACKET, a batch of records is delivered as a whole packet.
+         */
+        SeqPacket,
+    };
+
+    /**
+     * Socket recorder options.
+     */
+    struct Options {
+        /**
+         * Path to the socket of the collector.
+         */
+        std::string path;
+
+        SocketType type = SocketType::Stream;
+
+        /**
+         * Allow to align entry attributes, if the values is true.
+         */
+        bool align = false;
+
+        /**
+         * Max count of the records sent by a single sendmsg().
+         * The recorder thread is woken up when the batch is filled.
+         */
+        std::size_t batch_size = 256;
+
+        /**
+         * Max time that a record waits for the batch filling.
+         */
+        std::chrono::milliseconds flush_interval{50};
+
+        /**
+         * Max size of the records that are not sent yet while the collector is unavailable.
+         */
+        std::size_t spill_limit = 4 * 1024 * 1024;
+
+        /**
+         * Max size of the records that are not sent yet while the recorder is connected
+         * (eg a burst that outpaces the recorder thread or a collector that reads slowly).
+         */
+        std::size_t in_flight_limit = 64 * 1024 * 1024;
+
+        /**
+         * Initial and max delays of the reconnection, the delay is doubled after every failed attempt.
+         */
+        std::chrono::milliseconds reconnect_min{10};
+        std::chrono::milliseconds reconnect_max{5000};
+
+        /**
+         * Timeout of the sending, a collector that doesn't read the socket for the timeout is considered unavailable.
+         */
+        std::chrono::milliseconds send_timeout{1000};
+    };
+
+    static std::string ToStr(InitError err) {
+        switch (err) {
+            case InitError::IncorrectSocketPath:
+                return "IncorrectSocketPath";
+            case InitError::UnixSocketNotSupported:
+                return "UnixSocketNotSupported";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /**
+     * Init a SocketRecorder instance. The collector may be unavailable at the moment,
+     * the records are spilled until the recorder connects.
+     * @param options - socket recorder options
+     * @return - ether pointer to an initialized recorder or an error info
+     */
+    static InitResult Init(const Options &options) {
+#ifdef SCL_HAS_UNIX_SOCKET
+        if (!detail::IsUnixSocketPathCorrect(options.path)) {
+            return InitError::IncorrectSocketPath;
+        }
+
+        return SocketRecorderPtr<RecordT>(new SocketRecorder(options));
+#else
+        return InitError::UnixSocketNotSupported;
+#endif
+    }
+
+#ifdef SCL_HAS_UNIX_SOCKET
+    /**
+     * Send the remaining records if the collector is available and stop the recorder thread.
+     */
+    ~SocketRecorder() final {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopped = true;
+        }
+
+        m_wakeup.notify_one();
+        m_sender.join();
+    }
+
+    /**
+     * @overload
+     */
+    void OnRecord(const RecordT &record) final {
+        // the buffer is reused by the records of the thread
+        thread_local std::string frame;
+        frame.clear();
+        detail::AppendSocketFrame(frame, record, m_options.align);
+
+        bool is_batch_filled;
+        {
+            std::lock_guard lock(m_mutex);
+            const auto limit = m_connected.load(std::memory_order_relaxed) ? m_options.in_flight_limit
+                                                                           : m_options.spill_limit;
+            if (m_unsent_size + frame.size() > limit) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            m_pending += frame;
+            m_pending_ends.push_back(m_pending.size());
+            m_unsent_size += frame.size();
+            is_batch_filled = m_pending_ends.size() == m_options.batch_size;
+        }
+
+        if (is_batch_filled) {
+            m_wakeup.notify_one();
+        }
+    }
+
+    /**
+     * Wait until the buffered records are sent or the collector is found unavailable.
+     */
+    void Flush() {
+        std::unique_lock lock(m_mutex);
+        m_flush_requested = true;
+        m_wakeup.notify_one();
+        m_flushed.wait(lock, [this] { return !m_flush_requested; });
+    }
+
+    /**
+     * @return - count of the records dropped because the spill buffer (or the in-flight limit) was full
+     */
+    [[nodiscard]]
+    inline std::uint64_t Dropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return - true if the recorder is connected to the collector
+     */
+    [[nodiscard]]
+    inline bool IsConnected() const {
+        return m_connected.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * Private ctor.
+     * @param options - socket recorder options
+     */
+    explicit SocketRecorder(Options options)
+        : m_options(std::move(options)),
+          m_sender([this] { Run(); }) {
+    }
+
+    /**
+     * Recorder thread: send the batches and reconnect.
+     */
+    void Run() {
+        auto reconnect_delay = m_options.reconnect_min;
+
+        // the first records are not limited by the spill buffer if the collector is available
+        Connect();
+
+        std::unique_lock lock(m_mutex);
+        while (true) {
+            m_wakeup.wait_for(lock, m_options.flush_interval, [this] {
+                return m_stopped || m_flush_requested || m_pending_ends.size() >= m_options.batch_size;
+            });
+
+            const bool stopped = m_stopped;
+            bool is_sent = true;
+            // on the stop all the records are sent if the collector is available
+            do {
+                TakePending();
+                lock.unlock();
+                std::size_t sent_size = 0;
+                is_sent = SendTaken(sent_size);
+                lock.lock();
+                m_unsent_size -= sent_size;
+            } while (stopped && is_sent && !m_pending.empty());
+
+            if (!is_sent || (m_sending.empty() && m_pending.empty())) {
+                // the collector is unavailable, so the Flush() doesn't wait for the reconnection
+                m_flush_requested = false;
+                m_flushed.notify_all();
+            }
+
+            if (stopped) {
+                return;
+            }
+
+            if (is_sent) {
+                reconnect_delay = m_options.reconnect_min;
+                continue;
+            }
+
+            m_wakeup.wait_for(lock, reconnect_delay, [this] { return m_stopped; });
+            reconnect_delay = std::min(reconnect_delay * 2, m_options.reconnect_max);
+        }
+    }
+
+    /**
+     * Take the pending records if the previous records are sent.
+     * Note the method must be called under the lock.
+     */
+    void TakePending() {
+        if (!m_sending.empty() || m_pending.empty()) {
+            return;
+        }
+
+        m_sending.swap(m_pending);
+        m_sending_ends.swap(m_pending_ends);
+        m_pending.clear();
+        m_pending_ends.clear();
+        m_sent_records = 0;
+        m_sent_offset = 0;
+    }
+
+    /**
+     * Send the taken records.
+     * @param sent_size - size of the records that are sent entirely
+     * @return - false if the collector is unavailable
+     */
+    bool SendTaken(std::size_t &sent_size) {
+        const auto record_begin = [this](std::size_t index) {
+            return index == 0 ? std::size_t{0} : m_sending_ends[index - 1];
+        };
+
+        const std::size_t initial_offset = record_begin(m_sent_records);
+        std::size_t batch_size = std::max<std::size_t>(m_options.batch_size, 1);
+
+        while (m_sent_records < m_sending_ends.size()) {
+            if (!m_socket.IsConnected() && !Connect()) {
+                break;
+            }
+
+            const auto last_record = std::min(m_sent_records + batch_size, m_sending_ends.size());
+            const iovec buffer{m_sending.data() + m_sent_offset, m_sending_ends[last_record - 1] - m_sent_offset};
+            const auto sent = m_socket.Send(&buffer, 1);
+
+            if (sent < 0 && errno == EMSGSIZE) {
+                // the packet is larger than the socket buffer
+                if (batch_size > 1) {
+                    batch_size /= 2;
+                    continue;
+                }
+
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                m_sent_offset = m_sending_ends[m_sent_records++];
+                continue;
+            }
+
+            if (sent < 0) {
+                // a partially sent record will be sent again after the reconnection
+                m_sent_offset = record_begin(m_sent_records);
+                m_socket.Close();
+                m_connected.store(false, std::memory_order_relaxed);
+                break;
+            }
+
+            m_sent_offset += static_cast<std::size_t>(sent);
+            while (m_sent_records < m_sending_ends.size() && m_sending_ends[m_sent_records] <= m_sent_offset) {
+                ++m_sent_records;
+            }
+        }
+
+        sent_size = record_begin(m_sent_records) - initial_offset;
+        if (m_sent_records < m_sending_ends.size()) {
+            return false;
+        }
+
+        m_sending.clear();
+        m_sending_ends.clear();
+        return true;
+    }
+
+    bool Connect() {
+        const int type = m_options.type == SocketType::SeqPacket ? SOCK_SEQPACKET : SOCK_STREAM;
+        const bool is_connected = m_socket.Connect(m_options.path, type, m_options.send_timeout);
+        m_connected.store(is_connected, std::memory_order_relaxed);
+        return is_connected;
+    }
+
+    /**
+     * Socket recorder options.
+     */
+    Options m_options;
+
+    std::mutex m_mutex;
+
+    /**
+     * Wakes up the recorder thread.
+     */
+    std::condition_variable m_wakeup;
+
+    /**
+     * Notifies the Flush() callers.
+     */
+    std::condition_variable m_flushed;
+
+    /**
+     * Frames of the records that are not taken by the recorder thread and their end offsets.
+     */
+    std::string m_pending;
+    std::vector<std::size_t> m_pending_ends;
+
+    /**
+     * Size of the pending and taken records that are not sent yet.
+     */
+    std::size_t m_unsent_size = 0;
+
+    bool m_stopped = false;
+
+    bool m_flush_requested = false;
+
+    std::atomic<std::uint64_t> m_dropped{0};
+
+    std::atomic<bool> m_connected{false};
+
+    /**
+     * Records taken by the recorder thread, the count of the sent records and the offset of the sent data.
+     * The values are accessed by the recorder thread only.
+     */
+    std::string m_sending;
+    std::vector<std::size_t> m_sending_ends;
+    std::size_t m_sent_records = 0;
+    std::size_t m_sent_offset = 0;
+
+    detail::UnixSocket m_socket;
+
+    // the recorder thread must be initialized last since it uses the members
+    std::thread m_sender;
+#else
+    void OnRecord(const RecordT &) final {
+    }
+#endif
+};
+
+} // end of scl
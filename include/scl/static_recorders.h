@@ -0,0 +1,87 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <tuple>
+
+#include <scl/recorder.h>
+
+namespace scl {
+
+/**
+ * Recorder set policy composed at compile time.
+ * The record is passed to the recorders by a fold expression over the concrete recorder types,
+ * so there is no virtual dispatch and the OnRecord() calls can be inlined.
+ * A recorder type is not required to implement the IRecorder interface,
+ * it must only provide the OnRecord(const RecordT &) method.
+ *
+ * Usage:
+ *   using Recorders = scl::StaticRecorders<FileRecorder<CoreRecord>, ConsoleRecorder<CoreRecord>>;
+ *   using Logger = cis1::core_logger::BasicCoreLogger<Recorders>;
+ *   Logger::Init(options, Recorders(std::move(file_recorder), std::move(console_recorder)));
+ *
+ * @tparam RecorderTypes - concrete recorder types
+ */
+template<typename ...RecorderTypes>
+class StaticRecorders {
+public:
+    static_assert(sizeof...(RecorderTypes) > 0, "there must be at least one recorder");
+
+    using PolicyTag = RecordersPolicyTag;
+
+    /**
+     * Ctor.
+     * @param recorders - recorders that will handle log records
+     */
+    explicit StaticRecorders(std::unique_ptr<RecorderTypes> ...recorders)
+        : m_recorders(std::move(recorders)...) {
+    }
+
+    /**
+     * @return - always false, the set cannot be empty
+     */
+    [[nodiscard]]
+    inline constexpr bool Empty() const {
+        return false;
+    }
+
+    /**
+     * @return - true if every recorder is allocated
+     */
+    [[nodiscard]]
+    inline bool Allocated() const {
+        return std::apply([](const auto &...recorders) { return (static_cast<bool>(recorders) && ...); },
+                          m_recorders);
+    }
+
+    /**
+     * Get a recorder by its type.
+     * @tparam RecorderT - type of the recorder
+     * @return - reference to the recorder
+     */
+    template<typename RecorderT>
+    inline RecorderT &Get() {
+        return *std::get<std::unique_ptr<RecorderT>>(m_recorders);
+    }
+
+    /**
+     * Pass the record to every recorder.
+     * @param record - record info that should be handled.
+     */
+    template<typename RecordT>
+    inline void Dispatch(const RecordT &record) {
+        std::apply([&record](auto &...recorders) { (recorders->OnRecord(record), ...); }, m_recorders);
+    }
+
+private:
+    std::tuple<std::unique_ptr<RecorderTypes>...> m_recorders;
+};
+
+} // end of scl
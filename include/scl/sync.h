@@ -0,0 +1,113 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains synchronization strategies of the recorders and loggers.
+ * Every strategy satisfies the Lockable requirements and is passed as a template parameter,
+ * so the choice does not depend on the compilation flags of a translation unit:
+ *   sync::None - no synchronization, for single-threaded applications;
+ *   sync::Mutex - std::mutex;
+ *   sync::SpinLock - spin lock with an exponential backoff, for short critical sections.
+ * The lock-free reservation strategy is provided by the queueing::LockFree<N> queue of an asynchronous logger.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace scl::sync {
+
+/**
+ * No synchronization.
+ */
+struct None {
+    inline void lock() {
+    }
+
+    inline bool try_lock() {
+        return true;
+    }
+
+    inline void unlock() {
+    }
+};
+
+/**
+ * Mutex synchronization.
+ */
+using Mutex = std::mutex;
+
+namespace detail {
+
+/**
+ * Exponential backoff: spin with a CPU relax hint, then yield the thread.
+ */
+class Backoff {
+public:
+    inline void Pause() {
+        if (m_spins < max_spins_k) {
+            for (unsigned i = 0; i < m_spins; ++i) {
+                Relax();
+            }
+
+            m_spins *= 2;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    static inline void Relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    static constexpr unsigned max_spins_k = 64;
+
+    unsigned m_spins = 1;
+};
+
+} // end of detail
+
+/**
+ * Test-and-test-and-set spin lock with an exponential backoff.
+ */
+class SpinLock {
+public:
+    inline void lock() {
+        detail::Backoff backoff;
+        while (!try_lock()) {
+            // wait until the lock seems to be free without the cache line invalidation
+            while (m_locked.load(std::memory_order_relaxed)) {
+                backoff.Pause();
+            }
+        }
+    }
+
+    inline bool try_lock() {
+        return !m_locked.exchange(true, std::memory_order_acquire);
+    }
+
+    inline void unlock() {
+        m_locked.store(false, std::memory_order_release);
+    }
+
+private:
+    std::atomic<bool> m_locked{false};
+};
+
+} // end of scl::sync
@@ -0,0 +1,514 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <scl/levels.h>
+#include <scl/process_id.h>
+#include <scl/recorder.h>
+#include <scl/record.h>
+#include <scl/detail/datagram_socket.h>
+#include <scl/detail/record_fields.h>
+#include <scl/detail/record_format.h>
+
+namespace scl {
+
+template<typename RecordT>
+class SyslogRecorder;
+
+/**
+ * Non-moving syslog recorder pointer alias.
+ */
+template<typename RecordT>
+using SyslogRecorderPtr = std::unique_ptr<SyslogRecorder<RecordT>>;
+
+/**
+ * Syslog recorder that implement the IRecorder interface.
+ * The recorder sends the RFC 5424 frames over a UDP or Unix domain datagram socket:
+ *   <PRI>1 TIMESTAMP HOSTNAME APP-NAME PROCID MSGID - MSG
+ * where the PRI is precomputed for every level, the PROCID is the record pid (if the record has the field),
+ * the MSGID is the record action or handler (if the record has the field) and the MSG is the serialized record.
+ *
+ * The frames are buffered and sent by the recorder thread, a batch per sendmmsg() call.
+ * The socket is non-blocking: if the socket buffer or the recorder buffer is full,
+ * the frames are dropped and counted, so the logging thread never stalls.
+ * Note the recorder is supported on POSIX systems only.
+ * @tparam RecordT - type of record
+ */
+template<typename RecordT>
+class SyslogRecorder : public IRecorder<RecordT> {
+public:
+    /**
+     * Initialization error info.
+     */
+    enum class InitError {
+        CantConnect = 1,
+        IncorrectSocketPath,
+        SyslogNotSupported,
+    };
+
+    /**
+     * Initialization result: ether pointer to an initialized recorder or an error info.
+     */
+    using InitResult = std::variant<SyslogRecorderPtr<RecordT>, InitError>;
+
+    /**
+     * Transport of the frames.
+     */
+    enum class Transport {
+        Udp,
+        UnixDatagram,
+    };
+
+    /**
+     * Syslog facilities (RFC 5424).
+     */
+    enum class Facility : int {
+        Kernel = 0,
+        User = 1,
+        Daemon = 3,
+        Local0 = 16,
+        Local1,
+        Local2,
+        Local3,
+        Local4,
+        Local5,
+        Local6,
+        Local7,
+    };
+
+    /**
+     * Syslog recorder options.
+     */
+    struct Options {
+        Transport transport = Transport::Udp;
+
+        /**
+         * Address of the UDP syslog server.
+         */
+        std::string host = "127.0.0.1";
+        std::uint16_t port = 514;
+
+        /**
+         * Path to the Unix domain datagram socket.
+         */
+        std::string path = "/dev/log";
+
+        Facility facility = Facility::User;
+
+        /**
+         * APP-NAME of the frames.
+         */
+        std::string app_name = "-";
+
+        /**
+         * HOSTNAME of the frames, the name of the host by default.
+         */
+        std::optional<std::string> hostname = std::nullopt;
+
+        /**
+         * Max count of the frames sent by a single sendmmsg().
+         * The recorder thread is woken up when the batch is filled.
+         */
+        std::size_t batch_size = 64;
+
+        /**
+         * Max time that a frame waits for the batch filling.
+         */
+        std::chrono::milliseconds flush_interval{20};
+
+        /**
+         * Max count of the frames that are not sent yet, the frames over the limit are dropped.
+         */
+        std::size_t queue_limit = 8192;
+
+        /**
+         * Max size of a frame, a longer frame is truncated.
+         */
+        std::size_t max_frame_size = 2048;
+    };
+
+    static std::string ToStr(InitError err) {
+        switch (err) {
+            case InitError::CantConnect:
+                return "CantConnect";
+            case InitError::IncorrectSocketPath:
+                return "IncorrectSocketPath";
+            case InitError::SyslogNotSupported:
+                return "SyslogNotSupported";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /**
+     * Init a SyslogRecorder instance.
+     * @param options - syslog recorder options
+     * @return - ether pointer to an initialized recorder or an error info
+     */
+    static InitResult Init(const Options &options) {
+#ifdef SCL_HAS_UNIX_SOCKET
+        SyslogRecorderPtr<RecordT> instance(new SyslogRecorder(options));
+        if (options.transport == Transport::UnixDatagram) {
+            if (!detail::IsUnixSocketPathCorrect(options.path)) {
+                return InitError::IncorrectSocketPath;
+            }
+
+            if (!instance->m_socket.ConnectUnix(options.path)) {
+                return InitError::CantConnect;
+            }
+        } else if (!instance->m_socket.ConnectUdp(options.host, options.port)) {
+            return InitError::CantConnect;
+        }
+
+        instance->Start();
+        return instance;
+#else
+        return InitError::SyslogNotSupported;
+#endif
+    }
+
+    /**
+     * Map the level to the syslog severity.
+     * @param level - level
+     * @return - severity (RFC 5424)
+     */
+    static constexpr int Severity(Level level) {
+        switch (level) {
+            case Level::Action:
+                // notice
+                return 5;
+            case Level::Error:
+                return 3;
+            case Level::Info:
+                // informational
+                return 6;
+            case Level::Debug:
+                return 7;
+            default:
+                return 6;
+        }
+    }
+
+#ifdef SCL_HAS_UNIX_SOCKET
+    /**
+     * Send the remaining frames and stop the recorder thread.
+     */
+    ~SyslogRecorder() final {
+        if (m_sender.joinable()) {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stopped = true;
+            }
+
+            m_wakeup.notify_one();
+            m_sender.join();
+        }
+    }
+
+    /**
+     * @overload
+     */
+    void OnRecord(const RecordT &record) final {
+        // the buffer is reused by the records of the thread
+        thread_local std::string frame;
+        frame.clear();
+        WriteFrame(frame, record);
+
+        if (frame.size() > m_options.max_frame_size) {
+            frame.resize(m_options.max_frame_size);
+        }
+
+        bool is_batch_filled;
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_pending_ends.size() >= m_options.queue_limit) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            m_pending += frame;
+            m_pending_ends.push_back(m_pending.size());
+            is_batch_filled = m_pending_ends.size() == m_options.batch_size;
+        }
+
+        if (is_batch_filled) {
+            m_wakeup.notify_one();
+        }
+    }
+
+    /**
+     * Wait until the buffered frames are sent or dropped.
+     */
+    void Flush() {
+        std::unique_lock lock(m_mutex);
+        m_flush_requested = true;
+        m_wakeup.notify_one();
+        m_flushed.wait(lock, [this] { return !m_flush_requested; });
+    }
+
+    /**
+     * @return - count of the frames dropped because the socket buffer or the recorder buffer was full
+     */
+    [[nodiscard]]
+    inline std::uint64_t Dropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * Private ctor.
+     * @param options - syslog recorder options
+     */
+    explicit SyslogRecorder(Options options)
+        : m_options(std::move(options)),
+          m_pid(::getpid()) {
+        const auto facility = static_cast<int>(m_options.facility);
+        for (std::size_t level = 0; level < m_priorities.size(); ++level) {
+            const auto priority = facility * 8 + Severity(static_cast<Level>(level));
+            m_priorities[level] = "<" + std::to_string(priority) + ">1 ";
+        }
+
+        std::string hostname = m_options.hostname.value_or("");
+        if (hostname.empty()) {
+            char buffer[256] = {0};
+            hostname = ::gethostname(buffer, sizeof(buffer) - 1) == 0 && buffer[0] != '\0' ? buffer : "-";
+        }
+
+        m_header = " " + hostname + " " + (m_options.app_name.empty() ? "-" : m_options.app_name) + " ";
+    }
+
+    void Start() {
+        m_sender = std::thread([this] { Run(); });
+    }
+
+    /**
+     * Write the RFC 5424 frame of the record.
+     * @param dst - destination string
+     * @param record - record
+     */
+    void WriteFrame(std::string &dst, const RecordT &record) const {
+        const auto level = static_cast<std::size_t>(record.level);
+        dst += level < m_priorities.size() ? m_priorities[level] : m_priorities[static_cast<int>(Level::Info)];
+        dst += TimestampView();
+        dst += m_header;
+
+        char pid_buffer[24];
+        if constexpr (detail::HasPid<RecordT>::value) {
+            dst += detail::IntegerToChars(pid_buffer, record.pid);
+        } else {
+            dst += detail::IntegerToChars(pid_buffer, m_pid);
+        }
+
+        dst += ' ';
+        if constexpr (detail::HasAction<RecordT>::value) {
+            AppendMessageId(dst, record.action);
+        } else if constexpr (detail::HasHandler<RecordT>::value) {
+            AppendMessageId(dst, record.handler);
+        } else {
+            dst += '-';
+        }
+
+        // there is no structured data
+        dst += " - ";
+        record.AppendString(dst);
+    }
+
+    /**
+     * Append the MSGID: up to 32 printable US-ASCII characters or the NILVALUE.
+     */
+    static void AppendMessageId(std::string &dst, const std::optional<std::string_view> &id) {
+        constexpr std::size_t max_size_k = 32;
+        if (!id || id->empty()) {
+            dst += '-';
+            return;
+        }
+
+        for (const char ch : id->substr(0, max_size_k)) {
+            dst += ch > ' ' && ch < 127 ? ch : '_';
+        }
+    }
+
+    /**
+     * Current RFC 3339 UTC timestamp with milliseconds.
+     * The seconds are cached by the calling thread and are refreshed once per second.
+     * @return - view of the thread local buffer, valid until the next call on the same thread
+     */
+    static std::string_view TimestampView() {
+        thread_local std::time_t cached_time = -1;
+        // "YYYY-MM-DDTHH:MM:SS.mmmZ"
+        thread_local char buffer[32] = {0};
+        thread_local std::size_t size = 0;
+
+        const auto now = std::chrono::system_clock::now();
+        const auto t = std::chrono::system_clock::to_time_t(now);
+        if (t != cached_time) {
+            std::tm tm{};
+            ::gmtime_r(&t, &tm);
+            size = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &tm);
+            cached_time = t;
+        }
+
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+        buffer[size] = '.';
+        buffer[size + 1] = static_cast<char>('0' + ms / 100);
+        buffer[size + 2] = static_cast<char>('0' + ms / 10 % 10);
+        buffer[size + 3] = static_cast<char>('0' + ms % 10);
+        buffer[size + 4] = 'Z';
+        return {buffer, size + 5};
+    }
+
+    /**
+     * Recorder thread: send the batches.
+     */
+    void Run() {
+        std::string sending;
+        std::vector<std::size_t> sending_ends;
+
+        std::unique_lock lock(m_mutex);
+        while (true) {
+            m_wakeup.wait_for(lock, m_options.flush_interval, [this] {
+                return m_stopped || m_flush_requested || m_pending_ends.size() >= m_options.batch_size;
+            });
+
+            const bool stopped = m_stopped;
+            sending.swap(m_pending);
+            sending_ends.swap(m_pending_ends);
+            m_pending.clear();
+            m_pending_ends.clear();
+
+            lock.unlock();
+            Send(sending, sending_ends);
+            lock.lock();
+
+            if (m_pending_ends.empty()) {
+                m_flush_requested = false;
+                m_flushed.notify_all();
+            }
+
+            if (stopped) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * Send the frames by the batches, the frames that don't fit the socket buffer are dropped.
+     * @param frames - frames
+     * @param ends - end offsets of the frames
+     */
+    void Send(const std::string &frames, const std::vector<std::size_t> &ends) {
+        const auto batch_size = std::max<std::size_t>(m_options.batch_size, 1);
+
+        std::size_t first = 0;
+        while (first < ends.size()) {
+            const auto last = std::min(first + batch_size, ends.size());
+            m_datagrams.clear();
+            for (auto i = first; i < last; ++i) {
+                const auto begin = i == 0 ? std::size_t{0} : ends[i - 1];
+                m_datagrams.push_back({const_cast<char *>(frames.data()) + begin, ends[i] - begin});
+            }
+
+            const int sent = m_socket.Send(m_datagrams);
+            if (sent <= 0) {
+                // the socket buffer is full or the receiver is unavailable
+                m_dropped.fetch_add(last - first, std::memory_order_relaxed);
+                if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+                    Reconnect();
+                }
+
+                first = last;
+                continue;
+            }
+
+            first += static_cast<std::size_t>(sent);
+        }
+    }
+
+    /**
+     * Reconnect the socket, eg after the restart of the local syslog daemon.
+     */
+    void Reconnect() {
+        if (m_options.transport == Transport::UnixDatagram) {
+            m_socket.ConnectUnix(m_options.path);
+        } else {
+            m_socket.ConnectUdp(m_options.host, m_options.port);
+        }
+    }
+
+    /**
+     * Syslog recorder options.
+     */
+    Options m_options;
+
+    ProcessId m_pid;
+
+    /**
+     * "<PRI>1 " prefixes of the levels.
+     */
+    std::array<std::string, 4> m_priorities;
+
+    /**
+     * " HOSTNAME APP-NAME " part of the frames.
+     */
+    std::string m_header;
+
+    std::mutex m_mutex;
+
+    /**
+     * Wakes up the recorder thread.
+     */
+    std::condition_variable m_wakeup;
+
+    /**
+     * Notifies the Flush() callers.
+     */
+    std::condition_variable m_flushed;
+
+    /**
+     * Frames that are not taken by the recorder thread and their end offsets.
+     */
+    std::string m_pending;
+    std::vector<std::size_t> m_pending_ends;
+
+    bool m_stopped = false;
+
+    bool m_flush_requested = false;
+
+    std::atomic<std::uint64_t> m_dropped{0};
+
+    /**
+     * Socket and datagram buffers, they are accessed by the recorder thread only after the start.
+     */
+    detail::DatagramSocket m_socket;
+    std::vector<iovec> m_datagrams;
+
+    std::thread m_sender;
+#else
+    void OnRecord(const RecordT &) final {
+    }
+#endif
+};
+
+} // end of scl
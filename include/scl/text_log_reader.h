@@ -0,0 +1,380 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include <scl/levels.h>
+#include <scl/process_id.h>
+#include <scl/detail/format_defines.h>
+#include <scl/detail/mapped_file.h>
+#include <scl/detail/misc.h>
+#include <scl/detail/record_format.h>
+#include <scl/detail/text_scan.h>
+
+namespace scl {
+
+/**
+ * Zero-copy view of a plain or aligned text record (see IRecord::ToString() and IRecord::ToAlignedString()):
+ * the line is split by the " | " separators to the fields, the left indent of the aligned fields is skipped.
+ * The first field is the time. If a line has more than max_fields_k fields (eg the message contains separators),
+ * the last field is the rest of the line.
+ */
+class TextRecordView {
+public:
+    static constexpr std::size_t max_fields_k = 16;
+
+    /**
+     * @return - line without the line break
+     */
+    [[nodiscard]]
+    inline std::string_view Line() const {
+        return {m_begin, static_cast<std::size_t>(m_end - m_begin)};
+    }
+
+    /**
+     * @return - count of the fields
+     */
+    [[nodiscard]]
+    inline std::size_t FieldsCount() const {
+        return m_separators_count + 1;
+    }
+
+    /**
+     * @param index - index of the field
+     * @return - field or an empty view if there is no such field
+     */
+    [[nodiscard]]
+    std::string_view Field(std::size_t index) const {
+        if (index > m_separators_count) {
+            return {};
+        }
+
+        const char *begin = index == 0 ? m_begin : m_separators[index - 1] + detail::log_formatting::separator_k.size();
+        const char *end = index == m_separators_count ? m_end : m_separators[index];
+        while (begin < end && *begin == ' ') {
+            ++begin;
+        }
+
+        return {begin, static_cast<std::size_t>(end - begin)};
+    }
+
+    /**
+     * @return - time of the record in the CurTimeStr() format
+     */
+    [[nodiscard]]
+    inline std::string_view Time() const {
+        return Field(0);
+    }
+
+    /**
+     * @return - sequence number of the record (the "#<sequence>" field that follows the time, see IRecord::Sequence())
+     *           or std::nullopt if the record is not numbered
+     */
+    [[nodiscard]]
+    inline std::optional<std::uint64_t> Sequence() const {
+        return detail::ParseSequenceToken(Field(1));
+    }
+
+    /**
+     * @return - last field of the record (the message)
+     */
+    [[nodiscard]]
+    inline std::string_view Message() const {
+        return Field(m_separators_count);
+    }
+
+private:
+    friend class TextLogReader;
+
+    inline void Start(const char *begin) {
+        m_begin = begin;
+        m_separators_count = 0;
+    }
+
+    inline void AddSeparator(const char *separator) {
+        if (m_separators_count < m_separators.size()) {
+            m_separators[m_separators_count++] = separator;
+        }
+    }
+
+    inline void Finish(const char *end) {
+        m_end = end;
+    }
+
+    const char *m_begin = nullptr;
+
+    const char *m_end = nullptr;
+
+    /**
+     * Beginnings of the " | " separators.
+     */
+    std::array<const char *, max_fields_k - 1> m_separators{};
+
+    std::size_t m_separators_count = 0;
+};
+
+class TextLogReader;
+
+/**
+ * Non-moving text log reader pointer alias.
+ */
+using TextLogReaderPtr = std::unique_ptr<TextLogReader>;
+
+/**
+ * Reader of the plain and aligned text log files.
+ * The file is memory-mapped (POSIX only), the line breaks and the separators are found by the SIMD comparisons
+ * of 64-byte blocks (see detail/text_scan.h) and the records are passed to the callback as the zero-copy views.
+ * The static ScanText() method scans any text data (eg a region found by the LogIndexReader).
+ */
+class TextLogReader {
+public:
+    /**
+     * Initialization error info.
+     */
+    enum class InitError {
+        CantOpenFile = 1,
+        MappedFileNotSupported,
+    };
+
+    /**
+     * Initialization result: ether pointer to an initialized reader or an error info.
+     */
+    using InitResult = std::variant<TextLogReaderPtr, InitError>;
+
+    /**
+     * Record filter, a record is passed to the callback if it matches all the set conditions.
+     */
+    struct Filter {
+        /**
+         * The records before the time are skipped (see TimeStrToSeconds()).
+         */
+        std::optional<std::int64_t> min_time = std::nullopt;
+
+        /**
+         * The records after the time are skipped (see TimeStrToSeconds()).
+         */
+        std::optional<std::int64_t> max_time = std::nullopt;
+
+        /**
+         * The records below the level are skipped (the level is read from the level_field).
+         */
+        std::optional<Level> level = std::nullopt;
+
+        /**
+         * Index of the level field (eg 1 for WebuiRecord or 2 for the numbered one, see TextRecordView::Sequence()).
+         */
+        std::size_t level_field = 1;
+
+        /**
+         * The records of other processes are skipped (the pid is read from the pid_field).
+         */
+        std::optional<ProcessId> pid = std::nullopt;
+
+        /**
+         * Index of the pid field (eg 2 for CoreRecord or 3 for the numbered one, see TextRecordView::Sequence()).
+         */
+        std::size_t pid_field = 2;
+
+        /**
+         * The records that don't contain the substring are skipped.
+         */
+        std::string substring;
+    };
+
+    /**
+     * Scan statistics.
+     */
+    struct ScanStats {
+        std::size_t lines_count = 0;
+        std::size_t matched_count = 0;
+    };
+
+    static std::string ToStr(InitError err) {
+        switch (err) {
+            case InitError::CantOpenFile:
+                return "CantOpenFile";
+            case InitError::MappedFileNotSupported:
+                return "MappedFileNotSupported";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /**
+     * Init a TextLogReader instance.
+     * @param path - path to the log file
+     * @return - ether pointer to an initialized reader or an error info
+     */
+    static InitResult Init([[maybe_unused]] const std::filesystem::path &path) {
+#ifdef SCL_HAS_MAPPED_FILE
+        TextLogReaderPtr instance(new TextLogReader());
+        instance->m_file = detail::MappedFile::Open(path);
+        if (!instance->m_file) {
+            return InitError::CantOpenFile;
+        }
+
+        instance->m_file->AdviseSequential(0);
+        return instance;
+#else
+        return InitError::MappedFileNotSupported;
+#endif
+    }
+
+#ifdef SCL_HAS_MAPPED_FILE
+    /**
+     * @return - data of the log file
+     */
+    [[nodiscard]]
+    inline std::string_view Data() const {
+        return m_file->Data();
+    }
+
+    /**
+     * Scan the log file, see ScanText().
+     */
+    template<typename FnT>
+    ScanStats Scan(const Filter &filter, FnT &&fn) const {
+        return ScanText(Data(), filter, std::forward<FnT>(fn));
+    }
+#endif
+
+    /**
+     * Scan the text records.
+     * The last line is skipped if it doesn't end with the line break (the record is being written).
+     * @param data - text data that starts with a record
+     * @param filter - record filter
+     * @param fn - function that is called with every matched record (const TextRecordView &),
+     *             the view is valid within the call only
+     * @return - scan statistics
+     */
+    template<typename FnT>
+    static ScanStats ScanText(std::string_view data, const Filter &filter, FnT &&fn) {
+        namespace Scan = detail::text_scan;
+
+        const RecordMatcher matcher(filter);
+        const char *base = data.data();
+        const std::size_t size = data.size();
+
+        ScanStats stats;
+        TextRecordView record;
+        record.Start(base);
+        for (std::size_t block = 0; block < size; block += Scan::block_size_k) {
+            const auto masks = detail::FindStructuralTail(base + block, size - block);
+            auto bits = masks.line_breaks | masks.separators;
+            while (bits != 0) {
+                const std::size_t pos = block + detail::LowestBit(bits);
+                bits &= bits - 1;
+
+                if (base[pos] == '\n') {
+                    record.Finish(base + pos);
+                    ++stats.lines_count;
+                    if (matcher.Matches(record)) {
+                        ++stats.matched_count;
+                        fn(static_cast<const TextRecordView &>(record));
+                    }
+
+                    record.Start(base + pos + 1);
+                } else if (base + pos > record.m_begin && base[pos - 1] == ' ' && pos + 1 < size && base[pos + 1] == ' ') {
+                    record.AddSeparator(base + pos - 1);
+                }
+            }
+        }
+
+        return stats;
+    }
+
+private:
+    /**
+     * Filter prepared to the matching: the time bounds are compared as the fixed-width strings
+     * (the order of the CurTimeStr() strings is the order of the times), so the times are not parsed.
+     */
+    class RecordMatcher {
+    public:
+        explicit RecordMatcher(const Filter &filter)
+            : m_filter(filter),
+              m_min_time(filter.min_time ? SecondsToTimeStr(*filter.min_time) : std::string()),
+              m_max_time(filter.max_time ? SecondsToTimeStr(*filter.max_time) : std::string()),
+              m_searcher(filter.substring.begin(), filter.substring.end()) {
+        }
+
+        bool Matches(const TextRecordView &record) const {
+            if (m_filter.min_time || m_filter.max_time) {
+                const auto time = record.Time();
+                if (time.size() != detail::log_formatting::time_length_k
+                    || (m_filter.min_time && time < m_min_time)
+                    || (m_filter.max_time && time > m_max_time)) {
+                    return false;
+                }
+            }
+
+            if (m_filter.level) {
+                const auto level = ParseLevel(record.Field(m_filter.level_field));
+                if (!level || static_cast<int>(*level) > static_cast<int>(*m_filter.level)) {
+                    return false;
+                }
+            }
+
+            if (m_filter.pid) {
+                const auto field = record.Field(m_filter.pid_field);
+                ProcessId pid{};
+                const auto result = std::from_chars(field.data(), field.data() + field.size(), pid);
+                if (result.ec != std::errc() || result.ptr != field.data() + field.size() || pid != *m_filter.pid) {
+                    return false;
+                }
+            }
+
+            if (!m_filter.substring.empty()) {
+                const auto line = record.Line();
+                if (std::search(line.begin(), line.end(), m_searcher) == line.end()) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    private:
+        static std::optional<Level> ParseLevel(std::string_view field) {
+            for (const auto level : {Level::Action, Level::Error, Level::Info, Level::Debug}) {
+                if (field == LevelToStringView(level)) {
+                    return level;
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        const Filter &m_filter;
+
+        std::string m_min_time;
+
+        std::string m_max_time;
+
+        std::boyer_moore_horspool_searcher<std::string::const_iterator> m_searcher;
+    };
+
+    TextLogReader() = default;
+
+#ifdef SCL_HAS_MAPPED_FILE
+    std::unique_ptr<detail::MappedFile> m_file;
+#endif
+};
+
+} // end of scl
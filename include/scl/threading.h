@@ -0,0 +1,475 @@
+/*
+ *    TomskSoft SC_LOGGER
+ *
+ *   (c) 2020 TomskSoft LLC
+ *   (c) Sergey Boyko [bso@tomsksoft.com]
+ *
+ */
+
+/**
+ * The file contains threading and queueing policies of the scl::Logger.
+ * A threading policy defines how a record is delivered from a logging thread to the recorders:
+ *   threading::Sync - recorders are called on the logging thread without any synchronization;
+ *   threading::Locked<SyncT> - recorders are called on the logging thread under a lock (see scl/sync.h);
+ *   threading::Async<QueueT> - records are queued and recorders are called on a worker thread.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <scl/sync.h>
+#include <scl/detail/record_storage.h>
+
+namespace scl {
+
+/**
+ * Category tag of the threading policies.
+ */
+struct ThreadingPolicyTag {
+};
+
+/**
+ * Category tag of the queueing policies.
+ */
+struct QueueingPolicyTag {
+};
+
+namespace detail {
+
+/**
+ * Multi-producer single-consumer queue of the records.
+ * The consumer takes all the queued records at once to reduce the mutex contention.
+ * @tparam T - type of the queued values
+ * @tparam Capacity - max count of the queued values (0 means unbounded)
+ */
+template<typename T, std::size_t Capacity>
+class RecordQueue {
+public:
+    using Batch = std::deque<T>;
+
+    /**
+     * Push a value to the queue.
+     * If the queue is bounded and full, wait until the consumer takes the queued values.
+     * @param value - pushing value
+     */
+    void Push(T &&value) {
+        std::unique_lock lock(m_mutex);
+        if constexpr (Capacity != 0) {
+            m_not_full.wait(lock, [this] { return m_queue.size() < Capacity || m_closed; });
+        }
+
+        m_queue.push_back(std::move(value));
+        lock.unlock();
+        m_not_empty.notify_one();
+    }
+
+    /**
+     * Take all the queued values. Wait if there are no values.
+     * @param batch - destination container, must be empty
+     * @return - false if the queue is closed and there are no more values, else true
+     */
+    bool PopAll(Batch &batch) {
+        std::unique_lock lock(m_mutex);
+        m_not_empty.wait(lock, [this] { return !m_queue.empty() || m_closed; });
+        if (m_queue.empty()) {
+            return false;
+        }
+
+        batch.swap(m_queue);
+        ++m_in_flight;
+        lock.unlock();
+
+        if constexpr (Capacity != 0) {
+            m_not_full.notify_all();
+        }
+
+        return true;
+    }
+
+    /**
+     * Mark the last taken batch as handled.
+     */
+    void Done() {
+        {
+            std::lock_guard lock(m_mutex);
+            --m_in_flight;
+        }
+
+        m_drained.notify_all();
+    }
+
+    /**
+     * Wait until all the queued values are handled by the consumer.
+     */
+    void WaitDrained() {
+        std::unique_lock lock(m_mutex);
+        m_drained.wait(lock, [this] { return m_queue.empty() && !m_in_flight; });
+    }
+
+    /**
+     * Close the queue: the consumer will take the remaining values and stop.
+     */
+    void Close() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_closed = true;
+        }
+
+        m_not_empty.notify_all();
+        m_not_full.notify_all();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::condition_variable m_drained;
+    Batch m_queue;
+    std::size_t m_in_flight = 0;
+    bool m_closed = false;
+};
+
+/**
+ * Bounded multi-producer single-consumer lock-free queue of the records.
+ * A producer reserves a slot by a CAS on the enqueue position,
+ * every slot has a sequence number that tells if the slot is free or filled.
+ * @tparam T - type of the queued values
+ * @tparam Capacity - max count of the queued values, must be a power of 2
+ */
+template<typename T, std::size_t Capacity>
+class LockFreeRecordQueue {
+public:
+    using Batch = std::deque<T>;
+
+    LockFreeRecordQueue()
+        : m_slots(new Slot[Capacity]) {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Push a value to the queue. If the queue is full, wait until the consumer takes a value.
+     * @param value - pushing value
+     */
+    void Push(T &&value) {
+        sync::detail::Backoff backoff;
+        std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        Slot *slot = nullptr;
+        while (true) {
+            slot = &m_slots[pos & mask_k];
+            const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                // the slot is free, try to reserve it
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // the queue is full
+                backoff.Pause();
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            } else {
+                // another producer has reserved the slot
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value.emplace(std::move(value));
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        // pairs with the fence of the PopAll(): either the consumer sees the filled slot or the producer sees the flag
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_consumer_waits.load(std::memory_order_relaxed)) {
+            std::lock_guard lock(m_mutex);
+            m_not_empty.notify_one();
+        }
+    }
+
+    /**
+     * Take all the queued values. Wait if there are no values.
+     * @param batch - destination container, must be empty
+     * @return - false if the queue is closed and there are no more values, else true
+     */
+    bool PopAll(Batch &batch) {
+        while (!TakeReady(batch)) {
+            if (m_closed.load(std::memory_order_acquire)) {
+                // the producers could push values before the queue has been closed
+                return TakeReady(batch);
+            }
+
+            std::unique_lock lock(m_mutex);
+            m_consumer_waits.store(true, std::memory_order_relaxed);
+            // pairs with the fence of the Push(): a producer that fills the slot after the check sees the flag
+            // and notifies under the mutex, so the notification can't be sent between the check and the wait
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!IsReady() && !m_closed.load(std::memory_order_acquire)) {
+                m_not_empty.wait(lock);
+            }
+
+            m_consumer_waits.store(false, std::memory_order_relaxed);
+        }
+
+        return true;
+    }
+
+    /**
+     * Mark the last taken batch as handled.
+     */
+    void Done() {
+        m_handled.store(m_dequeue_pos, std::memory_order_release);
+    }
+
+    /**
+     * Wait until all the queued values are handled by the consumer.
+     */
+    void WaitDrained() {
+        sync::detail::Backoff backoff;
+        while (m_handled.load(std::memory_order_acquire) != m_enqueue_pos.load(std::memory_order_acquire)) {
+            backoff.Pause();
+        }
+    }
+
+    /**
+     * Close the queue: the consumer will take the remaining values and stop.
+     */
+    void Close() {
+        m_closed.store(true, std::memory_order_release);
+        std::lock_guard lock(m_mutex);
+        m_not_empty.notify_all();
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        std::optional<T> value;
+    };
+
+    static constexpr std::size_t mask_k = Capacity - 1;
+
+    /**
+     * Check if the next slot is filled (only the consumer calls the method).
+     */
+    bool IsReady() const {
+        const Slot &slot = m_slots[m_dequeue_pos & mask_k];
+        return slot.sequence.load(std::memory_order_acquire) == m_dequeue_pos + 1;
+    }
+
+    /**
+     * Move the filled values to the batch (only the consumer calls the method).
+     * @return - true if at least one value has been taken
+     */
+    bool TakeReady(Batch &batch) {
+        while (IsReady()) {
+            Slot &slot = m_slots[m_dequeue_pos & mask_k];
+            batch.push_back(std::move(*slot.value));
+            slot.value.reset();
+            slot.sequence.store(m_dequeue_pos + Capacity, std::memory_order_release);
+            ++m_dequeue_pos;
+        }
+
+        return !batch.empty();
+    }
+
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<std::size_t> m_enqueue_pos{0};
+    alignas(64) std::size_t m_dequeue_pos = 0;
+    std::atomic<std::size_t> m_handled{0};
+    std::atomic<bool> m_consumer_waits{false};
+    std::atomic<bool> m_closed{false};
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+};
+
+} // end of detail
+
+namespace queueing {
+
+/**
+ * Unbounded queue guarded by a mutex: a producer never waits.
+ */
+struct Unbounded {
+    using PolicyTag = QueueingPolicyTag;
+
+    template<typename T>
+    using Queue = detail::RecordQueue<T, 0>;
+};
+
+/**
+ * Bounded queue guarded by a mutex: a producer waits while the queue contains Capacity records.
+ * @tparam Capacity - max count of the queued records
+ */
+template<std::size_t Capacity>
+struct Bounded {
+    static_assert(Capacity > 0, "capacity of the bounded queue must be greater than 0");
+
+    using PolicyTag = QueueingPolicyTag;
+
+    template<typename T>
+    using Queue = detail::RecordQueue<T, Capacity>;
+};
+
+/**
+ * Bounded lock-free queue: a producer reserves a slot by an atomic operation
+ * and waits (with a backoff) only while the queue contains Capacity records.
+ * @tparam Capacity - max count of the queued records, must be a power of 2
+ */
+template<std::size_t Capacity>
+struct LockFree {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "capacity of the lock-free queue must be a power of 2");
+
+    using PolicyTag = QueueingPolicyTag;
+
+    template<typename T>
+    using Queue = detail::LockFreeRecordQueue<T, Capacity>;
+};
+
+} // end of queueing
+
+namespace threading {
+
+/**
+ * Recorders are called on the logging thread without any synchronization.
+ * The policy should be used by single-threaded applications
+ * or if every recorder synchronizes itself.
+ */
+struct Sync {
+    using PolicyTag = ThreadingPolicyTag;
+
+    /**
+     * Delivery of the records to a sink.
+     * @tparam RecordT - type of record
+     * @tparam SinkT - type of the sink that provides the Dispatch(const RecordT &) method
+     */
+    template<typename RecordT, typename SinkT>
+    class Delivery {
+    public:
+        explicit Delivery(SinkT &sink)
+            : m_sink(sink) {
+        }
+
+        inline void Deliver(RecordT &&record) {
+            m_sink.Dispatch(record);
+        }
+
+        inline void Flush() {
+        }
+
+    private:
+        SinkT &m_sink;
+    };
+};
+
+/**
+ * Recorders are called on the logging thread under a lock,
+ * so a record is handled by all the recorders at once.
+ * @tparam SyncT - synchronization strategy (sync::Mutex, sync::SpinLock)
+ */
+template<typename SyncT = sync::Mutex>
+struct Locked {
+    using PolicyTag = ThreadingPolicyTag;
+
+    /**
+     * @copydoc Sync::Delivery
+     */
+    template<typename RecordT, typename SinkT>
+    class Delivery {
+    public:
+        explicit Delivery(SinkT &sink)
+            : m_sink(sink) {
+        }
+
+        inline void Deliver(RecordT &&record) {
+            std::lock_guard lock(m_sync);
+            m_sink.Dispatch(record);
+        }
+
+        inline void Flush() {
+        }
+
+    private:
+        SinkT &m_sink;
+        SyncT m_sync;
+    };
+};
+
+/**
+ * Records are moved to a queue and the recorders are called on a separate worker thread.
+ * The logging thread pays only for the record construction and queueing.
+ * @tparam QueueT - queueing policy (queueing::Unbounded, queueing::Bounded<N> or queueing::LockFree<N>)
+ */
+template<typename QueueT = queueing::Unbounded>
+struct Async {
+    static_assert(std::is_same_v<typename QueueT::PolicyTag, QueueingPolicyTag>,
+                  "QueueT must be a queueing policy");
+
+    using PolicyTag = ThreadingPolicyTag;
+
+    /**
+     * @copydoc Sync::Delivery
+     */
+    template<typename RecordT, typename SinkT>
+    class Delivery {
+    public:
+        explicit Delivery(SinkT &sink)
+            : m_sink(sink),
+              m_worker([this] { Run(); }) {
+        }
+
+        /**
+         * Handle the remaining records and stop the worker.
+         */
+        ~Delivery() {
+            m_queue.Close();
+            m_worker.join();
+        }
+
+        inline void Deliver(RecordT &&record) {
+            // the queued record must not refer to the data of the logging thread
+            detail::DetachRecord(record);
+            m_queue.Push(std::move(record));
+        }
+
+        /**
+         * Wait until all the queued records are handled by the recorders.
+         */
+        inline void Flush() {
+            m_queue.WaitDrained();
+        }
+
+    private:
+        using Queue = typename QueueT::template Queue<RecordT>;
+
+        void Run() {
+            typename Queue::Batch batch;
+            while (m_queue.PopAll(batch)) {
+                for (const auto &record : batch) {
+                    m_sink.Dispatch(record);
+                }
+
+                batch.clear();
+                m_queue.Done();
+            }
+        }
+
+        SinkT &m_sink;
+        Queue m_queue;
+        // the worker must be initialized last since it uses the queue
+        std::thread m_worker;
+    };
+};
+
+} // end of threading
+
+} // end of scl
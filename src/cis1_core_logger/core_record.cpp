@@ -1,15 +1,94 @@
-#include <sstream>
 #include <cis1_core_logger/core_record.h>
+#include <scl/detail/json_format.h>
+#include <scl/detail/msgpack_format.h>
 
 namespace cis1::core_logger {
 
 const std::size_t max_tokens_count = 7;
 
+// max length of the sequence number token: the mark and the digits
+const std::size_t sequence_token_length = scl::detail::NumberTrait<std::uint64_t>::max_digits_count + 1;
+
+// precomputed JSON keys with the separators
+namespace json_keys {
+constexpr std::string_view time_k = "{\"time\":";
+constexpr std::string_view sequence_k = ",\"seq\":";
+constexpr std::string_view level_k = ",\"level\":\"";
+constexpr std::string_view pid_k = "\",\"pid\":";
+constexpr std::string_view ppid_k = ",\"ppid\":";
+constexpr std::string_view session_id_k = ",\"session_id\":";
+constexpr std::string_view action_k = ",\"action\":";
+constexpr std::string_view message_k = ",\"message\":";
+} // end of json_keys
+
+CorePrefix::CorePrefix(scl::ProcessId parent_pid,
+                       scl::ProcessId pid,
+                       std::optional<std::string_view> session_id)
+    : m_parent_pid(parent_pid),
+      m_pid(pid) {
+    namespace Fmt = scl::detail::log_formatting;
+
+    char parent_pid_buffer[Fmt::pid_length_k + 1];
+    char pid_buffer[Fmt::pid_length_k + 1];
+    const auto parent_pid_str = scl::detail::IntegerToChars(parent_pid_buffer, parent_pid);
+    const auto pid_str = scl::detail::IntegerToChars(pid_buffer, pid);
+
+    char *plain = m_plain.data();
+    plain = scl::detail::WriteToken(plain, parent_pid_str);
+    plain = scl::detail::WriteToken(plain, pid_str);
+    m_plain_pids_size = static_cast<std::uint8_t>(plain - m_plain.data());
+
+    char *aligned = m_aligned.data();
+    aligned = scl::detail::WriteAlignedToken(aligned, parent_pid_str, Fmt::pid_length_k);
+    aligned = scl::detail::WriteAlignedToken(aligned, pid_str, Fmt::pid_length_k);
+    m_aligned_pids_size = static_cast<std::uint8_t>(aligned - m_aligned.data());
+
+    if (session_id && session_id->size() <= max_session_id_length) {
+        plain = scl::detail::WriteToken(plain, *session_id);
+        aligned = scl::detail::WriteAlignedToken(aligned, *session_id, session_id_length);
+    }
+
+    m_plain_size = static_cast<std::uint8_t>(plain - m_plain.data());
+    m_aligned_size = static_cast<std::uint8_t>(aligned - m_aligned.data());
+}
+
+std::optional<std::string_view> CorePrefix::SessionId() const {
+    if (!HasSessionId()) {
+        return std::nullopt;
+    }
+
+    const auto separator_size = scl::detail::log_formatting::separator_k.size();
+    return std::string_view(m_plain.data() + m_plain_pids_size,
+                            m_plain_size - m_plain_pids_size - separator_size);
+}
+
+CoreRecord::CoreRecord(scl::Level level_,
+                       std::string_view time_str_,
+                       std::optional<std::string_view> session_id_,
+                       std::optional<std::string_view> action_,
+                       std::string_view message_,
+                       scl::ProcessId parent_pid_,
+                       scl::ProcessId pid_)
+    : CoreRecord(scl::view_k, level_, time_str_, session_id_, action_, message_, parent_pid_, pid_) {
+    Detach();
+}
+
 CoreRecord::CoreRecord(scl::Level level_,
-                       const std::string &time_str_,
-                       const std::optional<std::string> &session_id_,
-                       const std::optional<std::string> &action_,
-                       const std::string &message_,
+                       std::string_view time_str_,
+                       std::optional<std::string_view> session_id_,
+                       std::optional<std::string_view> action_,
+                       std::string_view message_,
+                       const CorePrefix &prefix_)
+    : CoreRecord(scl::view_k, level_, time_str_, session_id_, action_, message_, prefix_) {
+    Detach();
+}
+
+CoreRecord::CoreRecord(scl::ViewTag,
+                       scl::Level level_,
+                       std::string_view time_str_,
+                       std::optional<std::string_view> session_id_,
+                       std::optional<std::string_view> action_,
+                       std::string_view message_,
                        scl::ProcessId parent_pid_,
                        scl::ProcessId pid_)
     : level(level_),
@@ -18,18 +97,213 @@ CoreRecord::CoreRecord(scl::Level level_,
       action(action_),
       message(message_),
       parent_pid(parent_pid_),
-      pid(pid_) {
+      pid(pid_),
+      prefix(parent_pid_, pid_, session_id_) {
+}
+
+CoreRecord::CoreRecord(scl::ViewTag,
+                       scl::Level level_,
+                       std::string_view time_str_,
+                       std::optional<std::string_view> session_id_,
+                       std::optional<std::string_view> action_,
+                       std::string_view message_,
+                       const CorePrefix &prefix_)
+    : level(level_),
+      time_str(time_str_),
+      session_id(session_id_),
+      action(action_),
+      message(message_),
+      parent_pid(prefix_.ParentPid()),
+      pid(prefix_.Pid()),
+      prefix(prefix_) {
+}
+
+CoreRecord::CoreRecord(const CoreRecord &other)
+    : scl::IRecord(other),
+      level(other.level),
+      time_str(other.time_str),
+      session_id(other.session_id),
+      action(other.action),
+      message(other.message),
+      parent_pid(other.parent_pid),
+      pid(other.pid),
+      prefix(other.prefix) {
+    Detach();
+}
+
+CoreRecord &CoreRecord::operator=(const CoreRecord &other) {
+    if (this != &other) {
+        *this = CoreRecord(other);
+    }
+
+    return *this;
+}
+
+void CoreRecord::Detach() {
+    if (!m_storage) {
+        m_storage = scl::detail::PackViews(m_memory_resource, time_str, session_id, action, message);
+    }
+}
+
+const CorePrefix &CoreRecord::ActualPrefix(std::optional<CorePrefix> &rendered) const {
+    // the public fields could be changed after the construction
+    const bool is_actual = prefix.ParentPid() == parent_pid
+                           && prefix.Pid() == pid
+                           && (!session_id || !prefix.HasSessionId() || *prefix.SessionId() == *session_id);
+    return is_actual ? prefix : rendered.emplace(parent_pid, pid, session_id);
+}
+
+void CoreRecord::WriteString(std::string &dst) const {
+    std::optional<CorePrefix> rendered;
+    const CorePrefix &actual_prefix = ActualPrefix(rendered);
+
+    // use the cached session id if possible
+    const bool cached_session_id = session_id && actual_prefix.HasSessionId();
+    const auto prefix_str = actual_prefix.Plain(cached_session_id);
+
+    dst.reserve(dst.size()
+                + scl::detail::PlainTokenSize(time_str.size())
+                + (m_sequence ? scl::detail::PlainTokenSize(sequence_token_length) : 0)
+                + prefix_str.size()
+                + (session_id && !cached_session_id ? scl::detail::PlainTokenSize(session_id->size()) : 0)
+                + (action ? scl::detail::PlainTokenSize(action->size()) : 0)
+                + message.size());
+
+    scl::detail::AppendToken(dst, time_str);
+    if (m_sequence) {
+        scl::detail::AppendSequenceToken(dst, *m_sequence);
+    }
+
+    dst += prefix_str;
+
+    if (session_id && !cached_session_id) {
+        scl::detail::AppendToken(dst, *session_id);
+    }
+
+    if (action) {
+        scl::detail::AppendToken(dst, *action);
+    }
+
+    dst += message;
+}
+
+void CoreRecord::WriteAlignedString(std::string &dst) const {
+    namespace Fmt = scl::detail::log_formatting;
+
+    std::optional<CorePrefix> rendered;
+    const CorePrefix &actual_prefix = ActualPrefix(rendered);
+
+    // use the cached session id if possible
+    const bool cached_session_id = session_id && actual_prefix.HasSessionId();
+    const auto prefix_str = actual_prefix.Aligned(cached_session_id);
+
+    dst.reserve(dst.size()
+                + scl::detail::AlignedTokenSize(Fmt::time_length_k)
+                + (m_sequence ? scl::detail::AlignedTokenSize(sequence_token_length) : 0)
+                + prefix_str.size()
+                + (session_id && !cached_session_id ? scl::detail::AlignedTokenSize(session_id_length) : 0)
+                + (action ? scl::detail::AlignedTokenSize(action_length) : 0)
+                + message.size());
+
+    scl::detail::AppendAlignedToken(dst, time_str, Fmt::time_length_k);
+    if (m_sequence) {
+        scl::detail::AppendAlignedSequenceToken(dst, *m_sequence);
+    }
+
+    dst += prefix_str;
+
+    if (session_id && !cached_session_id) {
+        scl::detail::AppendAlignedToken(dst, *session_id, session_id_length);
+    }
+
+    if (action) {
+        scl::detail::AppendAlignedToken(dst, *action, action_length);
+    }
+
+    dst += message;
+}
+
+void CoreRecord::WriteJsonString(std::string &dst) const {
+    namespace Keys = json_keys;
+
+    dst += Keys::time_k;
+    scl::detail::AppendJsonString(dst, time_str);
+
+    if (m_sequence) {
+        dst += Keys::sequence_k;
+        scl::detail::AppendJsonInteger(dst, *m_sequence);
+    }
+
+    // the level names don't need the escaping
+    dst += Keys::level_k;
+    dst += scl::LevelToStringView(level);
+    dst += Keys::pid_k;
+    scl::detail::AppendJsonInteger(dst, pid);
+    dst += Keys::ppid_k;
+    scl::detail::AppendJsonInteger(dst, parent_pid);
+
+    if (session_id) {
+        dst += Keys::session_id_k;
+        scl::detail::AppendJsonString(dst, *session_id);
+    }
+
+    if (action) {
+        dst += Keys::action_k;
+        scl::detail::AppendJsonString(dst, *action);
+    }
+
+    dst += Keys::message_k;
+    scl::detail::AppendJsonString(dst, message);
+    dst += '}';
+}
+
+void CoreRecord::WriteMsgPack(std::string &dst, scl::detail::MsgPackStrWriter &writer) const {
+    using Key = CoreRecordKey;
+
+    const std::size_t fields_count = 5 + (session_id ? 1 : 0) + (action ? 1 : 0) + (m_sequence ? 1 : 0);
+    scl::detail::AppendMsgPackMap(dst, fields_count);
+
+    scl::detail::AppendMsgPackKey(dst, Key::Time);
+    scl::detail::AppendMsgPackTime(dst, time_str);
+    scl::detail::AppendMsgPackKey(dst, Key::Level);
+    scl::detail::AppendMsgPackUint(dst, static_cast<std::uint64_t>(level));
+
+    if (m_sequence) {
+        scl::detail::AppendMsgPackKey(dst, Key::Sequence);
+        scl::detail::AppendMsgPackUint(dst, *m_sequence);
+    }
+
+    scl::detail::AppendMsgPackKey(dst, Key::ParentPid);
+    scl::detail::AppendMsgPackInt(dst, parent_pid);
+    scl::detail::AppendMsgPackKey(dst, Key::Pid);
+    scl::detail::AppendMsgPackInt(dst, pid);
+
+    if (session_id) {
+        scl::detail::AppendMsgPackKey(dst, Key::SessionId);
+        writer.AppendStr(dst, *session_id);
+    }
+
+    if (action) {
+        scl::detail::AppendMsgPackKey(dst, Key::Action);
+        writer.AppendStr(dst, *action);
+    }
+
+    scl::detail::AppendMsgPackKey(dst, Key::Message);
+    scl::detail::AppendMsgPackStr(dst, message);
 }
 
 CoreRecord::AlignedTokenCont CoreRecord::AsAlignedTokens() const {
     namespace Fmt = scl::detail::log_formatting;
 
-    AlignedTokenCont result;
+    AlignedTokenCont result(MemoryResource());
     result.reserve(max_tokens_count);
 
+    char parent_pid_buffer[Fmt::pid_length_k + 1];
+    char pid_buffer[Fmt::pid_length_k + 1];
+
     result.emplace_back(time_str, Fmt::time_length_k);
-    result.emplace_back(std::to_string(parent_pid), Fmt::pid_length_k);
-    result.emplace_back(std::to_string(pid), Fmt::pid_length_k);
+    result.emplace_back(scl::detail::IntegerToChars(parent_pid_buffer, parent_pid), Fmt::pid_length_k);
+    result.emplace_back(scl::detail::IntegerToChars(pid_buffer, pid), Fmt::pid_length_k);
 
     if (session_id) {
         result.emplace_back(*session_id, session_id_length);
@@ -43,12 +317,17 @@ CoreRecord::AlignedTokenCont CoreRecord::AsAlignedTokens() const {
 }
 
 CoreRecord::TokenCont CoreRecord::AsTokens() const {
-    TokenCont result;
+    namespace Fmt = scl::detail::log_formatting;
+
+    TokenCont result(MemoryResource());
     result.reserve(max_tokens_count);
 
-    result.push_back(time_str);
-    result.emplace_back(std::to_string(parent_pid));
-    result.emplace_back(std::to_string(pid));
+    char parent_pid_buffer[Fmt::pid_length_k + 1];
+    char pid_buffer[Fmt::pid_length_k + 1];
+
+    result.emplace_back(time_str);
+    result.emplace_back(scl::detail::IntegerToChars(parent_pid_buffer, parent_pid));
+    result.emplace_back(scl::detail::IntegerToChars(pid_buffer, pid));
 
     if (session_id) {
         result.emplace_back(*session_id);
@@ -62,7 +341,7 @@ CoreRecord::TokenCont CoreRecord::AsTokens() const {
 }
 
 std::string CoreRecord::Message() const {
-    return message;
+    return std::string(message);
 }
 
 }
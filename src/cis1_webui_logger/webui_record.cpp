@@ -1,17 +1,42 @@
-#include <sstream>
 #include <cis1_webui_logger/webui_record.h>
+#include <scl/detail/json_format.h>
+#include <scl/detail/msgpack_format.h>
 
 namespace cis1::webui_logger {
 
 const std::size_t max_tokens_count = 6;
 
+// precomputed JSON keys with the separators
+namespace json_keys {
+constexpr std::string_view time_k = "{\"time\":";
+constexpr std::string_view sequence_k = ",\"seq\":";
+constexpr std::string_view level_k = ",\"level\":\"";
+constexpr std::string_view protocol_k = "\",\"protocol\":\"";
+constexpr std::string_view handler_k = ",\"handler\":";
+constexpr std::string_view remote_addr_k = ",\"remote_addr\":";
+constexpr std::string_view email_k = ",\"email\":";
+constexpr std::string_view message_k = ",\"message\":";
+} // end of json_keys
+
 WebuiRecord::WebuiRecord(scl::Level level_,
-                         const std::string &time_str_,
-                         const std::string &message_,
+                         std::string_view time_str_,
+                         std::string_view message_,
+                         const std::optional<Protocol> &protocol_,
+                         std::optional<std::string_view> handler_,
+                         std::optional<std::string_view> remote_addr_,
+                         std::optional<std::string_view> email_)
+    : WebuiRecord(scl::view_k, level_, time_str_, message_, protocol_, handler_, remote_addr_, email_) {
+    Detach();
+}
+
+WebuiRecord::WebuiRecord(scl::ViewTag,
+                         scl::Level level_,
+                         std::string_view time_str_,
+                         std::string_view message_,
                          const std::optional<Protocol> &protocol_,
-                         const std::optional<std::string> &handler_,
-                         const std::optional<std::string> &remote_addr_,
-                         const std::optional<std::string> &email_)
+                         std::optional<std::string_view> handler_,
+                         std::optional<std::string_view> remote_addr_,
+                         std::optional<std::string_view> email_)
     : level(level_),
       time_str(time_str_),
       message(message_),
@@ -21,17 +46,183 @@ WebuiRecord::WebuiRecord(scl::Level level_,
       email(email_) {
 }
 
+WebuiRecord::WebuiRecord(const WebuiRecord &other)
+    : scl::IRecord(other),
+      level(other.level),
+      time_str(other.time_str),
+      message(other.message),
+      protocol(other.protocol),
+      handler(other.handler),
+      remote_addr(other.remote_addr),
+      email(other.email) {
+    Detach();
+}
+
+WebuiRecord &WebuiRecord::operator=(const WebuiRecord &other) {
+    if (this != &other) {
+        *this = WebuiRecord(other);
+    }
+
+    return *this;
+}
+
+void WebuiRecord::Detach() {
+    if (!m_storage) {
+        m_storage = scl::detail::PackViews(m_memory_resource, time_str, message, handler, remote_addr, email);
+    }
+}
+
+void WebuiRecord::WriteString(std::string &dst) const {
+    scl::detail::AppendToken(dst, time_str);
+    if (m_sequence) {
+        scl::detail::AppendSequenceToken(dst, *m_sequence);
+    }
+
+    scl::detail::AppendToken(dst, scl::LevelToStringView(level));
+
+    if (protocol) {
+        scl::detail::AppendToken(dst, ProtocolToStringView(protocol.value()));
+    }
+
+    if (handler) {
+        scl::detail::AppendToken(dst, handler.value());
+    }
+
+    if (remote_addr) {
+        scl::detail::AppendToken(dst, remote_addr.value());
+    }
+
+    if (email) {
+        scl::detail::AppendToken(dst, email.value());
+    }
+
+    dst += message;
+}
+
+void WebuiRecord::WriteAlignedString(std::string &dst) const {
+    namespace Fmt = scl::detail::log_formatting;
+
+    scl::detail::AppendAlignedToken(dst, time_str, Fmt::time_length_k);
+    if (m_sequence) {
+        scl::detail::AppendAlignedSequenceToken(dst, *m_sequence);
+    }
+
+    scl::detail::AppendAlignedToken(dst, scl::LevelToStringView(level), Fmt::level_length_k);
+
+    if (protocol) {
+        scl::detail::AppendAlignedToken(dst, ProtocolToStringView(protocol.value()), protocol_length);
+    }
+
+    if (handler) {
+        scl::detail::AppendAlignedToken(dst, handler.value(), handler_length);
+    }
+
+    if (remote_addr) {
+        scl::detail::AppendAlignedToken(dst, remote_addr.value(), remote_addr_v4_length);
+    }
+
+    if (email) {
+        // do not align the email
+        scl::detail::AppendToken(dst, email.value());
+    }
+
+    dst += message;
+}
+
+void WebuiRecord::WriteJsonString(std::string &dst) const {
+    namespace Keys = json_keys;
+
+    dst += Keys::time_k;
+    scl::detail::AppendJsonString(dst, time_str);
+
+    if (m_sequence) {
+        dst += Keys::sequence_k;
+        scl::detail::AppendJsonInteger(dst, *m_sequence);
+    }
+
+    // the level and protocol names don't need the escaping
+    dst += Keys::level_k;
+    dst += scl::LevelToStringView(level);
+
+    if (protocol) {
+        dst += Keys::protocol_k;
+        dst += ProtocolToStringView(protocol.value());
+    }
+
+    dst += '"';
+
+    if (handler) {
+        dst += Keys::handler_k;
+        scl::detail::AppendJsonString(dst, handler.value());
+    }
+
+    if (remote_addr) {
+        dst += Keys::remote_addr_k;
+        scl::detail::AppendJsonString(dst, remote_addr.value());
+    }
+
+    if (email) {
+        dst += Keys::email_k;
+        scl::detail::AppendJsonString(dst, email.value());
+    }
+
+    dst += Keys::message_k;
+    scl::detail::AppendJsonString(dst, message);
+    dst += '}';
+}
+
+void WebuiRecord::WriteMsgPack(std::string &dst, scl::detail::MsgPackStrWriter &writer) const {
+    using Key = WebuiRecordKey;
+
+    const std::size_t fields_count = 3 + (protocol ? 1 : 0) + (handler ? 1 : 0) + (remote_addr ? 1 : 0)
+                                     + (email ? 1 : 0) + (m_sequence ? 1 : 0);
+    scl::detail::AppendMsgPackMap(dst, fields_count);
+
+    scl::detail::AppendMsgPackKey(dst, Key::Time);
+    scl::detail::AppendMsgPackTime(dst, time_str);
+    scl::detail::AppendMsgPackKey(dst, Key::Level);
+    scl::detail::AppendMsgPackUint(dst, static_cast<std::uint64_t>(level));
+
+    if (m_sequence) {
+        scl::detail::AppendMsgPackKey(dst, Key::Sequence);
+        scl::detail::AppendMsgPackUint(dst, *m_sequence);
+    }
+
+    if (protocol) {
+        scl::detail::AppendMsgPackKey(dst, Key::Protocol);
+        scl::detail::AppendMsgPackUint(dst, static_cast<std::uint64_t>(protocol.value()));
+    }
+
+    if (handler) {
+        scl::detail::AppendMsgPackKey(dst, Key::Handler);
+        writer.AppendStr(dst, handler.value());
+    }
+
+    if (remote_addr) {
+        scl::detail::AppendMsgPackKey(dst, Key::RemoteAddr);
+        writer.AppendStr(dst, remote_addr.value());
+    }
+
+    if (email) {
+        scl::detail::AppendMsgPackKey(dst, Key::Email);
+        writer.AppendStr(dst, email.value());
+    }
+
+    scl::detail::AppendMsgPackKey(dst, Key::Message);
+    scl::detail::AppendMsgPackStr(dst, message);
+}
+
 WebuiRecord::AlignedTokenCont WebuiRecord::AsAlignedTokens() const {
     namespace Fmt = scl::detail::log_formatting;
 
-    AlignedTokenCont result;
+    AlignedTokenCont result(MemoryResource());
     result.reserve(max_tokens_count);
 
     result.emplace_back(time_str, Fmt::time_length_k);
-    result.emplace_back(scl::LevelToString(level), Fmt::level_length_k);
+    result.emplace_back(scl::LevelToStringView(level), Fmt::level_length_k);
 
     if (protocol) {
-        result.emplace_back(ProtocolToString(protocol.value()), protocol_length);
+        result.emplace_back(ProtocolToStringView(protocol.value()), protocol_length);
     }
 
     if (handler) {
@@ -52,14 +243,14 @@ WebuiRecord::AlignedTokenCont WebuiRecord::AsAlignedTokens() const {
 }
 
 WebuiRecord::TokenCont WebuiRecord::AsTokens() const {
-    TokenCont result;
+    TokenCont result(MemoryResource());
     result.reserve(max_tokens_count);
 
     result.emplace_back(time_str);
-    result.emplace_back(scl::LevelToString(level));
+    result.emplace_back(scl::LevelToStringView(level));
 
     if (protocol) {
-        result.emplace_back(ProtocolToString(protocol.value()));
+        result.emplace_back(ProtocolToStringView(protocol.value()));
     }
 
     if (handler) {
@@ -80,7 +271,7 @@ WebuiRecord::TokenCont WebuiRecord::AsTokens() const {
 }
 
 std::string WebuiRecord::Message() const {
-    return message;
+    return std::string(message);
 }
 
 } // end of cis1::webui_logger
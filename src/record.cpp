@@ -1,44 +1,92 @@
-#include <sstream>
 #include <scl/record.h>
+#include <scl/detail/json_format.h>
+#include <scl/detail/msgpack_format.h>
+#include <scl/detail/record_format.h>
 
 namespace scl {
 
 std::string IRecord::ToString() const {
-    std::stringstream ss;
-    ss << CompileRecord(AsTokens()) << Message();
-    return ss.str();
+    std::string result;
+    WriteString(result);
+    return result;
 }
 
 std::string IRecord::ToAlignedString() const {
-    std::stringstream ss;
-    ss << CompileRecord(AsAlignedTokens()) << Message();
-    return ss.str();
+    std::string result;
+    WriteAlignedString(result);
+    return result;
 }
 
-std::string IRecord::CompileRecord(const AlignedTokenCont &aligned_tokens) {
-    std::stringstream ss;
-    for (const auto &[token, align_length] : aligned_tokens) {
-        const auto token_length
-            = align_length < token.size()
-              ? align_length
-              : token.size();
+void IRecord::WriteString(std::string &dst) const {
+    const auto tokens = AsTokens();
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        detail::AppendToken(dst, tokens[i]);
+        if (i == 0 && m_sequence) {
+            detail::AppendSequenceToken(dst, *m_sequence);
+        }
+    }
+
+    dst += Message();
+}
+
+void IRecord::WriteAlignedString(std::string &dst) const {
+    const auto tokens = AsAlignedTokens();
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        detail::AppendAlignedToken(dst, tokens[i].token, tokens[i].align);
+        if (i == 0 && m_sequence) {
+            detail::AppendAlignedSequenceToken(dst, *m_sequence);
+        }
+    }
+
+    dst += Message();
+}
+
+void IRecord::WriteJsonString(std::string &dst) const {
+    std::string record;
+    WriteString(record);
 
-        const auto difference = align_length - token_length;
-        const std::string left_indent(difference, ' ');
+    dst += '{';
+    if (m_sequence) {
+        dst += "\"seq\":";
+        detail::AppendJsonInteger(dst, *m_sequence);
+        dst += ',';
+    }
+
+    dst += "\"message\":";
+    detail::AppendJsonString(dst, record);
+    dst += '}';
+}
+
+void IRecord::WriteMsgPack(std::string &dst, detail::MsgPackStrWriter &) const {
+    std::string record;
+    WriteString(record);
+
+    detail::AppendMsgPackMap(dst, m_sequence ? 2 : 1);
+    if (m_sequence) {
+        detail::AppendMsgPackKey(dst, RecordKey::Sequence);
+        detail::AppendMsgPackUint(dst, *m_sequence);
+    }
+
+    detail::AppendMsgPackKey(dst, RecordKey::Message);
+    detail::AppendMsgPackStr(dst, record);
+}
 
-        ss << left_indent << token.substr(0, token_length) << " | ";
+std::string IRecord::CompileRecord(const AlignedTokenCont &aligned_tokens) {
+    std::string result;
+    for (const auto &[token, align_length] : aligned_tokens) {
+        detail::AppendAlignedToken(result, token, align_length);
     }
 
-    return ss.str();
+    return result;
 }
 
 std::string IRecord::CompileRecord(const TokenCont &tokens) {
-    std::stringstream ss;
+    std::string result;
     for (const auto &token : tokens) {
-        ss << token << " | ";
+        detail::AppendToken(result, token);
     }
 
-    return ss.str();
+    return result;
 }
 
 }
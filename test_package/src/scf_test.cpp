@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <scf/scf.h>
+#include <memory_resource>
 #include <vector>
 
 // User types for the UserTypeTest test
@@ -41,6 +42,27 @@ std::string ToString(const UserType3 &arg) {
     return ss.str();
 }
 
+// Memory resource for the PmrTest test
+
+class FormatCountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) final {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) final {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept final {
+        return this == &other;
+    }
+};
+
 // Tests
 
 TEST(ScfTest, CommonTest) {
@@ -181,3 +203,35 @@ TEST(ScfTest, UserTypeTest) {
     const auto origin = "{ sample, 123 }, { 10 }, { { 0 } { 1 } { 2 } { 3 } { 4 } } - user types";
     ASSERT_TRUE(result == origin);
 }
+
+TEST(ScfTest, InlineStringTest) {
+    const auto short_result = SCFormatN(32, "%s - string, %d - int", "str", 1);
+    ASSERT_TRUE(short_result == "str - string, 1 - int");
+    ASSERT_TRUE(short_result.is_inline());
+
+    const auto long_result = SCFormatN(8, "%s - string, %d - int", "str", 1);
+    ASSERT_TRUE(long_result == "str - string, 1 - int");
+    ASSERT_FALSE(long_result.is_inline());
+
+    scf::InlineString<8> str("abcd");
+    str.insert(1, str.view().substr(2));
+    ASSERT_TRUE(str == "acdbcd");
+    str.erase(1, 2);
+    ASSERT_TRUE(str == "abcd");
+
+    const auto moved = std::move(str);
+    ASSERT_TRUE(moved == "abcd");
+    ASSERT_TRUE(str.empty());
+}
+
+TEST(ScfTest, PmrTest) {
+    FormatCountingResource resource;
+    const std::string arg1 = "a string that doesn't fit in the small buffer";
+    const int arg2 = 17;
+
+    const std::pmr::string result = SCFormatPmr(&resource, "%s - string, %d - int", arg1, arg2);
+    const auto origin = "a string that doesn't fit in the small buffer - string, 17 - int";
+    ASSERT_TRUE(result == origin);
+    ASSERT_TRUE(result.get_allocator().resource() == &resource);
+    ASSERT_TRUE(resource.allocations > 0);
+}
@@ -1,8 +1,37 @@
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
 #include <gtest/gtest.h>
 #include <cis1_core_logger/core_logger.h>
 #include <cis1_core_logger/core_record.h>
+#include <cis1_webui_logger/webui_record.h>
+#include <scl/logger.h>
+#include <scl/broadcast_recorder.h>
+#include <scl/columnar_reader.h>
+#include <scl/columnar_recorder.h>
 #include <scl/console_recorder.h>
+#include <scl/detail/bloom_filter.h>
+#include <scl/detail/intern_table.h>
+#include <scl/detail/json_format.h>
+#include <scl/detail/sanitize.h>
+#include <scl/detail/socket_frame.h>
 #include <scl/file_recorder.h>
+#include <scl/flight_recorder.h>
+#include <scl/log_index_reader.h>
+#include <scl/msgpack_reader.h>
+#include <scl/segment_merger.h>
+#include <scl/shm_recorder.h>
+#include <scl/socket_recorder.h>
+#include <scl/syslog_recorder.h>
+#include <scl/text_log_reader.h>
+#include <scf/inline_string.h>
+
+#if defined(SCL_HAS_SHARED_FILE) || defined(SCL_HAS_SHM_RING)
+#include <sys/wait.h>
+#endif
 
 #define EXPECT_ERROR(result, error) \
 { const auto stor_err = std::get_if<decltype(error)>(&result); ASSERT_TRUE(stor_err && *stor_err == error); }
@@ -18,6 +47,36 @@ void Unwrap(Value &dst, std::variant<Value, Error> &&src) {
 using namespace scl;
 using namespace cis1::core_logger;
 
+/**
+ * Temporary directory of a test that is removed on the destruction.
+ * The name is suffixed by a random number, so the parallel runs of the tests don't share the directories.
+ */
+class TempDir {
+public:
+    explicit TempDir(const std::string &name)
+        : m_path(fs::temp_directory_path() / (name + "_" + std::to_string(std::random_device{}()))) {
+        fs::remove_all(m_path);
+        fs::create_directories(m_path);
+    }
+
+    TempDir(const TempDir &) = delete;
+
+    TempDir &operator=(const TempDir &) = delete;
+
+    ~TempDir() {
+        std::error_code ec{};
+        fs::remove_all(m_path, ec);
+    }
+
+    [[nodiscard]]
+    inline const fs::path &Path() const {
+        return m_path;
+    }
+
+private:
+    fs::path m_path;
+};
+
 TEST(SclTest, LoggerIncorrectLogLevelError) {
     using Error = CoreLogger::InitError;
 
@@ -112,3 +171,1793 @@ TEST(SclTest, FileRecorderDuplicateSpecifiersError) {
     const auto result = FileRecorder<CoreRecord>::Init(options);
     EXPECT_ERROR(result, Error::IncorrectFileNameTemplate);
 }
+
+/**
+ * Recorder that stores the messages of the handled records.
+ */
+template<typename RecordT>
+class MemoryRecorder : public IRecorder<RecordT> {
+public:
+    explicit MemoryRecorder(std::vector<std::string> &messages) : m_messages(messages) {}
+
+    void OnRecord(const RecordT &record) final {
+        m_messages.emplace_back(record.message);
+    }
+
+private:
+    std::vector<std::string> &m_messages;
+};
+
+template<typename ...Policies>
+void CheckPipelineDelivery() {
+    using Pipeline = Logger<CoreRecord, Policies...>;
+
+    std::vector<std::string> messages;
+    RecordersCont<CoreRecord> cont;
+    cont.push_back(std::make_unique<MemoryRecorder<CoreRecord>>(messages));
+
+    typename Pipeline::Ptr logger;
+    Unwrap(logger, Pipeline::Init(LoggerOptions{Level::Info}, std::move(cont)));
+    ASSERT_TRUE(logger);
+
+    const std::optional<std::string> no_value;
+    for (int i = 0; i < 100; ++i) {
+        logger->Record(Level::Info, no_value, no_value, std::to_string(i), 1, 2);
+        // the record must be skipped
+        logger->Record(Level::Debug, no_value, no_value, "debug", 1, 2);
+    }
+
+    logger->Flush();
+    ASSERT_EQ(messages.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(messages[i], std::to_string(i));
+    }
+}
+
+TEST(SclTest, LoggerSyncDelivery) {
+    CheckPipelineDelivery<>();
+}
+
+TEST(SclTest, LoggerLockedDelivery) {
+    CheckPipelineDelivery<threading::Locked<>>();
+    CheckPipelineDelivery<threading::Locked<sync::SpinLock>>();
+}
+
+TEST(SclTest, LoggerAsyncDelivery) {
+    CheckPipelineDelivery<threading::Async<>>();
+    CheckPipelineDelivery<threading::Async<queueing::Bounded<4>>>();
+    CheckPipelineDelivery<threading::Async<queueing::LockFree<4>>>();
+}
+
+TEST(SclTest, LockFreeQueueMultipleProducers) {
+    using Pipeline = Logger<CoreRecord, threading::Async<queueing::LockFree<16>>>;
+
+    std::vector<std::string> messages;
+    RecordersCont<CoreRecord> cont;
+    cont.push_back(std::make_unique<MemoryRecorder<CoreRecord>>(messages));
+
+    Pipeline::Ptr logger;
+    Unwrap(logger, Pipeline::Init(LoggerOptions{Level::Debug}, std::move(cont)));
+
+    const int threads_count = 4;
+    const int records_count = 1000;
+    const std::optional<std::string> no_value;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; ++t) {
+        threads.emplace_back([&logger, &no_value, t] {
+            for (int i = 0; i < records_count; ++i) {
+                logger->Record(Level::Info, no_value, no_value, std::to_string(t), 1, 2);
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    logger->Flush();
+    ASSERT_EQ(messages.size(), static_cast<std::size_t>(threads_count * records_count));
+    for (int t = 0; t < threads_count; ++t) {
+        EXPECT_EQ(std::count(messages.begin(), messages.end(), std::to_string(t)), records_count);
+    }
+}
+
+TEST(SclTest, AsyncCoreLoggerHandlesRecordsOnDestruction) {
+    std::vector<std::string> messages;
+    RecordersCont<CoreRecord> cont;
+    cont.push_back(std::make_unique<MemoryRecorder<CoreRecord>>(messages));
+
+    {
+        BasicLoggerPtr<threading::Async<>> logger;
+        Unwrap(logger, BasicCoreLogger<threading::Async<>>::Init(CoreLogger::Options{Level::Debug},
+                                                                    std::move(cont)));
+        logger->Record(Level::Info, "first");
+        logger->SesRecord(Level::Debug, "second");
+    }
+
+    ASSERT_EQ(messages, (std::vector<std::string>{"first", "second"}));
+}
+
+TEST(SclTest, CoreLoggerAcceptsInlineString) {
+    std::vector<std::string> messages;
+    RecordersCont<CoreRecord> cont;
+    cont.push_back(std::make_unique<MemoryRecorder<CoreRecord>>(messages));
+
+    LoggerPtr logger;
+    Unwrap(logger, CoreLogger::Init(CoreLogger::Options{Level::Debug}, std::move(cont)));
+
+    const scf::InlineString<16> message("inline message");
+    logger->Record(Level::Info, message);
+    logger->SesRecord(Level::Info, scf::InlineString<4>("heap message"));
+
+    ASSERT_EQ(messages, (std::vector<std::string>{"inline message", "heap message"}));
+}
+
+/**
+ * Thread-safe memory resource that counts the outstanding allocations.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> outstanding{0};
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) final {
+        ++allocations;
+        ++outstanding;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) final {
+        --outstanding;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept final {
+        return this == &other;
+    }
+};
+
+TEST(SclTest, AsyncCoreLoggerAllocatesFromMemoryResource) {
+    std::vector<std::string> messages;
+    RecordersCont<CoreRecord> cont;
+    cont.push_back(std::make_unique<MemoryRecorder<CoreRecord>>(messages));
+
+    CountingResource resource;
+    {
+        CoreLogger::Options options{Level::Debug};
+        options.memory_resource = &resource;
+
+        BasicLoggerPtr<threading::Async<>> logger;
+        Unwrap(logger, BasicCoreLogger<threading::Async<>>::Init(options, std::move(cont)));
+        logger->Record(Level::Info, "first");
+        logger->SesRecord(Level::Debug, "second");
+        logger->Flush();
+    }
+
+    ASSERT_EQ(messages, (std::vector<std::string>{"first", "second"}));
+    EXPECT_EQ(resource.allocations, 2u);
+    EXPECT_EQ(resource.outstanding, 0u);
+}
+
+/**
+ * Recorder that counts the handled records and does not implement the IRecorder interface.
+ */
+struct CountingRecorder {
+    void OnRecord(const CoreRecord &) {
+        ++count;
+    }
+
+    std::size_t count = 0;
+};
+
+TEST(SclTest, StaticRecordersUnallocatedRecorderError) {
+    using Recorders = StaticRecorders<MemoryRecorder<CoreRecord>, CountingRecorder>;
+    using Pipeline = Logger<CoreRecord, Recorders>;
+    using Error = Pipeline::InitError;
+
+    std::vector<std::string> messages;
+    auto result = Pipeline::Init(LoggerOptions{Level::Debug},
+                                 Recorders(std::make_unique<MemoryRecorder<CoreRecord>>(messages), nullptr));
+    EXPECT_ERROR(result, Error::UnallocatedRecorder);
+}
+
+TEST(SclTest, StaticRecordersDispatch) {
+    using Recorders = StaticRecorders<MemoryRecorder<CoreRecord>, CountingRecorder>;
+    using StaticLogger = BasicCoreLogger<Recorders, threading::Locked<>>;
+
+    std::vector<std::string> messages;
+    BasicLoggerPtr<Recorders, threading::Locked<>> logger;
+    Unwrap(logger, StaticLogger::Init(CoreLogger::Options{Level::Info},
+                                      Recorders(std::make_unique<MemoryRecorder<CoreRecord>>(messages),
+                                                std::make_unique<CountingRecorder>())));
+
+    logger->Record(Level::Info, "first");
+    logger->Record(Level::Debug, "skipped");
+    logger->SesRecord(Level::Error, "second");
+
+    ASSERT_EQ(messages, (std::vector<std::string>{"first", "second"}));
+}
+
+template<typename SyncT>
+void CheckFileRecorderWriting(int threads_count) {
+    const TempDir temp_dir("scl_test_file_recorder");
+    const auto &dir = temp_dir.Path();
+
+    typename FileRecorder<CoreRecord, SyncT>::Options options{};
+    options.log_directory = dir;
+    options.file_name_template = "file.txt";
+
+    FileRecorderPtr<CoreRecord, SyncT> recorder;
+    Unwrap(recorder, FileRecorder<CoreRecord, SyncT>::Init(options));
+
+    const int records_count = 100;
+    const CoreRecord record(Level::Info, "time", std::nullopt, std::nullopt, "message", 1, 2);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; ++t) {
+        threads.emplace_back([&recorder, &record] {
+            for (int i = 0; i < records_count; ++i) {
+                recorder->OnRecord(record);
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    recorder.reset();
+
+    std::ifstream file(dir / "file.txt");
+    std::string line;
+    int lines_count = 0;
+    while (std::getline(file, line)) {
+        EXPECT_EQ(line, record.ToString());
+        ++lines_count;
+    }
+
+    EXPECT_EQ(lines_count, threads_count * records_count);
+}
+
+TEST(SclTest, FileRecorderSyncStrategies) {
+    CheckFileRecorderWriting<sync::None>(1);
+    CheckFileRecorderWriting<sync::Mutex>(4);
+    CheckFileRecorderWriting<sync::SpinLock>(4);
+}
+
+#ifdef SCL_HAS_SHARED_FILE
+TEST(SclTest, FileRecorderMultiProcess) {
+    const TempDir temp_dir("scl_test_multi_process");
+    const auto &dir = temp_dir.Path();
+
+    FileRecorder<CoreRecord>::Options options{};
+    options.log_directory = dir;
+    options.file_name_template = "file.%n.txt";
+    options.size_limit = 4096;
+    options.multi_process = true;
+
+    const int processes_count = 4;
+    const int records_count = 200;
+
+    std::vector<pid_t> children;
+    for (int p = 0; p < processes_count; ++p) {
+        const pid_t child = fork();
+        ASSERT_GE(child, 0);
+        if (child == 0) {
+            auto result = FileRecorder<CoreRecord>::Init(options);
+            auto *recorder = std::get_if<FileRecorderPtr<CoreRecord>>(&result);
+            if (recorder == nullptr) {
+                _exit(1);
+            }
+
+            for (int i = 0; i < records_count; ++i) {
+                const CoreRecord record(Level::Info, "time", std::nullopt, std::nullopt,
+                                        "message " + std::to_string(i), 1, getpid());
+                (*recorder)->OnRecord(record);
+            }
+
+            _exit(0);
+        }
+
+        children.push_back(child);
+    }
+
+    for (const auto child : children) {
+        int status = 0;
+        ASSERT_EQ(waitpid(child, &status, 0), child);
+        ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    int lines_count = 0;
+    int files_count = 0;
+    for (const auto &entry : fs::directory_iterator(dir)) {
+        if (entry.path().extension() != ".txt") {
+            continue;
+        }
+
+        ++files_count;
+        EXPECT_LE(fs::file_size(entry.path()), *options.size_limit);
+
+        std::ifstream file(entry.path());
+        std::string line;
+        while (std::getline(file, line)) {
+            // every line is a whole record
+            EXPECT_EQ(line.rfind("time | 1 | ", 0), 0u) << line;
+            EXPECT_NE(line.find(" | message "), std::string::npos) << line;
+            ++lines_count;
+        }
+    }
+
+    EXPECT_GT(files_count, 1);
+    EXPECT_EQ(lines_count, processes_count * records_count);
+}
+#endif
+
+#ifdef SCL_HAS_SHM_RING
+TEST(SclTest, ShmRecorderRecoversCrashedProducer) {
+    using detail::ShmRing;
+
+    const std::string name = "/scl_test_ring_" + std::to_string(getpid());
+    auto ring = ShmRing::Create(name, 1024, 256);
+    ASSERT_TRUE(ring);
+
+    const int processes_count = 4;
+    const int records_count = 100;
+
+    std::vector<pid_t> children;
+    for (int p = 0; p < processes_count; ++p) {
+        const pid_t child = fork();
+        ASSERT_GE(child, 0);
+        if (child == 0) {
+            auto result = ShmRecorder<CoreRecord>::Init({name});
+            auto *recorder = std::get_if<ShmRecorderPtr<CoreRecord>>(&result);
+            if (recorder == nullptr) {
+                _exit(1);
+            }
+
+            for (int i = 0; i < records_count; ++i) {
+                const CoreRecord record(Level::Info, "time", std::nullopt, std::nullopt,
+                                        "message " + std::to_string(i), 1, getpid());
+                (*recorder)->OnRecord(record);
+            }
+
+            // the last producer crashes between the reservation and the publishing of a slot
+            if (p == processes_count - 1) {
+                auto crashed_ring = ShmRing::Open(name);
+                if (!crashed_ring || !crashed_ring->Reserve()) {
+                    _exit(1);
+                }
+            }
+
+            _exit(0);
+        }
+
+        children.push_back(child);
+    }
+
+    for (const auto child : children) {
+        int status = 0;
+        ASSERT_EQ(waitpid(child, &status, 0), child);
+        ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    // a record published after the crashed slot
+    ASSERT_TRUE(ring->Push(static_cast<int>(Level::Error), "last"));
+
+    std::vector<std::string> records;
+    ring->Drain([&records](int, std::string_view text) { records.emplace_back(text); });
+
+    ASSERT_EQ(records.size(), static_cast<std::size_t>(processes_count * records_count + 1));
+    for (std::size_t i = 0; i + 1 < records.size(); ++i) {
+        EXPECT_EQ(records[i].rfind("time | 1 | ", 0), 0u) << records[i];
+        EXPECT_NE(records[i].find(" | message "), std::string::npos) << records[i];
+    }
+
+    EXPECT_EQ(records.back(), "last");
+    EXPECT_EQ(ring->GetStats().recovered, 1u);
+    EXPECT_EQ(ring->GetStats().dropped, 0u);
+
+    ShmRing::Unlink(name);
+}
+
+TEST(SclTest, ShmRingWaitsForLiveProducer) {
+    using detail::ShmRing;
+
+    const std::string name = "/scl_test_late_ring_" + std::to_string(getpid());
+    auto ring = ShmRing::Create(name, 4, 8);
+    ASSERT_TRUE(ring);
+
+    std::vector<std::string> records;
+    const auto on_record = [&records](int, std::string_view text) { records.emplace_back(text); };
+
+    // the producer stalls after the claim, the consumer doesn't recover the slot of the live producer
+    const auto stalled = ring->Reserve();
+    ASSERT_TRUE(stalled);
+    ASSERT_TRUE(ring->Push(static_cast<int>(Level::Info), "first"));
+    EXPECT_EQ(ring->Drain(on_record, std::chrono::milliseconds(0)), 0u);
+    EXPECT_EQ(ring->Drain(on_record, std::chrono::milliseconds(0)), 0u);
+    EXPECT_EQ(ring->GetStats().recovered, 0u);
+
+    std::memcpy(stalled->data, "stalled", 7);
+    EXPECT_TRUE(ring->Commit(*stalled, static_cast<int>(Level::Error), 7));
+    EXPECT_EQ(ring->Drain(on_record, std::chrono::milliseconds(0)), 2u);
+    EXPECT_EQ(ring->GetStats().dropped, 0u);
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring->Push(static_cast<int>(Level::Info), "lap " + std::to_string(i)));
+    }
+
+    // the ring keeps working on the following laps, a long record is truncated and counted
+    for (int lap = 0; lap < 3; ++lap) {
+        ring->Drain(on_record);
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(ring->Push(static_cast<int>(Level::Info), "long record " + std::to_string(i)));
+        }
+    }
+
+    ring->Drain(on_record);
+    ASSERT_EQ(records.size(), 18u);
+    EXPECT_EQ(records[0], "stalled");
+    EXPECT_EQ(records[1], "first");
+    EXPECT_EQ(records[2].substr(0, 3), "lap");
+    EXPECT_EQ(records.back(), "long rec");
+    EXPECT_EQ(ring->GetStats().truncated, 12u);
+
+    ShmRing::Unlink(name);
+}
+#endif
+
+#ifdef SCL_HAS_UNIX_SOCKET
+TEST(SclTest, SocketRecorderSpillsUntilConnected) {
+    const TempDir temp_dir("scl_test_socket");
+    const auto path = (temp_dir.Path() / "collector.sock").string();
+
+    SocketRecorder<CoreRecord>::Options options{};
+    options.path = path;
+    options.batch_size = 16;
+    options.reconnect_min = std::chrono::milliseconds(1);
+    options.reconnect_max = std::chrono::milliseconds(1);
+    // the spill buffer takes the first records only
+    options.spill_limit = 1024;
+
+    auto result = SocketRecorder<CoreRecord>::Init(options);
+    auto recorder = std::get<SocketRecorderPtr<CoreRecord>>(std::move(result));
+
+    const int records_count = 100;
+    const auto record_fn = [&recorder](int i) {
+        recorder->OnRecord(CoreRecord(Level::Info, "time", std::nullopt, std::nullopt,
+                                      "message " + std::to_string(i), 1, 2));
+    };
+
+    // the collector is unavailable
+    for (int i = 0; i < records_count; ++i) {
+        record_fn(i);
+    }
+
+    recorder->Flush();
+    EXPECT_FALSE(recorder->IsConnected());
+    const auto dropped = recorder->Dropped();
+    EXPECT_GT(dropped, 0u);
+    EXPECT_LT(dropped, static_cast<std::uint64_t>(records_count));
+
+    const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    const auto address = detail::MakeUnixSocketAddress(path);
+    ASSERT_EQ(bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)), 0);
+    ASSERT_EQ(listen(listener, 1), 0);
+
+    while (!recorder->IsConnected()) {
+        record_fn(records_count);
+        recorder->Flush();
+    }
+
+    const auto disconnected_dropped = recorder->Dropped();
+    for (int i = records_count + 1; i < 2 * records_count; ++i) {
+        record_fn(i);
+    }
+
+    recorder->Flush();
+    // the burst outpaces the recorder thread, but the records of the connected recorder are not dropped
+    EXPECT_EQ(recorder->Dropped(), disconnected_dropped);
+    recorder.reset();
+
+    const int client = accept(listener, nullptr, nullptr);
+    ASSERT_GE(client, 0);
+
+    std::string received;
+    char buffer[4096];
+    ssize_t size;
+    while ((size = recv(client, buffer, sizeof(buffer), 0)) > 0) {
+        received.append(buffer, static_cast<std::size_t>(size));
+    }
+
+    std::vector<std::string> frames;
+    std::istringstream stream(received);
+    for (std::string frame; std::getline(stream, frame);) {
+        frames.push_back(frame);
+    }
+
+    // the spilled records are sent first
+    ASSERT_GE(frames.size(), static_cast<std::size_t>(records_count - dropped + records_count - 1));
+    EXPECT_EQ(frames.front(), "2time | 1 | 2 | message 0");
+    EXPECT_EQ(frames.back(), "2time | 1 | 2 | message " + std::to_string(2 * records_count - 1));
+
+    close(client);
+    close(listener);
+}
+#endif
+
+TEST(SclTest, SocketFrameKeepsMultiLineMessage) {
+    std::string frames;
+    detail::AppendSocketFrame(frames, CoreRecord(Level::Debug, "time", std::nullopt, std::nullopt,
+                                                 "first\n2nd \\ line", 1, 2), false);
+    // a frame of an unknown level
+    frames += "7unknown\n";
+
+    // the frames are split the way the socket collector splits them
+    std::vector<std::pair<Level, std::string>> parsed;
+    std::istringstream stream(frames);
+    for (std::string frame; std::getline(stream, frame);) {
+        if (const auto record = detail::ParseSocketFrame(frame)) {
+            parsed.emplace_back(record->level, record->text);
+        }
+    }
+
+    ASSERT_EQ(parsed.size(), 1u);
+    EXPECT_EQ(parsed.front().first, Level::Debug);
+    EXPECT_EQ(parsed.front().second, "time | 1 | 2 | first\\n2nd \\\\ line");
+    EXPECT_FALSE(detail::ParseSocketFrame(""));
+    EXPECT_FALSE(detail::ParseSocketFrame("/"));
+}
+
+#ifdef SCL_HAS_UNIX_SOCKET
+TEST(SclTest, SyslogRecorderSendsRfc5424Frames) {
+    const int listener = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)), 0);
+    socklen_t address_size = sizeof(address);
+    ASSERT_EQ(getsockname(listener, reinterpret_cast<sockaddr *>(&address), &address_size), 0);
+
+    SyslogRecorder<CoreRecord>::Options options{};
+    options.port = ntohs(address.sin_port);
+    options.facility = SyslogRecorder<CoreRecord>::Facility::Local0;
+    options.app_name = "cis1";
+    options.hostname = "host";
+    options.batch_size = 4;
+
+    auto result = SyslogRecorder<CoreRecord>::Init(options);
+    auto recorder = std::get<SyslogRecorderPtr<CoreRecord>>(std::move(result));
+
+    const int records_count = 10;
+    for (int i = 0; i < records_count; ++i) {
+        recorder->OnRecord(CoreRecord(i % 2 ? Level::Error : Level::Info, "time", std::nullopt,
+                                      std::string("start job"), "message " + std::to_string(i), 1, 1234));
+    }
+
+    recorder->Flush();
+    EXPECT_EQ(recorder->Dropped(), 0u);
+
+    for (int i = 0; i < records_count; ++i) {
+        char buffer[2048];
+        const auto size = recv(listener, buffer, sizeof(buffer), 0);
+        ASSERT_GT(size, 0);
+
+        const std::string frame(buffer, static_cast<std::size_t>(size));
+        // local0 * 8 + error (3) or informational (6)
+        EXPECT_EQ(frame.rfind(i % 2 ? "<131>1 " : "<134>1 ", 0), 0u) << frame;
+        // "YYYY-MM-DDTHH:MM:SS.mmmZ"
+        EXPECT_EQ(frame[frame.find(' ') + 24], 'Z') << frame;
+        EXPECT_NE(frame.find("Z host cis1 1234 start_job - time | 1 | 1234 | start job | message "
+                             + std::to_string(i)), std::string::npos) << frame;
+    }
+
+    recorder.reset();
+    close(listener);
+}
+
+TEST(SclTest, SyslogRecorderDropsWhenSocketIsFull) {
+    const TempDir temp_dir("scl_test_syslog");
+    const auto path = (temp_dir.Path() / "syslog.dgram").string();
+
+    const int listener = socket(AF_UNIX, SOCK_DGRAM, 0);
+    const int buffer_size = 4096;
+    setsockopt(listener, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+    const auto address = detail::MakeUnixSocketAddress(path);
+    ASSERT_EQ(bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)), 0);
+
+    SyslogRecorder<CoreRecord>::Options options{};
+    options.transport = SyslogRecorder<CoreRecord>::Transport::UnixDatagram;
+    options.path = path;
+
+    auto result = SyslogRecorder<CoreRecord>::Init(options);
+    auto recorder = std::get<SyslogRecorderPtr<CoreRecord>>(std::move(result));
+
+    // the listener doesn't read the socket, so the socket buffer is filled
+    const int records_count = 10000;
+    for (int i = 0; i < records_count; ++i) {
+        recorder->OnRecord(CoreRecord(Level::Info, "time", std::nullopt, std::nullopt, "message", 1, 1234));
+    }
+
+    recorder->Flush();
+    EXPECT_GT(recorder->Dropped(), 0u);
+    EXPECT_LT(recorder->Dropped(), static_cast<std::uint64_t>(records_count));
+
+    recorder.reset();
+    close(listener);
+}
+#endif
+
+/**
+ * Recorder that stores the serialized records.
+ */
+class RawRecordsRecorder : public IRecorder<RawRecord> {
+public:
+    explicit RawRecordsRecorder(std::vector<std::string> &records) : m_records(records) {}
+
+    void OnRecord(const RawRecord &record) final {
+        m_records.emplace_back(record.text);
+    }
+
+private:
+    std::vector<std::string> &m_records;
+};
+
+TEST(SclTest, FlightRecorderDumpsContextOnError) {
+    std::vector<std::string> records;
+
+    FlightRecorder<CoreRecord>::Options options{};
+    options.records_count = 4;
+    options.pass_level = Level::Info;
+
+    auto result = FlightRecorder<CoreRecord>::Init(options, std::make_unique<RawRecordsRecorder>(records));
+    auto recorder = std::get<FlightRecorderPtr<CoreRecord>>(std::move(result));
+
+    const auto record_fn = [&recorder](Level level, const std::string &message) {
+        recorder->OnRecord(CoreRecord(level, "time", std::nullopt, std::nullopt, message, 1, 2));
+    };
+
+    for (int i = 0; i < 6; ++i) {
+        record_fn(Level::Debug, "debug " + std::to_string(i));
+    }
+
+    record_fn(Level::Info, "info");
+    EXPECT_EQ(records, std::vector<std::string>{"time | 1 | 2 | info"});
+
+    // the last 4 debug records precede the error
+    record_fn(Level::Error, "error");
+    record_fn(Level::Debug, "debug 6");
+    // the dumped records are not dumped again
+    record_fn(Level::Error, "error 2");
+
+    const std::vector<std::string> expected = {
+        "time | 1 | 2 | info",
+        "time | 1 | 2 | debug 2",
+        "time | 1 | 2 | debug 3",
+        "time | 1 | 2 | debug 4",
+        "time | 1 | 2 | debug 5",
+        "time | 1 | 2 | error",
+        "time | 1 | 2 | debug 6",
+        "time | 1 | 2 | error 2",
+    };
+
+    EXPECT_EQ(records, expected);
+    EXPECT_EQ(recorder->Skipped(), 0u);
+}
+
+TEST(SclTest, FlightRecorderDumpSizeLimit) {
+    std::vector<std::string> records;
+
+    FlightRecorder<CoreRecord>::Options options{};
+    options.records_count = 16;
+    options.record_size = 16;
+    // two truncated records
+    options.dump_size_limit = 40;
+
+    auto result = FlightRecorder<CoreRecord>::Init(options, std::make_unique<RawRecordsRecorder>(records));
+    auto recorder = std::get<FlightRecorderPtr<CoreRecord>>(std::move(result));
+
+    for (int i = 0; i < 8; ++i) {
+        recorder->OnRecord(CoreRecord(Level::Info, "time", std::nullopt, std::nullopt,
+                                      "message " + std::to_string(i), 1, 2));
+    }
+
+    recorder->Dump();
+    EXPECT_EQ(records, (std::vector<std::string>{"time | 1 | 2 | m", "time | 1 | 2 | m"}));
+}
+
+TEST(SclTest, BroadcastRecorderSkipsSlowSubscriber) {
+    BroadcastRecorder<CoreRecord>::Options options{};
+    options.records_count = 8;
+    options.data_size = 1024;
+
+    auto result = BroadcastRecorder<CoreRecord>::Init(options);
+    auto recorder = std::get<BroadcastRecorderPtr<CoreRecord>>(std::move(result));
+
+    const auto record_fn = [&recorder](int i) {
+        recorder->OnRecord(CoreRecord(Level::Info, "time", std::nullopt, std::nullopt,
+                                      "message " + std::to_string(i), 1, 2));
+    };
+
+    record_fn(0);
+    auto from_oldest = recorder->Subscribe(0);
+    auto from_latest = recorder->Subscribe();
+
+    for (int i = 1; i < 4; ++i) {
+        record_fn(i);
+    }
+
+    std::vector<std::string> records;
+    const auto read_fn = [&records](std::uint64_t, Level, std::string_view record) { records.emplace_back(record); };
+
+    EXPECT_EQ(from_oldest.Poll(read_fn), 4u);
+    EXPECT_EQ(records.front(), "time | 1 | 2 | message 0");
+    records.clear();
+
+    EXPECT_EQ(from_latest.Poll(read_fn), 3u);
+    EXPECT_EQ(records.front(), "time | 1 | 2 | message 1");
+    EXPECT_EQ(from_latest.Position(), 4u);
+    records.clear();
+
+    // the subscriber lags behind the ring by 16 records
+    for (int i = 4; i < 28; ++i) {
+        record_fn(i);
+    }
+
+    EXPECT_FALSE(from_oldest.Poll(read_fn) == 0);
+    EXPECT_EQ(from_oldest.Skipped(), 16u);
+    EXPECT_EQ(records.front(), "time | 1 | 2 | message 20");
+    EXPECT_EQ(records.back(), "time | 1 | 2 | message 27");
+    EXPECT_FALSE(from_oldest.Wait(std::chrono::milliseconds(1)));
+}
+
+TEST(SclTest, BroadcastRecorderConcurrentSubscribers) {
+    BroadcastRecorder<CoreRecord>::Options options{};
+    options.records_count = 64;
+    options.data_size = 2048;
+
+    auto result = BroadcastRecorder<CoreRecord>::Init(options);
+    auto recorder = std::get<BroadcastRecorderPtr<CoreRecord>>(std::move(result));
+
+    const int records_count = 20000;
+    const int subscribers_count = 4;
+
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> subscribers;
+    for (int s = 0; s < subscribers_count; ++s) {
+        subscribers.emplace_back([&failed, subscription = recorder->Subscribe(0)]() mutable {
+            std::uint64_t last_position = 0;
+            bool is_first = true;
+            while (last_position + 1 < records_count) {
+                subscription.Wait(std::chrono::milliseconds(10));
+                subscription.Poll([&](std::uint64_t position, Level, std::string_view record) {
+                    // a record is never torn and the positions increase
+                    if (record != "time | 1 | 2 | message " + std::to_string(position)
+                        || (!is_first && position <= last_position)) {
+                        failed = true;
+                    }
+
+                    is_first = false;
+                    last_position = position;
+                });
+            }
+        });
+    }
+
+    for (int i = 0; i < records_count; ++i) {
+        recorder->OnRecord(CoreRecord(Level::Info, "time", std::nullopt, std::nullopt,
+                                      "message " + std::to_string(i), 1, 2));
+    }
+
+    for (auto &subscriber : subscribers) {
+        subscriber.join();
+    }
+
+    EXPECT_FALSE(failed);
+}
+
+/**
+ * Recorder that stores copies of the handled records.
+ */
+class CoreRecordsRecorder : public IRecorder<CoreRecord> {
+public:
+    explicit CoreRecordsRecorder(std::vector<CoreRecord> &records) : m_records(records) {}
+
+    void OnRecord(const CoreRecord &record) final {
+        m_records.push_back(record);
+    }
+
+private:
+    std::vector<CoreRecord> &m_records;
+};
+
+TEST(SclTest, ChildLoggerSharesRecorders) {
+    std::vector<CoreRecord> records;
+    RecordersCont<CoreRecord> cont;
+    cont.push_back(std::make_unique<CoreRecordsRecorder>(records));
+
+    LoggerPtr logger;
+    Unwrap(logger, CoreLogger::Init(CoreLogger::Options{Level::Info, 10, 1, "parent"}, std::move(cont)));
+
+    const auto child = logger->Child("job-1");
+    const auto grandchild = child.Child("job-2", 20, 10);
+    // the child loggers are copyable
+    const auto copy = grandchild;
+
+    logger->SesRecord(Level::Info, "parent record");
+    child.SesRecord(Level::Info, "child record");
+    child.Record(Level::Debug, "skipped");
+    copy.SesRecord(Level::Error, "grandchild record");
+
+    ASSERT_EQ(records.size(), 3u);
+
+    EXPECT_EQ(records[0].session_id, "parent");
+    EXPECT_EQ(records[0].pid, 10);
+
+    EXPECT_EQ(records[1].session_id, "job-1");
+    EXPECT_EQ(records[1].message, "child record");
+    EXPECT_EQ(records[1].pid, 10);
+    EXPECT_EQ(records[1].parent_pid, 1);
+
+    EXPECT_EQ(records[2].session_id, "job-2");
+    EXPECT_EQ(records[2].pid, 20);
+    EXPECT_EQ(records[2].parent_pid, 10);
+}
+
+TEST(SclTest, ChildLoggersOnSeveralThreads) {
+    using AsyncLogger = BasicCoreLogger<threading::Async<>>;
+
+    std::vector<CoreRecord> records;
+    RecordersCont<CoreRecord> cont;
+    cont.push_back(std::make_unique<CoreRecordsRecorder>(records));
+
+    BasicLoggerPtr<threading::Async<>> logger;
+    Unwrap(logger, AsyncLogger::Init(AsyncLogger::Options{Level::Info}, std::move(cont)));
+
+    const int threads_count = 4;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; ++t) {
+        threads.emplace_back([child = logger->Child("job-" + std::to_string(t))] {
+            child.SesRecord(Level::Info, "message");
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    logger->Flush();
+    ASSERT_EQ(records.size(), static_cast<std::size_t>(threads_count));
+    for (int t = 0; t < threads_count; ++t) {
+        const auto session_id = "job-" + std::to_string(t);
+        EXPECT_EQ(std::count_if(records.begin(), records.end(),
+                                [&session_id](const CoreRecord &record) { return record.session_id == session_id; }),
+                  1);
+    }
+}
+
+TEST(SclTest, CoreRecordFormat) {
+    const CoreRecord full(Level::Info, "2020-01-02-03-04-05", std::string("session"),
+                          std::string("startjob_stdout_long"), "message", 1, 1234);
+    EXPECT_EQ(full.ToString(),
+              "2020-01-02-03-04-05 | 1 | 1234 | session | startjob_stdout_long | message");
+    EXPECT_EQ(full.ToAlignedString(),
+              "2020-01-02-03-04-05 |           1 |        1234 |"
+              "                                     session | startjob_stdout | message");
+
+    const CoreRecord short_record(Level::Info, "2020-01-02-03-04-05", std::nullopt, std::nullopt, "message", -1, 1234);
+    EXPECT_EQ(short_record.ToString(), "2020-01-02-03-04-05 | -1 | 1234 | message");
+    EXPECT_EQ(short_record.ToAlignedString(), "2020-01-02-03-04-05 |          -1 |        1234 | message");
+}
+
+TEST(SclTest, CoreRecordViewDetach) {
+    std::string message = "message";
+    std::string session_id = "session";
+
+    CoreRecord record(scl::view_k, Level::Info, "2020-01-02-03-04-05", session_id, std::nullopt, message, 1, 2);
+    EXPECT_FALSE(record.IsDetached());
+    EXPECT_EQ(record.message.data(), message.data());
+
+    const CoreRecord copy = record;
+    EXPECT_TRUE(copy.IsDetached());
+
+    record.Detach();
+    EXPECT_TRUE(record.IsDetached());
+
+    message.assign(message.size(), 'x');
+    session_id.assign(session_id.size(), 'x');
+    EXPECT_EQ(record.ToString(), "2020-01-02-03-04-05 | 1 | 2 | session | message");
+    EXPECT_EQ(copy.ToString(), "2020-01-02-03-04-05 | 1 | 2 | session | message");
+}
+
+TEST(SclTest, RecordPoolRecyclesBlocks) {
+    using scl::detail::PoolBlock;
+
+    char *data = nullptr;
+    {
+        const PoolBlock block(100);
+        data = block.Data();
+    }
+
+    // a block released on the owner thread is reused at once
+    auto block = std::make_unique<PoolBlock>(100);
+    EXPECT_EQ(block->Data(), data);
+
+    // a block released on other thread is returned to the owner pool
+    std::thread([&block] { block.reset(); }).join();
+    const PoolBlock recycled(100);
+    EXPECT_EQ(recycled.Data(), data);
+
+    const PoolBlock large(1024 * 1024);
+    EXPECT_NE(large.Data(), nullptr);
+}
+
+TEST(SclTest, JsonStringEscaping) {
+    const auto escape_fn = [](std::string_view str) {
+        std::string result;
+        detail::AppendJsonString(result, str);
+        return result;
+    };
+
+    EXPECT_EQ(escape_fn(""), "\"\"");
+    EXPECT_EQ(escape_fn("plain"), "\"plain\"");
+    EXPECT_EQ(escape_fn("a\"b\\c\nd\te\x01"), "\"a\\\"b\\\\c\\nd\\te\\u0001\"");
+    // the UTF-8 bytes are not escaped
+    EXPECT_EQ(escape_fn("\xd0\xbf\xd1\x80\xd0\xb8"), "\"\xd0\xbf\xd1\x80\xd0\xb8\"");
+
+    // the special characters at every position of the vectorized and scalar parts
+    const std::string clean(70, 'x');
+    for (std::size_t pos = 0; pos < clean.size(); ++pos) {
+        auto str = clean;
+        str[pos] = '"';
+        EXPECT_EQ(escape_fn(str), "\"" + clean.substr(0, pos) + "\\\"" + clean.substr(pos + 1) + "\"");
+    }
+}
+
+TEST(SclTest, FileRecorderSanitizesControlChars) {
+    const auto sanitize_fn = [](std::string str) {
+        detail::SanitizeControlChars(str);
+        return str;
+    };
+
+    EXPECT_EQ(sanitize_fn("plain \"text\""), "plain \"text\"");
+    EXPECT_EQ(sanitize_fn("c:\\n\n"), "c:\\\\n\\n");
+    EXPECT_EQ(sanitize_fn("a\nb\r\nc\td\x01\x7f"), "a\\nb\\r\\nc\\td\\x01\\x7f");
+
+    // the control characters at every position of the vectorized and scalar parts
+    const std::string clean(70, 'x');
+    for (std::size_t pos = 0; pos < clean.size(); ++pos) {
+        auto str = clean;
+        str[pos] = '\n';
+        EXPECT_EQ(sanitize_fn(str), clean.substr(0, pos) + "\\n" + clean.substr(pos + 1));
+    }
+
+    const TempDir temp_dir("scl_test_sanitize");
+    const auto &dir = temp_dir.Path();
+
+    FileRecorder<CoreRecord>::Options options{};
+    options.log_directory = dir;
+    options.file_name_template = "file.txt";
+    options.sanitize = true;
+
+    FileRecorderPtr<CoreRecord> recorder;
+    Unwrap(recorder, FileRecorder<CoreRecord>::Init(options));
+    recorder->OnRecord(CoreRecord(Level::Info, "time", std::nullopt, std::nullopt, "first\nsecond", 1, 2));
+    recorder.reset();
+
+    std::ifstream file(dir / "file.txt");
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);) {
+        lines.push_back(line);
+    }
+
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines.front(),
+              CoreRecord(Level::Info, "time", std::nullopt, std::nullopt, "first\\nsecond", 1, 2).ToString());
+}
+
+TEST(SclTest, RecordJsonFormat) {
+    const CoreRecord core(Level::Info, "2020-01-02-03-04-05", std::string("session"),
+                          std::string("startjob"), "say \"hi\"", 1, 1234);
+    std::string core_json;
+    core.AppendFormatted(core_json, RecordFormat::JsonLines);
+    EXPECT_EQ(core_json,
+              "{\"time\":\"2020-01-02-03-04-05\",\"level\":\"Info\",\"pid\":1234,\"ppid\":1,"
+              "\"session_id\":\"session\",\"action\":\"startjob\",\"message\":\"say \\\"hi\\\"\"}");
+
+    const CoreRecord short_core(Level::Error, "time", std::nullopt, std::nullopt, "msg", 1, 2);
+    std::string short_core_json;
+    short_core.AppendJsonString(short_core_json);
+    EXPECT_EQ(short_core_json, "{\"time\":\"time\",\"level\":\"Error\",\"pid\":2,\"ppid\":1,\"message\":\"msg\"}");
+
+    using cis1::webui_logger::WebuiRecord;
+    using cis1::webui_logger::Protocol;
+
+    const WebuiRecord webui(Level::Error, "time", "msg", Protocol::HTTP_POST,
+                            std::string("handler"), std::string("127.0.0.1:80"), std::string("a@b.c"));
+    std::string webui_json;
+    webui.AppendJsonString(webui_json);
+    EXPECT_EQ(webui_json,
+              "{\"time\":\"time\",\"level\":\"Error\",\"protocol\":\"HTTP POST\",\"handler\":\"handler\","
+              "\"remote_addr\":\"127.0.0.1:80\",\"email\":\"a@b.c\",\"message\":\"msg\"}");
+
+    const WebuiRecord short_webui(Level::Debug, "time", "msg", std::nullopt, std::nullopt, std::nullopt, std::nullopt);
+    std::string short_webui_json;
+    short_webui.AppendJsonString(short_webui_json);
+    EXPECT_EQ(short_webui_json, "{\"time\":\"time\",\"level\":\"Debug\",\"message\":\"msg\"}");
+}
+
+TEST(SclTest, FileRecorderMessagePackFormat) {
+    using cis1::webui_logger::WebuiRecord;
+    using cis1::webui_logger::WebuiRecordKey;
+    using cis1::webui_logger::Protocol;
+
+    EXPECT_EQ(TimeStrToSeconds("1970-01-01-00-00-00"), 0);
+    EXPECT_EQ(TimeStrToSeconds("2020-01-02-03-04-05"), 1577934245);
+    EXPECT_EQ(SecondsToTimeStr(1577934245), "2020-01-02-03-04-05");
+    EXPECT_FALSE(TimeStrToSeconds("time"));
+
+    const TempDir temp_dir("scl_test_msgpack");
+    const auto &dir = temp_dir.Path();
+
+    const CoreRecord core(Level::Info, "2020-01-02-03-04-05", std::string("session"), std::nullopt,
+                          std::string(300, 'm'), 1, 70000);
+    const CoreRecord unparsed_time(Level::Debug, "time", std::nullopt, std::string("startjob"), "msg", 1, 2);
+    {
+        FileRecorder<CoreRecord>::Options options{};
+        options.log_directory = dir;
+        options.file_name_template = "core.bin";
+        options.format = RecordFormat::MessagePack;
+
+        FileRecorderPtr<CoreRecord> recorder;
+        Unwrap(recorder, FileRecorder<CoreRecord>::Init(options));
+        recorder->OnRecord(core);
+        recorder->OnRecord(unparsed_time);
+    }
+
+    {
+        FileRecorder<WebuiRecord>::Options options{};
+        options.log_directory = dir;
+        options.file_name_template = "webui.bin";
+        options.format = RecordFormat::MessagePack;
+
+        FileRecorderPtr<WebuiRecord> recorder;
+        Unwrap(recorder, FileRecorder<WebuiRecord>::Init(options));
+        recorder->OnRecord(WebuiRecord(Level::Error, "2020-01-02-03-04-05", "msg", Protocol::WS,
+                                       std::nullopt, std::string("127.0.0.1:80"), std::nullopt));
+    }
+
+    // the small buffer is refilled and is increased for the long message
+    std::ifstream core_file(dir / "core.bin", std::ios::binary);
+    MsgPackReader core_reader(core_file, 16);
+    MsgPackRecord record;
+
+    ASSERT_TRUE(core_reader.Next(record));
+    EXPECT_EQ(record.Integer(CoreRecordKey::Time), 1577934245);
+    EXPECT_EQ(record.Integer(CoreRecordKey::Level), static_cast<int>(Level::Info));
+    EXPECT_EQ(record.Integer(CoreRecordKey::ParentPid), 1);
+    EXPECT_EQ(record.Integer(CoreRecordKey::Pid), 70000);
+    EXPECT_EQ(record.String(CoreRecordKey::SessionId), "session");
+    EXPECT_EQ(record.Get(CoreRecordKey::Action).type, MsgPackValue::Type::Absent);
+    EXPECT_EQ(record.String(CoreRecordKey::Message), core.message);
+
+    ASSERT_TRUE(core_reader.Next(record));
+    EXPECT_EQ(record.String(CoreRecordKey::Time), "time");
+    EXPECT_EQ(record.String(CoreRecordKey::Action), "startjob");
+    EXPECT_EQ(record.String(CoreRecordKey::Message), "msg");
+
+    EXPECT_FALSE(core_reader.Next(record));
+    EXPECT_FALSE(core_reader.IsMalformed());
+
+    std::ifstream webui_file(dir / "webui.bin", std::ios::binary);
+    MsgPackReader webui_reader(webui_file);
+    ASSERT_TRUE(webui_reader.Next(record));
+    EXPECT_EQ(record.Integer(WebuiRecordKey::Level), static_cast<int>(Level::Error));
+    EXPECT_EQ(record.Integer(WebuiRecordKey::Protocol), static_cast<int>(Protocol::WS));
+    EXPECT_EQ(record.String(WebuiRecordKey::RemoteAddr), "127.0.0.1:80");
+    EXPECT_EQ(record.Get(WebuiRecordKey::Handler).type, MsgPackValue::Type::Absent);
+    EXPECT_EQ(record.String(WebuiRecordKey::Message), "msg");
+    EXPECT_FALSE(webui_reader.Next(record));
+
+    // the truncated record
+    std::string data;
+    core.AppendMsgPack(data);
+    std::size_t size = 0;
+    EXPECT_EQ(MsgPackReader::Parse(std::string_view(data).substr(0, data.size() - 1), record, size),
+              MsgPackReader::ParseResult::Incomplete);
+    EXPECT_EQ(MsgPackReader::Parse(data, record, size), MsgPackReader::ParseResult::Ok);
+    EXPECT_EQ(size, data.size());
+    EXPECT_LT(data.size(), core.ToAlignedString().size());
+}
+
+TEST(SclTest, InternTableConcurrentInsertions) {
+    detail::InternTable table(100);
+    const int threads_count = 4;
+    std::vector<std::vector<std::optional<std::uint32_t>>> ids(threads_count);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; ++t) {
+        threads.emplace_back([&table, &ids, t] {
+            for (int i = 0; i < 120; ++i) {
+                ids[t].push_back(table.Intern("value " + std::to_string((i + t * 7) % 120)));
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // the table keeps 100 strings with the ids 0-99, every thread gets the same id for a string
+    EXPECT_EQ(table.Size(), 100u);
+    std::map<std::string, std::optional<std::uint32_t>> string_ids;
+    for (int t = 0; t < threads_count; ++t) {
+        for (int i = 0; i < 120; ++i) {
+            const auto str = "value " + std::to_string((i + t * 7) % 120);
+            const auto id = ids[t][i];
+            if (id) {
+                ASSERT_LT(*id, 100u);
+                EXPECT_EQ(table.Value(*id), str);
+            }
+
+            const auto [it, is_inserted] = string_ids.emplace(str, id);
+            if (!is_inserted && it->second && id) {
+                EXPECT_EQ(*it->second, *id);
+            }
+        }
+    }
+}
+
+TEST(SclTest, FileRecorderInternsRepeatedFields) {
+    const TempDir temp_dir("scl_test_intern");
+    const auto &dir = temp_dir.Path();
+
+    const auto write_fn = [&dir](const std::string &name, std::optional<std::size_t> intern_capacity) {
+        FileRecorder<CoreRecord>::Options options{};
+        options.log_directory = dir;
+        options.file_name_template = name;
+        options.format = RecordFormat::MessagePack;
+        options.intern_capacity = intern_capacity;
+
+        FileRecorderPtr<CoreRecord> recorder;
+        Unwrap(recorder, FileRecorder<CoreRecord>::Init(options));
+        for (int i = 0; i < 100; ++i) {
+            recorder->OnRecord(CoreRecord(Level::Info, "2020-01-02-03-04-05", std::string("2020-01-02-03-04-05-100_1"),
+                                          std::string(i % 2 == 0 ? "startjob" : "startjob_stdout"),
+                                          "message " + std::to_string(i), 1, 100));
+        }
+    };
+
+    write_fn("plain.bin", std::nullopt);
+    write_fn("interned.bin", 16);
+    // the session id and action take about a half of the plain records
+    EXPECT_LT(fs::file_size(dir / "interned.bin"), fs::file_size(dir / "plain.bin") * 3 / 5);
+
+    std::ifstream file(dir / "interned.bin", std::ios::binary);
+    MsgPackReader reader(file);
+    MsgPackRecord record;
+    int count = 0;
+    while (reader.Next(record)) {
+        EXPECT_EQ(record.String(CoreRecordKey::SessionId), "2020-01-02-03-04-05-100_1");
+        EXPECT_EQ(record.String(CoreRecordKey::Action), count % 2 == 0 ? "startjob" : "startjob_stdout");
+        EXPECT_EQ(record.String(CoreRecordKey::Message), "message " + std::to_string(count));
+        ++count;
+    }
+
+    EXPECT_FALSE(reader.IsMalformed());
+    EXPECT_EQ(count, 100);
+    EXPECT_EQ(reader.Dictionary().size(), 3u);
+
+    // the ids are defined in order, an id beyond the dictionary is a corrupted one
+    std::string gap_data;
+    detail::AppendMsgPackInternDefinition(gap_data, 0, "startjob");
+    detail::AppendMsgPackInternDefinition(gap_data, 0x7fffffff, "startjob_stdout");
+    std::istringstream gap_stream(gap_data);
+    MsgPackReader gap_reader(gap_stream);
+    EXPECT_FALSE(gap_reader.Next(record));
+    EXPECT_TRUE(gap_reader.IsMalformed());
+    EXPECT_EQ(gap_reader.Dictionary().size(), 1u);
+
+    FileRecorder<CoreRecord>::Options options{};
+    options.log_directory = dir;
+    options.file_name_template = "text.txt";
+    options.intern_capacity = 16;
+    auto result = FileRecorder<CoreRecord>::Init(options);
+    EXPECT_ERROR(result, FileRecorder<CoreRecord>::InitError::IncorrectInternOptions);
+}
+
+#ifdef SCL_HAS_MAPPED_FILE
+TEST(SclTest, FileRecorderIndexSeeks) {
+    const TempDir temp_dir("scl_test_index");
+    const auto &dir = temp_dir.Path();
+
+    // ten records per second
+    const auto base_time = *TimeStrToSeconds("2020-01-02-03-00-00");
+    const auto write_fn = [&dir, base_time](int from, int to) {
+        FileRecorder<CoreRecord>::Options options{};
+        options.log_directory = dir;
+        options.file_name_template = "indexed.txt";
+        options.index = true;
+        options.index_records_interval = 8;
+        options.sanitize = true;
+
+        FileRecorderPtr<CoreRecord> recorder;
+        Unwrap(recorder, FileRecorder<CoreRecord>::Init(options));
+        for (int i = from; i < to; ++i) {
+            // every tenth message takes several lines
+            const auto message = "message " + std::to_string(i) + (i % 10 == 3 ? "\nnext line" : "");
+            recorder->OnRecord(CoreRecord(Level::Info, SecondsToTimeStr(base_time + i / 10), std::string("session"),
+                                          std::string("action"), message, 1, 100));
+        }
+    };
+
+    const auto lines_fn = [&dir]() {
+        std::vector<std::string> lines;
+        std::ifstream file(dir / "indexed.txt");
+        for (std::string line; std::getline(file, line);) {
+            lines.push_back(line + '\n');
+        }
+
+        return lines;
+    };
+
+    write_fn(0, 100);
+    auto lines = lines_fn();
+    ASSERT_EQ(lines.size(), 100u);
+
+    LogIndexReaderPtr reader;
+    Unwrap(reader, LogIndexReader::Init(dir / "indexed.txt"));
+    EXPECT_EQ(reader->Entries().size(), 13u);
+    EXPECT_EQ(reader->FromSequence(0).substr(0, lines[0].size()), lines[0]);
+    EXPECT_EQ(reader->FromSequence(37).substr(0, lines[37].size()), lines[37]);
+    EXPECT_EQ(reader->FromSequence(45).substr(0, lines[45].size()), lines[45]);
+    EXPECT_NE(lines[43].find("message 43\\nnext line"), std::string::npos);
+    EXPECT_TRUE(reader->FromSequence(100).empty());
+
+    // the region starts at most one index interval before the first record of the time
+    const auto region = reader->FromTime(base_time + 5);
+    const auto region_start = reader->Data().size() - region.size();
+    std::size_t line_offset = 0;
+    for (int i = 0; i < 50; ++i) {
+        line_offset += lines[i].size();
+    }
+    EXPECT_LE(region_start, line_offset);
+    EXPECT_GE(region_start + 8 * lines[49].size(), line_offset);
+    EXPECT_EQ(reader->FromTime(base_time - 1).size(), reader->Data().size());
+
+    // the appended records continue the sequence numbers of the index
+    write_fn(100, 120);
+    lines = lines_fn();
+    Unwrap(reader, LogIndexReader::Init(dir / "indexed.txt"));
+    EXPECT_EQ(reader->FromSequence(110).substr(0, lines[110].size()), lines[110]);
+    EXPECT_EQ(reader->Entries().back().sequence, 116u);
+
+    FileRecorder<CoreRecord>::Options options{};
+    options.log_directory = dir;
+    options.file_name_template = "indexed.bin";
+    options.format = RecordFormat::MessagePack;
+    options.index = true;
+    auto result = FileRecorder<CoreRecord>::Init(options);
+    EXPECT_ERROR(result, FileRecorder<CoreRecord>::InitError::IncorrectIndexOptions);
+
+    // a multi-line plain record would shift the sequence numbers of a reopened file
+    options.file_name_template = "unsanitized.txt";
+    options.format = RecordFormat::Plain;
+    result = FileRecorder<CoreRecord>::Init(options);
+    EXPECT_ERROR(result, FileRecorder<CoreRecord>::InitError::IncorrectIndexOptions);
+}
+#endif
+
+TEST(SclTest, FileRecorderBloomFilters) {
+    using detail::BloomField;
+    using detail::BloomFilter;
+    using detail::BloomHash;
+
+    const TempDir temp_dir("scl_test_bloom");
+    const auto &dir = temp_dir.Path();
+
+    FileRecorder<CoreRecord>::Options options{};
+    options.log_directory = dir;
+    options.file_name_template = "bloom.%n.txt";
+    options.size_limit = 2000;
+    options.bloom_filter_size = 4096;
+
+    const auto write_fn = [&options](int from, int to) {
+        FileRecorderPtr<CoreRecord> recorder;
+        Unwrap(recorder, FileRecorder<CoreRecord>::Init(options));
+        for (int i = from; i < to; ++i) {
+            // ten records per session
+            recorder->OnRecord(CoreRecord(Level::Info, "2020-01-02-03-04-05", "session_" + std::to_string(i / 10),
+                                          std::string("startjob"), "message " + std::to_string(i), 1, 100));
+        }
+    };
+
+    // the sessions of every file (by the message numbers)
+    const auto file_sessions_fn = [&dir](const fs::path &path) {
+        std::set<int> sessions;
+        std::ifstream file(path);
+        for (std::string line; std::getline(file, line);) {
+            sessions.insert(std::stoi(line.substr(line.rfind("message ") + 8)) / 10);
+        }
+
+        return sessions;
+    };
+
+    write_fn(0, 100);
+
+    std::size_t files_count = 0;
+    for (int session = 0; session < 10; ++session) {
+        std::size_t candidates_count = 0;
+        for (int n = 1; fs::exists(dir / ("bloom." + std::to_string(n) + ".txt")); ++n) {
+            const auto path = dir / ("bloom." + std::to_string(n) + ".txt");
+            const auto filter = BloomFilter::Load(detail::BloomFilterPath(path));
+            ASSERT_TRUE(filter);
+
+            const bool may_contain = filter->MayContain(BloomHash(BloomField::SessionId, "session_" + std::to_string(session)));
+            EXPECT_EQ(may_contain, file_sessions_fn(path).count(session) != 0);
+            EXPECT_TRUE(filter->MayContain(BloomHash(BloomField::Action, "startjob")));
+            EXPECT_FALSE(filter->MayContain(BloomHash(BloomField::SessionId, "startjob")));
+            candidates_count += may_contain;
+            files_count = static_cast<std::size_t>(n);
+        }
+
+        // a session is split by the rotation at most
+        EXPECT_GE(candidates_count, 1u);
+        EXPECT_LE(candidates_count, 2u);
+    }
+    EXPECT_GT(files_count, 3u);
+
+    // the reopened file continues its filter
+    options.file_name_template = "bloom.txt";
+    options.size_limit = std::nullopt;
+    write_fn(0, 20);
+    write_fn(20, 30);
+    const auto filter = BloomFilter::Load(detail::BloomFilterPath(dir / "bloom.txt"));
+    ASSERT_TRUE(filter);
+    for (int session = 0; session < 3; ++session) {
+        EXPECT_TRUE(filter->MayContain(BloomHash(BloomField::SessionId, "session_" + std::to_string(session))));
+    }
+
+    options.bloom_filter_size = 0;
+    auto result = FileRecorder<CoreRecord>::Init(options);
+    EXPECT_ERROR(result, FileRecorder<CoreRecord>::InitError::IncorrectBloomFilterOptions);
+}
+
+TEST(SclTest, TextLogReaderScan) {
+    using cis1::webui_logger::Protocol;
+    using cis1::webui_logger::WebuiRecord;
+
+    const auto base_time = *TimeStrToSeconds("2020-01-02-03-00-00");
+
+    // the plain and aligned records of different lengths cross the 64-byte blocks
+    std::string data;
+    for (int i = 0; i < 200; ++i) {
+        const CoreRecord record(Level::Info, SecondsToTimeStr(base_time + i / 10),
+                                i % 3 == 0 ? std::optional<std::string>("session_" + std::to_string(i % 7)) : std::nullopt,
+                                std::string("startjob"), "message " + std::to_string(i) + (i % 5 == 0 ? " a|b | c" : ""),
+                                1, 100 + i % 4);
+        data += i % 2 == 0 ? record.ToString() : record.ToAlignedString();
+        data += '\n';
+    }
+    // the record that is being written is skipped
+    data += "2020-01-02-04-00-00 | 1 | 100 | incomplete";
+
+    TextLogReader::Filter filter;
+    std::vector<std::vector<std::string>> records;
+    auto stats = TextLogReader::ScanText(data, filter, [&records](const TextRecordView &record) {
+        auto &fields = records.emplace_back();
+        for (std::size_t i = 0; i < record.FieldsCount(); ++i) {
+            fields.emplace_back(record.Field(i));
+        }
+    });
+    EXPECT_EQ(stats.lines_count, 200u);
+    EXPECT_EQ(stats.matched_count, 200u);
+    ASSERT_EQ(records.size(), 200u);
+    EXPECT_EQ(records[1], (std::vector<std::string>{SecondsToTimeStr(base_time), "1", "101", "startjob", "message 1"}));
+    EXPECT_EQ(records[3],
+              (std::vector<std::string>{SecondsToTimeStr(base_time), "1", "103", "session_3", "startjob", "message 3"}));
+    // the separator within the message splits it, a '|' without the spaces doesn't
+    EXPECT_EQ(records[5],
+              (std::vector<std::string>{SecondsToTimeStr(base_time), "1", "101", "startjob", "message 5 a|b", "c"}));
+
+    filter.min_time = base_time + 5;
+    filter.max_time = base_time + 6;
+    filter.pid = 101;
+    stats = TextLogReader::ScanText(data, filter, [base_time](const TextRecordView &record) {
+        EXPECT_EQ(record.Field(2), "101");
+        EXPECT_GE(*TimeStrToSeconds(record.Time()), base_time + 5);
+    });
+    // the records 50-69 with the pid 101
+    EXPECT_EQ(stats.matched_count, 5u);
+
+    filter = {};
+    filter.substring = "session_3";
+    stats = TextLogReader::ScanText(data, filter, [](const TextRecordView &record) {
+        EXPECT_EQ(record.Field(3), "session_3");
+    });
+    EXPECT_EQ(stats.matched_count, 10u);
+
+    data.clear();
+    for (const auto level : {Level::Action, Level::Error, Level::Info, Level::Debug}) {
+        data += WebuiRecord(level, "2020-01-02-03-04-05", "msg", Protocol::HTTP_GET,
+                            std::string("handler"), std::nullopt, std::nullopt).ToAlignedString();
+        data += '\n';
+    }
+
+    filter = {};
+    filter.level = Level::Error;
+    stats = TextLogReader::ScanText(data, filter, [](const TextRecordView &) {});
+    EXPECT_EQ(stats.matched_count, 2u);
+
+#ifdef SCL_HAS_MAPPED_FILE
+    const TempDir temp_dir("scl_test_text_reader");
+    const auto path = temp_dir.Path() / "file.txt";
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << data;
+    }
+
+    TextLogReaderPtr reader;
+    Unwrap(reader, TextLogReader::Init(path));
+    EXPECT_EQ(reader->Scan(filter, [](const TextRecordView &record) {
+        EXPECT_EQ(record.Message(), "msg");
+    }).matched_count, 2u);
+#endif
+}
+
+TEST(SclTest, SegmentMergerOrdersByTime) {
+    const TempDir temp_dir("scl_test_merge");
+    const auto &dir = temp_dir.Path();
+
+    const auto base_time = *TimeStrToSeconds("2020-01-02-03-00-00");
+    const int files_count = 3;
+    const int records_count = 300;
+
+    // the processes write the records of the interleaved times, the record i of the file f has the time (i + f) / 2
+    SegmentMerger::Options options;
+    for (int f = 0; f < files_count; ++f) {
+        const auto path = dir / ("process_" + std::to_string(f) + ".txt");
+        std::ofstream file(path);
+        for (int i = 0; i < records_count; ++i) {
+            const CoreRecord record(Level::Info, SecondsToTimeStr(base_time + (i + f) / 2), std::nullopt, std::nullopt,
+                                    "file " + std::to_string(f) + " record " + std::to_string(i), 1, 100 + f);
+            std::string line;
+            record.AppendFormatted(line, f == 1 ? RecordFormat::JsonLines : RecordFormat::Aligned);
+            file << line << '\n';
+            if (i % 50 == 0) {
+                // the continuation of a multi-line message follows its record
+                file << "continuation of " << f << ' ' << i << '\n';
+            }
+        }
+
+        options.files.push_back(path);
+    }
+    options.workers_count = 2;
+    // the small batches are split within the lines
+    options.batch_size = 100;
+
+    SegmentMergerPtr merger;
+    Unwrap(merger, SegmentMerger::Init(options));
+
+    std::int64_t last_time = 0;
+    std::vector<std::uint64_t> last_sequences(files_count, 0);
+    std::string last_line;
+    int continuations_count = 0;
+    const auto stats = merger->Merge([&](const MergedRecord &record) {
+        EXPECT_GE(record.time, last_time);
+        EXPECT_TRUE(record.sequence == 0 || record.sequence == last_sequences[record.file_index] + 1);
+        if (record.line.substr(0, 12) == "continuation") {
+            EXPECT_NE(last_line.find("file " + std::to_string(record.file_index)), std::string::npos);
+            ++continuations_count;
+        }
+
+        last_time = record.time;
+        last_sequences[record.file_index] = record.sequence;
+        last_line = record.line;
+    });
+
+    EXPECT_EQ(stats.records_count, static_cast<std::size_t>(files_count * (records_count + records_count / 50)));
+    EXPECT_EQ(continuations_count, files_count * records_count / 50);
+    EXPECT_EQ(last_time, base_time + (records_count - 1 + files_count - 1) / 2);
+
+    options.files.push_back(dir / "not_exists.txt");
+    auto result = SegmentMerger::Init(options);
+    EXPECT_ERROR(result, SegmentMerger::InitError::CantOpenFile);
+}
+
+TEST(SclTest, RecordSequenceNumbers) {
+    CoreRecord core(Level::Info, "2020-01-02-03-04-05", std::nullopt, std::nullopt, "message", -1, 1234);
+    core.SetSequence(42);
+    EXPECT_EQ(core.ToString(), "2020-01-02-03-04-05 | #42 | -1 | 1234 | message");
+    EXPECT_EQ(core.ToAlignedString(), "2020-01-02-03-04-05 |          #42 |          -1 |        1234 | message");
+
+    std::string json;
+    core.AppendJsonString(json);
+    EXPECT_EQ(json, "{\"time\":\"2020-01-02-03-04-05\",\"seq\":42,\"level\":\"Info\",\"pid\":1234,\"ppid\":-1,"
+                    "\"message\":\"message\"}");
+
+    std::string data;
+    core.AppendMsgPack(data);
+    MsgPackRecord fields;
+    std::size_t size = 0;
+    ASSERT_EQ(MsgPackReader::Parse(data, fields, size), MsgPackReader::ParseResult::Ok);
+    EXPECT_EQ(fields.Integer(CoreRecordKey::Sequence), 42);
+    EXPECT_EQ(fields.Integer(CoreRecordKey::Pid), 1234);
+
+    const auto text = core.ToAlignedString() + '\n';
+    TextLogReader::ScanText(text, {}, [](const TextRecordView &record) {
+        EXPECT_EQ(record.Sequence(), 42u);
+        EXPECT_EQ(record.Field(2), "-1");
+    });
+
+    // the producers number the records by blocks, the numbers are unique and increase within a thread
+    std::vector<CoreRecord> records;
+    RecordersCont<CoreRecord> cont;
+    cont.push_back(std::make_unique<CoreRecordsRecorder>(records));
+
+    using LockedLogger = BasicCoreLogger<threading::Locked<>>;
+    LockedLogger::Options options{Level::Info};
+    options.sequence_block_size = 4;
+    BasicLoggerPtr<threading::Locked<>> logger;
+    Unwrap(logger, LockedLogger::Init(options, std::move(cont)));
+
+    const int threads_count = 4;
+    const int records_count = 100;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; ++t) {
+        threads.emplace_back([child = logger->Child(std::to_string(t))] {
+            for (int i = 0; i < records_count; ++i) {
+                child.SesRecord(Level::Info, "message");
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(records.size(), static_cast<std::size_t>(threads_count * records_count));
+    std::set<std::uint64_t> sequences;
+    std::map<std::string_view, std::uint64_t> last_sequences;
+    for (const auto &record : records) {
+        ASSERT_TRUE(record.Sequence());
+        EXPECT_TRUE(sequences.insert(*record.Sequence()).second);
+
+        const auto it = last_sequences.find(*record.session_id);
+        if (it != last_sequences.end()) {
+            EXPECT_GT(*record.Sequence(), it->second);
+        }
+
+        last_sequences[*record.session_id] = *record.Sequence();
+    }
+
+    // the merger orders the records of the same time by the numbers
+    const TempDir temp_dir("scl_test_sequence");
+    const auto &dir = temp_dir.Path();
+
+    SegmentMerger::Options merger_options;
+    for (int f = 0; f < 2; ++f) {
+        const auto path = dir / ("recorder_" + std::to_string(f) + ".txt");
+        std::ofstream file(path);
+        for (int i = 0; i < 3; ++i) {
+            CoreRecord record(Level::Info, "2020-01-02-03-04-05", std::nullopt, std::nullopt, "message", 1, 2);
+            record.SetSequence(i * 2 + f);
+            std::string line;
+            record.AppendFormatted(line, f == 0 ? RecordFormat::Plain : RecordFormat::JsonLines);
+            file << line << '\n';
+        }
+
+        merger_options.files.push_back(path);
+    }
+
+    merger_options.order_by_sequence = true;
+    SegmentMergerPtr merger;
+    Unwrap(merger, SegmentMerger::Init(merger_options));
+
+    std::uint64_t expected_sequence = 0;
+    merger->Merge([&expected_sequence](const MergedRecord &record) {
+        EXPECT_EQ(record.record_sequence, expected_sequence);
+        EXPECT_EQ(record.file_index, expected_sequence % 2);
+        ++expected_sequence;
+    });
+
+    EXPECT_EQ(expected_sequence, 6u);
+}
+
+TEST(SclTest, ColumnarSegmentScan) {
+    const TempDir temp_dir("scl_test_columnar");
+    const auto &dir = temp_dir.Path();
+
+    const auto base_time = *TimeStrToSeconds("2020-01-02-03-00-00");
+    const std::array<std::string, 3> actions{"startjob", "run", "stop"};
+    const int records_count = 100;
+
+    // the level depends on the time, so the blocks differ in the statistics
+    const auto level_fn = [](int i) { return i >= 40 && i < 60 && i % 3 == 0 ? Level::Error : Level::Info; };
+    {
+        ColumnarRecorder<CoreRecord>::Options options{};
+        options.path = dir / "segment.col";
+        options.block_records_count = 10;
+
+        ColumnarRecorderPtr<CoreRecord> recorder;
+        Unwrap(recorder, ColumnarRecorder<CoreRecord>::Init(options));
+        for (int i = 0; i < records_count; ++i) {
+            const auto action = i % 4 == 3 ? std::nullopt : std::optional<std::string>(actions[i % 4]);
+            recorder->OnRecord(CoreRecord(level_fn(i), SecondsToTimeStr(base_time + i * 60), std::nullopt, action,
+                                          "message " + std::to_string(i), 1, 100 + i));
+        }
+    }
+
+    ColumnarReaderPtr reader;
+    Unwrap(reader, ColumnarReader::Init(dir / "segment.col"));
+
+    // count the errors per action within the last hour
+    ColumnarReader::ScanOptions options;
+    options.columns = ColumnarReader::Columns(CoreRecordKey::Level, CoreRecordKey::Time, CoreRecordKey::Action);
+    options.min_time = base_time + 50 * 60;
+    options.level = Level::Error;
+
+    std::map<std::string, int> errors;
+    const auto stats = reader->Scan(options, [&](const ColumnarBlock &block) {
+        const auto *level = block.Column(CoreRecordKey::Level);
+        const auto *time = block.Column(CoreRecordKey::Time);
+        const auto *action = block.Column(CoreRecordKey::Action);
+        ASSERT_TRUE(level && time && action);
+        EXPECT_FALSE(block.Column(CoreRecordKey::Message));
+
+        for (std::size_t i = 0; i < block.RecordsCount(); ++i) {
+            if (level->Integer(i) == static_cast<int>(Level::Error) && time->Integer(i) >= *options.min_time) {
+                ++errors[action->Has(i) ? std::string(action->String(i)) : "none"];
+            }
+        }
+    });
+
+    std::map<std::string, int> expected_errors;
+    for (int i = 50; i < records_count; ++i) {
+        if (level_fn(i) == Level::Error) {
+            ++expected_errors[i % 4 == 3 ? "none" : actions[i % 4]];
+        }
+    }
+
+    EXPECT_FALSE(stats.is_malformed);
+    EXPECT_EQ(stats.blocks_count, 10u);
+    // the blocks 0-4 are out of time, the blocks 6-9 have no errors
+    EXPECT_EQ(stats.skipped_blocks_count, 9u);
+    EXPECT_EQ(errors, expected_errors);
+
+    // all the columns
+    int index = 0;
+    const auto all_stats = reader->Scan({}, [&](const ColumnarBlock &block) {
+        const auto *pid = block.Column(CoreRecordKey::Pid);
+        const auto *message = block.Column(CoreRecordKey::Message);
+        ASSERT_TRUE(pid && message);
+        EXPECT_FALSE(block.Column(CoreRecordKey::SessionId));
+        EXPECT_EQ(block.MinTime(), base_time + index * 60);
+        for (std::size_t i = 0; i < block.RecordsCount(); ++i, ++index) {
+            EXPECT_EQ(pid->Integer(i), 100 + index);
+            EXPECT_EQ(message->String(i), "message " + std::to_string(index));
+        }
+    });
+
+    EXPECT_EQ(all_stats.skipped_blocks_count, 0u);
+    EXPECT_EQ(index, records_count);
+
+    // a corrupt segment is reported as malformed and isn't read out of the column data
+    std::string segment;
+    {
+        std::ifstream file(dir / "segment.col", std::ios::binary);
+        segment.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    const auto scan_corrupt = [&dir](const std::string &data) {
+        {
+            std::ofstream file(dir / "corrupt.col", std::ios::binary | std::ios::trunc);
+            file << data;
+        }
+
+        ColumnarReaderPtr corrupt_reader;
+        Unwrap(corrupt_reader, ColumnarReader::Init(dir / "corrupt.col"));
+        std::size_t size = 0;
+        const auto corrupt_stats = corrupt_reader->Scan({}, [&size](const ColumnarBlock &block) {
+            for (std::size_t key = 0; key < detail::columnar::max_columns_k; ++key) {
+                const auto *column = block.Column(key);
+                for (std::size_t i = 0; column && column->Type() != detail::ColumnType::Integer
+                                        && i < block.RecordsCount(); ++i) {
+                    size += column->Has(i) ? column->String(i).size() : 0;
+                }
+            }
+        });
+
+        return corrupt_stats.is_malformed;
+    };
+
+    // the data size of the first block exceeds the file
+    auto corrupt = segment;
+    std::memset(corrupt.data() + detail::columnar::segment_magic_k.size() + 8, 0x7f, 8);
+    EXPECT_TRUE(scan_corrupt(corrupt));
+
+    for (std::size_t pos = detail::columnar::segment_magic_k.size(); pos < segment.size(); ++pos) {
+        corrupt = segment;
+        corrupt[pos] = static_cast<char>(0xff);
+        scan_corrupt(corrupt);
+    }
+}
+
+TEST(SclTest, WebuiRecordFormat) {
+    using namespace cis1::webui_logger;
+
+    const WebuiRecord full(Level::Error, "2020-01-02-03-04-05", "msg", Protocol::HTTP_POST,
+                           std::string("handler"), std::string("127.0.0.1:80"), std::string("a@b.c"));
+    EXPECT_EQ(full.ToString(), "2020-01-02-03-04-05 | Error | HTTP POST | handler | 127.0.0.1:80 | a@b.c | msg");
+    EXPECT_EQ(full.ToAlignedString(),
+              "2020-01-02-03-04-05 |   Error | HTTP POST |                      handler |"
+              "          127.0.0.1:80 | a@b.c | msg");
+
+    const WebuiRecord short_record(Level::Debug, "2020-01-02-03-04-05", "msg",
+                                   std::nullopt, std::nullopt, std::nullopt, std::nullopt);
+    EXPECT_EQ(short_record.ToString(), "2020-01-02-03-04-05 | Debug | msg");
+    EXPECT_EQ(short_record.ToAlignedString(), "2020-01-02-03-04-05 |   Debug | msg");
+}
+
+TEST(SclTest, CoreRecordPrefixFormat) {
+    const std::string long_session_id(max_session_id_length + 1, 's');
+    const std::optional<std::string> action = "action";
+
+    for (const std::optional<std::string> &session_id : {std::optional<std::string>("session"),
+                                                         std::optional<std::string>(long_session_id),
+                                                         std::optional<std::string>()}) {
+        const CorePrefix prefix(1, 1234, session_id);
+        EXPECT_EQ(prefix.HasSessionId(), session_id && *session_id != long_session_id);
+
+        const CoreRecord expected(Level::Info, "time", session_id, action, "message", 1, 1234);
+        const CoreRecord with_session(Level::Info, "time", session_id, action, "message", prefix);
+        const CoreRecord without_session(Level::Info, "time", std::nullopt, action, "message", prefix);
+
+        EXPECT_EQ(with_session.ToString(), expected.ToString());
+        EXPECT_EQ(with_session.ToAlignedString(), expected.ToAlignedString());
+        EXPECT_EQ(without_session.ToString(), "time | 1 | 1234 | action | message");
+    }
+
+    // the changed fields don't match the prefix any more
+    CoreRecord changed(Level::Info, "time", std::string("session"), action, "message", CorePrefix(1, 1234, "session"));
+    changed.pid = 4321;
+    EXPECT_EQ(changed.ToString(), "time | 1 | 4321 | session | action | message");
+    changed.parent_pid = 2;
+    changed.session_id = "other";
+    const CoreRecord expected(Level::Info, "time", std::string("other"), action, "message", 2, 4321);
+    EXPECT_EQ(changed.ToString(), expected.ToString());
+    EXPECT_EQ(changed.ToAlignedString(), expected.ToAlignedString());
+    changed.pid = 1234;
+    changed.parent_pid = 1;
+    EXPECT_EQ(changed.ToString(), "time | 1 | 1234 | other | action | message");
+}
+
+TEST(SclTest, CoreContextKeepsLongSessionId) {
+    const std::string long_session_id(max_session_id_length + 10, 's');
+    const CoreContext context(10, 1, long_session_id);
+
+    EXPECT_EQ(context.Pid(), 10);
+    EXPECT_EQ(context.ParentPid(), 1);
+    EXPECT_EQ(context.SessionId(), long_session_id);
+    EXPECT_FALSE(context.Prefix().HasSessionId());
+
+    // the copy shares the id, the records contain the whole id
+    const CoreContext copy = context;
+    const CoreRecord record(Level::Info, "time", copy.SessionId(), std::nullopt, "message", copy.Prefix());
+    EXPECT_EQ(record.ToString(), "time | 1 | 10 | " + long_session_id + " | message");
+
+    std::vector<CoreRecord> records;
+    RecordersCont<CoreRecord> cont;
+    cont.push_back(std::make_unique<CoreRecordsRecorder>(records));
+
+    LoggerPtr logger;
+    Unwrap(logger, CoreLogger::Init(CoreLogger::Options{Level::Info, 10, 1, long_session_id}, std::move(cont)));
+    logger->SesRecord(Level::Info, "root record");
+    logger->Child(long_session_id + "-child").SesRecord(Level::Info, "child record");
+
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].session_id, long_session_id);
+    EXPECT_EQ(records[1].session_id, long_session_id + "-child");
+}
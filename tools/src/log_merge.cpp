@@ -0,0 +1,68 @@
+/**
+ * Merge of the text log files (eg the rotated files of several processes) to a single stream ordered by time.
+ * The files are read and parsed by the worker threads and the merged records are written to the stdout.
+ * The gzip-compressed files are supported if the tool is built with the zlib.
+ * The --by-sequence option orders the records of the same time by their sequence numbers (see IRecord::Sequence()).
+ *
+ * Usage: log_merge [--workers <count>] [--by-sequence] <file>...
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <scl/segment_merger.h>
+#include <scl/detail/misc.h>
+
+using SegmentMerger = scl::SegmentMerger;
+
+void PrintUsage(const char *program) {
+    std::fprintf(stderr, "usage: %s [--workers <count>] [--by-sequence] <file>...\n", program);
+}
+
+int main(int argc, char **argv) {
+    SegmentMerger::Options options;
+
+    int arg = 1;
+    if (argc > arg + 1 && std::string(argv[arg]) == "--workers") {
+        const auto workers_count = scl::ParseNumber<std::size_t>(argv[arg + 1]);
+        if (!workers_count) {
+            std::fprintf(stderr, "the workers count must be a number\n");
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        options.workers_count = *workers_count;
+        arg += 2;
+    }
+
+    if (argc > arg && std::string(argv[arg]) == "--by-sequence") {
+        options.order_by_sequence = true;
+        ++arg;
+    }
+
+    for (; arg < argc; ++arg) {
+        options.files.emplace_back(argv[arg]);
+    }
+
+    auto init_result = SegmentMerger::Init(options);
+    if (const auto *error = std::get_if<SegmentMerger::InitError>(&init_result)) {
+        PrintUsage(argv[0]);
+        std::fprintf(stderr, "couldn't init the merger: %s\n", SegmentMerger::ToStr(*error).c_str());
+        return 1;
+    }
+
+    auto merger = std::get<scl::SegmentMergerPtr>(std::move(init_result));
+
+    std::vector<char> output_buffer(1024 * 1024);
+    std::setvbuf(stdout, output_buffer.data(), _IOFBF, output_buffer.size());
+
+    const auto stats = merger->Merge([](const scl::MergedRecord &record) {
+        std::fwrite(record.line.data(), 1, record.line.size(), stdout);
+        std::fputc('\n', stdout);
+    });
+
+    std::fflush(stdout);
+    std::fprintf(stderr, "%zu records, %zu bytes from %zu files\n",
+                 stats.records_count, stats.bytes_count, options.files.size());
+    return 0;
+}
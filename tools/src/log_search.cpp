@@ -0,0 +1,258 @@
+/**
+ * Search of the records by the session id, action or handler within the log files of a directory.
+ * The files that have the Bloom filter sidecar (see FileRecorder::Options::bloom_filter_size) are checked
+ * by the filter first and are skipped if they cannot contain the values, the other files are scanned.
+ * The records whose fields are equal to all the values are printed with the file name prefix:
+ * a value is compared with the field of its key of the JSON Lines records or with the field of its index
+ * of the plain and aligned records (the truncated aligned fields don't match), the same field that the filter holds.
+ * The default indexes are the ones of the records with all the fields: the session id is the field 3
+ * and the action is the field 4 of CoreRecord, the handler is the field 3 of WebuiRecord.
+ * The indexes are counted without the sequence number field (see TextRecordView::Sequence()),
+ * the records that omit an absent field are searched with the explicit index (eg --action-field 3).
+ * The MessagePack files are skipped.
+ *
+ * Usage: log_search <log directory> [--session-id <value>] [--action <value>] [--handler <value>]
+ *                   [--session-id-field <index>] [--action-field <index>] [--handler-field <index>]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <scl/text_log_reader.h>
+#include <scl/detail/bloom_filter.h>
+#include <scl/detail/misc.h>
+#include <scl/detail/json_format.h>
+#include <scl/detail/log_index.h>
+#include <scl/detail/msgpack_format.h>
+
+namespace fs = std::filesystem;
+
+using BloomField = scl::detail::BloomField;
+
+/**
+ * Searched value of a field.
+ */
+struct Term {
+    BloomField field;
+    std::string value;
+
+    /**
+     * Index of the field of the plain and aligned records (without the sequence number field).
+     */
+    std::size_t field_index;
+
+    /**
+     * Key and value of the JSON Lines records: "key":"value".
+     */
+    std::string json_field;
+};
+
+/**
+ * @return - JSON key of the field with the colon
+ */
+std::string_view JsonKey(BloomField field) {
+    switch (field) {
+        case BloomField::SessionId:
+            return "\"session_id\":";
+        case BloomField::Action:
+            return "\"action\":";
+        default:
+            return "\"handler\":";
+    }
+}
+
+/**
+ * @return - index of the field within the plain CoreRecord or WebuiRecord with all the fields:
+ *           "time | ppid | pid | session id | action | message" or "time | level | protocol | handler | ..."
+ */
+std::size_t DefaultFieldIndex(BloomField field) {
+    switch (field) {
+        case BloomField::SessionId:
+            return 3;
+        case BloomField::Action:
+            return 4;
+        default:
+            return 3;
+    }
+}
+
+/**
+ * @return - true if the data starts with a MessagePack record or an interned string definition
+ */
+bool IsMessagePack(std::string_view data) {
+    namespace Mp = scl::detail::msgpack;
+
+    if (data.empty()) {
+        return false;
+    }
+
+    const auto type = static_cast<unsigned char>(data.front());
+    return (type & 0xf0) == Mp::fixmap_k || type == Mp::map16_k || (type >= Mp::ext8_k && type <= Mp::ext32_k);
+}
+
+/**
+ * @return - true if the field of the term is equal to its value
+ */
+bool Matches(const scl::TextRecordView &record, const Term &term) {
+    const auto line = record.Line();
+    if (!line.empty() && line.front() == '{') {
+        // the JSON value is followed by the next key or the end of the record
+        for (auto pos = line.find(term.json_field); pos != std::string_view::npos;
+             pos = line.find(term.json_field, pos + 1)) {
+            const auto end = pos + term.json_field.size();
+            if (end < line.size() && (line[end] == ',' || line[end] == '}')) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // the sequence number follows the time
+    const auto index = term.field_index + (record.Sequence() ? 1 : 0);
+    // the message is not compared
+    return index + 1 < record.FieldsCount() && record.Field(index) == term.value;
+}
+
+/**
+ * @return - true if the file is a sidecar or a lock file of the recorders
+ */
+bool IsServiceFile(const fs::path &path) {
+    const auto extension = path.extension().string();
+    return path.filename().string().front() == '.'
+           || extension == scl::detail::bloom::extension_k
+           || extension == scl::detail::log_index::extension_k;
+}
+
+/**
+ * @return - true if the filter of the file says the file cannot contain one of the values
+ */
+bool IsSkipped(const fs::path &path, const std::vector<Term> &terms) {
+    const auto filter = scl::detail::BloomFilter::Load(scl::detail::BloomFilterPath(path));
+    if (!filter) {
+        return false;
+    }
+
+    return std::any_of(terms.begin(), terms.end(), [&filter](const auto &term) {
+        return !filter->MayContain(scl::detail::BloomHash(term.field, term.value));
+    });
+}
+
+void PrintUsage(const char *program) {
+    std::fprintf(stderr, "usage: %s <log directory> [--session-id <value>] [--action <value>] [--handler <value>] "
+                         "[--session-id-field <index>] [--action-field <index>] [--handler-field <index>]\n",
+                 program);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4 || argc % 2 != 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Term> terms;
+    std::vector<std::pair<BloomField, std::size_t>> field_indexes;
+    for (int i = 2; i < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string_view suffix = "-field";
+        const bool is_index = option.size() > suffix.size()
+                              && option.compare(option.size() - suffix.size(), suffix.size(), suffix) == 0;
+        const auto name = is_index ? option.substr(0, option.size() - suffix.size()) : option;
+
+        BloomField field;
+        if (name == "--session-id") {
+            field = BloomField::SessionId;
+        } else if (name == "--action") {
+            field = BloomField::Action;
+        } else if (name == "--handler") {
+            field = BloomField::Handler;
+        } else {
+            std::fprintf(stderr, "unknown option: %s\n", option.c_str());
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        if (is_index) {
+            const auto index = scl::ParseNumber<std::size_t>(argv[i + 1]);
+            if (!index) {
+                std::fprintf(stderr, "the field index must be a number\n");
+                PrintUsage(argv[0]);
+                return 1;
+            }
+
+            field_indexes.emplace_back(field, *index);
+            continue;
+        }
+
+        Term term{field, argv[i + 1], DefaultFieldIndex(field), std::string(JsonKey(field))};
+        scl::detail::AppendJsonString(term.json_field, term.value);
+        terms.push_back(std::move(term));
+    }
+
+    if (terms.empty()) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // the index options may follow the values
+    for (auto &term : terms) {
+        for (const auto &[field, index] : field_indexes) {
+            if (term.field == field) {
+                term.field_index = index;
+            }
+        }
+    }
+
+    std::error_code ec{};
+    std::vector<fs::path> files;
+    for (const auto &entry : fs::directory_iterator(argv[1], ec)) {
+        if (entry.is_regular_file() && !IsServiceFile(entry.path())) {
+            files.push_back(entry.path());
+        }
+    }
+
+    if (ec) {
+        std::fprintf(stderr, "couldn't read the log directory: %s\n", ec.message().c_str());
+        return 1;
+    }
+
+    std::sort(files.begin(), files.end());
+
+    std::size_t skipped_count = 0;
+    std::size_t binary_count = 0;
+    for (const auto &path : files) {
+        if (IsSkipped(path, terms)) {
+            ++skipped_count;
+            continue;
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        const std::string data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        if (IsMessagePack(data)) {
+            ++binary_count;
+            continue;
+        }
+
+        const auto file_name = path.filename().string();
+        scl::TextLogReader::ScanText(data, {}, [&terms, &file_name](const scl::TextRecordView &record) {
+            const bool matches = std::all_of(terms.begin(), terms.end(), [&record](const auto &term) {
+                return Matches(record, term);
+            });
+
+            if (matches) {
+                const auto line = record.Line();
+                std::printf("%s:%.*s\n", file_name.c_str(), static_cast<int>(line.size()), line.data());
+            }
+        });
+    }
+
+    std::fprintf(stderr, "%zu files, %zu skipped by the Bloom filters, %zu MessagePack files skipped\n",
+                 files.size(), skipped_count, binary_count);
+    return 0;
+}
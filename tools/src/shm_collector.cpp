@@ -0,0 +1,105 @@
+/**
+ * Collector of the records written by ShmRecorder producers.
+ * The collector creates the shared memory ring and drains it to a FileRecorder until SIGINT or SIGTERM.
+ *
+ * Usage: shm_collector <shm name> <log directory> <file name template> [size limit] [slots count] [slot size]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <thread>
+#include <scl/file_recorder.h>
+#include <scl/raw_record.h>
+#include <scl/detail/misc.h>
+#include <scl/detail/shm_ring.h>
+
+#ifdef SCL_HAS_SHM_RING
+
+using RawRecord = scl::RawRecord;
+using Recorder = scl::FileRecorder<RawRecord, scl::sync::None>;
+
+std::atomic<bool> stopped{false};
+
+void OnSignal(int) {
+    stopped.store(true);
+}
+
+void PrintUsage(const char *program) {
+    std::fprintf(stderr, "usage: %s <shm name> <log directory> <file name template> "
+                         "[size limit] [slots count] [slot size]\n", program);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    const std::string name = argv[1];
+
+    Recorder::Options options;
+    options.log_directory = argv[2];
+    options.file_name_template = argv[3];
+    if (argc > 4) {
+        options.size_limit = scl::ParseNumber<std::size_t>(argv[4]);
+    }
+
+    const auto slots_count = argc > 5 ? scl::ParseNumber<std::uint32_t>(argv[5]) : std::optional<std::uint32_t>(4096);
+    const auto slot_size = argc > 6 ? scl::ParseNumber<std::uint32_t>(argv[6]) : std::optional<std::uint32_t>(1024);
+    if ((argc > 4 && !options.size_limit) || !slots_count || !slot_size) {
+        std::fprintf(stderr, "the size limit, slots count and slot size must be numbers\n");
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    auto init_result = Recorder::Init(options);
+    if (const auto *error = std::get_if<Recorder::InitError>(&init_result)) {
+        std::fprintf(stderr, "couldn't init the file recorder: %s\n", Recorder::ToStr(*error).c_str());
+        return 1;
+    }
+
+    auto recorder = std::get<scl::FileRecorderPtr<RawRecord, scl::sync::None>>(std::move(init_result));
+
+    auto ring = scl::detail::ShmRing::Create(name, *slots_count, *slot_size);
+    if (!ring) {
+        std::fprintf(stderr, "couldn't create the shared memory ring %s "
+                             "(the slots count must be a power of two)\n", name.c_str());
+        return 1;
+    }
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    const auto on_record = [&recorder](int level, std::string_view text) {
+        recorder->OnRecord(RawRecord(static_cast<scl::Level>(level), text));
+    };
+
+    while (!stopped.load()) {
+        if (ring->Drain(on_record) == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // the producers may be still running, so the ring is not unlinked
+    ring->Drain(on_record);
+
+    const auto stats = ring->GetStats();
+    std::fprintf(stderr, "dropped records: %llu, recovered slots: %llu, truncated records: %llu\n",
+                 static_cast<unsigned long long>(stats.dropped),
+                 static_cast<unsigned long long>(stats.recovered),
+                 static_cast<unsigned long long>(stats.truncated));
+    return 0;
+}
+
+#else
+
+int main() {
+    std::fprintf(stderr, "the shared memory ring is supported on POSIX systems only\n");
+    return 1;
+}
+
+#endif
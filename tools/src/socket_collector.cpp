@@ -0,0 +1,180 @@
+/**
+ * Collector of the records streamed by SocketRecorder producers.
+ * The collector listens to a Unix domain socket and writes the received records to a FileRecorder
+ * until SIGINT or SIGTERM. A record frame is the level digit, the escaped serialized record and the line break
+ * (see scl/detail/socket_frame.h), the frames of an unknown level are skipped.
+ *
+ * Usage: socket_collector <socket path> <stream|seqpacket> <log directory> <file name template> [size limit]
+ */
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <scl/file_recorder.h>
+#include <scl/raw_record.h>
+#include <scl/detail/misc.h>
+#include <scl/detail/socket_frame.h>
+#include <scl/detail/unix_socket.h>
+
+#ifdef SCL_HAS_UNIX_SOCKET
+
+#include <poll.h>
+
+using RawRecord = scl::RawRecord;
+using Recorder = scl::FileRecorder<RawRecord, scl::sync::None>;
+
+std::atomic<bool> stopped{false};
+
+void OnSignal(int) {
+    stopped.store(true);
+}
+
+/**
+ * Connection of a producer.
+ */
+struct Client {
+    int fd;
+
+    /**
+     * Received data that doesn't end with a whole frame.
+     */
+    std::string buffer;
+};
+
+/**
+ * Write the whole frames of the buffer and remove them, the malformed frames are skipped.
+ */
+void WriteFrames(std::string &buffer, Recorder &recorder) {
+    std::size_t begin = 0;
+    std::size_t end;
+    while ((end = buffer.find('\n', begin)) != std::string::npos) {
+        const auto frame = scl::detail::ParseSocketFrame(std::string_view(buffer.data() + begin, end - begin));
+        if (frame) {
+            recorder.OnRecord(RawRecord(frame->level, frame->text));
+        }
+
+        begin = end + 1;
+    }
+
+    buffer.erase(0, begin);
+}
+
+void PrintUsage(const char *program) {
+    std::fprintf(stderr, "usage: %s <socket path> <stream|seqpacket> <log directory> <file name template> "
+                         "[size limit]\n", program);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 5) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    const std::string path = argv[1];
+    const std::string type_str = argv[2];
+    if (!scl::detail::IsUnixSocketPathCorrect(path) || (type_str != "stream" && type_str != "seqpacket")) {
+        std::fprintf(stderr, "incorrect socket path or type\n");
+        return 1;
+    }
+
+    Recorder::Options options;
+    options.log_directory = argv[3];
+    options.file_name_template = argv[4];
+    if (argc > 5) {
+        options.size_limit = scl::ParseNumber<std::size_t>(argv[5]);
+        if (!options.size_limit) {
+            std::fprintf(stderr, "the size limit must be a number\n");
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    auto init_result = Recorder::Init(options);
+    if (const auto *error = std::get_if<Recorder::InitError>(&init_result)) {
+        std::fprintf(stderr, "couldn't init the file recorder: %s\n", Recorder::ToStr(*error).c_str());
+        return 1;
+    }
+
+    auto recorder = std::get<scl::FileRecorderPtr<RawRecord, scl::sync::None>>(std::move(init_result));
+
+    const int listener = ::socket(AF_UNIX, type_str == "stream" ? SOCK_STREAM : SOCK_SEQPACKET, 0);
+    const auto address = scl::detail::MakeUnixSocketAddress(path);
+    ::unlink(path.c_str());
+    if (listener < 0
+        || ::bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0
+        || ::listen(listener, SOMAXCONN) != 0) {
+        std::perror("couldn't listen to the socket");
+        return 1;
+    }
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::vector<Client> clients;
+    std::vector<pollfd> poll_fds;
+    std::vector<char> read_buffer(256 * 1024);
+
+    while (!stopped.load()) {
+        poll_fds.clear();
+        poll_fds.push_back({listener, POLLIN, 0});
+        for (const auto &client : clients) {
+            poll_fds.push_back({client.fd, POLLIN, 0});
+        }
+
+        if (::poll(poll_fds.data(), poll_fds.size(), 100) <= 0) {
+            continue;
+        }
+
+        // the clients accepted now are polled on the next iteration
+        const auto polled_clients = clients.size();
+        if (poll_fds[0].revents & POLLIN) {
+            const int fd = ::accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                clients.push_back({fd, {}});
+            }
+        }
+
+        for (std::size_t i = polled_clients; i-- > 0;) {
+            if (poll_fds[i + 1].revents == 0) {
+                continue;
+            }
+
+            auto &client = clients[i];
+            const auto received = ::recv(client.fd, read_buffer.data(), read_buffer.size(), 0);
+            if (received > 0) {
+                client.buffer.append(read_buffer.data(), static_cast<std::size_t>(received));
+                WriteFrames(client.buffer, *recorder);
+                continue;
+            }
+
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+
+            // the producer is disconnected, an incomplete frame is sent again by the producer after reconnection
+            ::close(client.fd);
+            clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
+
+    for (const auto &client : clients) {
+        ::close(client.fd);
+    }
+
+    ::close(listener);
+    ::unlink(path.c_str());
+    return 0;
+}
+
+#else
+
+int main() {
+    std::fprintf(stderr, "the Unix domain sockets are supported on POSIX systems only\n");
+    return 1;
+}
+
+#endif